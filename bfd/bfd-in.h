@@ -347,7 +347,8 @@ extern const char *bfd_get_stab_name (int);
 
 struct bfd_hash_entry
 {
-  /* Next entry for this hash code.  */
+  /* Next entry for this hash code.  Not used if the table uses open
+     addressing.  */
   struct bfd_hash_entry *next;
   /* String being hashed.  */
   const char *string;
@@ -356,12 +357,27 @@ struct bfd_hash_entry
   unsigned long hash;
 };
 
+/* A slot in a hash table which uses open addressing.  */
+
+struct bfd_hash_slot
+{
+  /* The entry in this slot, or NULL if the slot is empty.  */
+  struct bfd_hash_entry *entry;
+  /* The low bits of the entry's hash code and the length of its
+     string, so that most probes are rejected without reading the
+     entry.  */
+  unsigned int hash;
+  unsigned int len;
+};
+
 /* A hash table.  */
 
 struct bfd_hash_table
 {
-  /* The hash array.  */
+  /* The hash array, or NULL if the table uses open addressing.  */
   struct bfd_hash_entry **table;
+  /* The slot array if the table uses open addressing, else NULL.  */
+  struct bfd_hash_slot *slots;
   /* A function used to create new elements in the hash table.  The
      first entry is itself a pointer to an element.  When this
      function is first invoked, this pointer will be NULL.  However,
@@ -374,7 +390,8 @@ struct bfd_hash_table
    /* An objalloc for this hash table.  This is a struct objalloc *,
      but we use void * to avoid requiring the inclusion of objalloc.h.  */
   void *memory;
-  /* The number of slots in the hash table.  */
+  /* The number of slots in the hash table.  This is a power of two
+     if the table uses open addressing.  */
   unsigned int size;
   /* The number of entries in the hash table.  */
   unsigned int count;
@@ -400,6 +417,15 @@ extern bfd_boolean bfd_hash_table_init_n
 			       const char *),
    unsigned int, unsigned int);
 
+/* Initialize a hash table which uses open addressing, specifying a
+   size.  */
+extern bfd_boolean bfd_hash_table_init_open
+  (struct bfd_hash_table *,
+   struct bfd_hash_entry *(*) (struct bfd_hash_entry *,
+			       struct bfd_hash_table *,
+			       const char *),
+   unsigned int, unsigned int);
+
 /* Free up a hash table.  */
 extern void bfd_hash_table_free
   (struct bfd_hash_table *);
@@ -446,6 +472,10 @@ extern void bfd_hash_traverse
    this size.  */
 extern unsigned long bfd_hash_set_default_size (unsigned long);
 
+/* Select whether new hash tables allocated using bfd_hash_table_init
+   use open addressing rather than chained buckets.  */
+extern void bfd_hash_set_default_open_addressing (bfd_boolean);
+
 /* Types of compressed DWARF debug sections.  We currently support
    zlib.  */
 enum compressed_debug_section_type
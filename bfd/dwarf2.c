@@ -35,6 +35,10 @@
 #include "libbfd.h"
 #include "elf-bfd.h"
 #include "dwarf2.h"
+#include "hashtab.h"
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
 
 /* The data in the .debug_line statement prologue looks like this.  */
 
@@ -198,6 +202,36 @@ struct dwarf2_debug
 #define STASH_INFO_HASH_ON         1
 #define STASH_INFO_HASH_DISABLED   2
 
+  /* Number of times find_nearest_line is called.  This is used in
+     the heuristic for building the unit index.  */
+  int unit_index_count;
+
+#define STASH_UNIT_INDEX_TRIGGER   100
+
+  /* The address ranges of all the comp. units, sorted by low address.
+     This is the unit index, used to find the comp. units that may
+     contain an address without looking at all of them.  */
+  struct unit_range *unit_ranges;
+
+  /* Number of entries in UNIT_RANGES.  */
+  bfd_size_type unit_range_count;
+
+  /* Comp. units without any address range, which must be looked at
+     for every address.  */
+  struct comp_unit **unranged_units;
+
+  /* Number of entries in UNRANGED_UNITS.  */
+  bfd_size_type unranged_unit_count;
+
+  /* Buffer for the comp. units found by a lookup in the unit index.  */
+  struct comp_unit **unit_candidates;
+
+  /* Status of the unit index.  */
+  int unit_index_status;
+#define STASH_UNIT_INDEX_OFF       0
+#define STASH_UNIT_INDEX_ON        1
+#define STASH_UNIT_INDEX_DISABLED  2
+
   /* True if we opened bfd_ptr.  */
   bfd_boolean close_on_cleanup;
 };
@@ -209,6 +243,20 @@ struct arange
   bfd_vma high;
 };
 
+/* An entry in the unit index: one address range of a comp. unit.  */
+
+struct unit_range
+{
+  bfd_vma low;
+  bfd_vma high;
+
+  /* The highest HIGH of this entry and of all the entries before it
+     in the unit index.  */
+  bfd_vma max_high;
+
+  struct comp_unit *unit;
+};
+
 /* A minimal decoding of DWARF2 compilation units.  We only decode
    what's needed to get to the line number information.  */
 
@@ -4252,6 +4300,281 @@ section_vma_same (const bfd *abfd, const struct dwarf2_debug *stash)
   return TRUE;
 }
 
+/* Read the comp. unit at STASH->info_ptr, add it to the list of comp.
+   units and advance STASH->info_ptr past it.  ADDR_SIZE and
+   DEBUG_SECTIONS are as for _bfd_dwarf2_find_nearest_line.  Set
+   *UNIT_PTR to the new comp. unit, or to NULL if the unit is empty.
+   Return FALSE if the debug information is damaged.  */
+
+static bfd_boolean
+stash_read_comp_unit (struct dwarf2_debug *stash,
+		      unsigned int addr_size,
+		      const struct dwarf_debug_section *debug_sections,
+		      struct comp_unit **unit_ptr)
+{
+  bfd_vma length;
+  unsigned int offset_size = addr_size;
+  bfd_byte *info_ptr_unit = stash->info_ptr;
+  bfd_byte *new_ptr;
+  struct comp_unit *each;
+
+  *unit_ptr = NULL;
+
+  length = read_4_bytes (stash->bfd_ptr, stash->info_ptr, stash->info_ptr_end);
+  /* A 0xffffff length is the DWARF3 way of indicating
+     we use 64-bit offsets, instead of 32-bit offsets.  */
+  if (length == 0xffffffff)
+    {
+      offset_size = 8;
+      length = read_8_bytes (stash->bfd_ptr, stash->info_ptr + 4, stash->info_ptr_end);
+      stash->info_ptr += 12;
+    }
+  /* A zero length is the IRIX way of indicating 64-bit offsets,
+     mostly because the 64-bit length will generally fit in 32
+     bits, and the endianness helps.  */
+  else if (length == 0)
+    {
+      offset_size = 8;
+      length = read_4_bytes (stash->bfd_ptr, stash->info_ptr + 4, stash->info_ptr_end);
+      stash->info_ptr += 8;
+    }
+  /* In the absence of the hints above, we assume 32-bit DWARF2
+     offsets even for targets with 64-bit addresses, because:
+       a) most of the time these targets will not have generated
+	  more than 2Gb of debug info and so will not need 64-bit
+	  offsets,
+     and
+       b) if they do use 64-bit offsets but they are not using
+	  the size hints that are tested for above then they are
+	  not conforming to the DWARF3 standard anyway.  */
+  else if (addr_size == 8)
+    {
+      offset_size = 4;
+      stash->info_ptr += 4;
+    }
+  else
+    stash->info_ptr += 4;
+
+  if (length == 0)
+    return TRUE;
+
+  /* PR 21151  */
+  if (stash->info_ptr + length > stash->info_ptr_end)
+    return FALSE;
+
+  each = parse_comp_unit (stash, length, info_ptr_unit, offset_size);
+  if (!each)
+    return FALSE;
+
+  new_ptr = stash->info_ptr + length;
+  /* PR 17512: file: 1500698c.  */
+  if (new_ptr < stash->info_ptr)
+    /* A corrupt length value - do not trust the info any more.  */
+    return FALSE;
+  stash->info_ptr = new_ptr;
+
+  if (stash->all_comp_units)
+    stash->all_comp_units->prev_unit = each;
+  else
+    stash->last_comp_unit = each;
+
+  each->next_unit = stash->all_comp_units;
+  stash->all_comp_units = each;
+
+  if ((bfd_vma) (stash->info_ptr - stash->sec_info_ptr) == stash->sec->size)
+    {
+      stash->sec = find_debug_info (stash->bfd_ptr, debug_sections,
+				    stash->sec);
+      stash->sec_info_ptr = stash->info_ptr;
+    }
+
+  *unit_ptr = each;
+  return TRUE;
+}
+
+/* Compare function for the entries of the unit index.  */
+
+static int
+compare_unit_ranges (const void *a, const void *b)
+{
+  const struct unit_range *range1 = (const struct unit_range *) a;
+  const struct unit_range *range2 = (const struct unit_range *) b;
+
+  if (range1->low < range2->low)
+    return -1;
+  if (range1->low > range2->low)
+    return 1;
+  if (range1->high < range2->high)
+    return -1;
+  if (range1->high > range2->high)
+    return 1;
+  return 0;
+}
+
+/* Compare function for the comp. units found in the unit index.  The
+   units are sorted in the order of the list of comp. units, which is
+   the reverse of the order in which they were read.  */
+
+static int
+compare_unit_candidates (const void *a, const void *b)
+{
+  const struct comp_unit *unit1 = *(const struct comp_unit **) a;
+  const struct comp_unit *unit2 = *(const struct comp_unit **) b;
+
+  if (unit1->info_ptr_unit > unit2->info_ptr_unit)
+    return -1;
+  if (unit1->info_ptr_unit < unit2->info_ptr_unit)
+    return 1;
+  return 0;
+}
+
+/* Check to see if we want to build the unit index.  Like the info
+   hash tables, it is only worth it once bfd_find_nearest_line has
+   been called many times.  Building it reads all the remaining comp.
+   units and decodes all their line tables up front, since decoding a
+   line table can add address ranges to its comp. unit.  */
+
+static void
+stash_maybe_build_unit_index (struct dwarf2_debug *stash,
+			      unsigned int addr_size,
+			      const struct dwarf_debug_section *debug_sections)
+{
+  struct comp_unit *each;
+  bfd_size_type range_count = 0;
+  bfd_size_type unranged_count = 0;
+  bfd_size_type i;
+  bfd_vma max_high;
+
+  BFD_ASSERT (stash->unit_index_status == STASH_UNIT_INDEX_OFF);
+
+  if (stash->unit_index_count++ < STASH_UNIT_INDEX_TRIGGER)
+    return;
+
+  while (stash->info_ptr < stash->info_ptr_end)
+    if (!stash_read_comp_unit (stash, addr_size, debug_sections, &each))
+      {
+	stash->unit_index_status = STASH_UNIT_INDEX_DISABLED;
+	return;
+      }
+
+  for (each = stash->all_comp_units; each; each = each->next_unit)
+    {
+      struct arange *arange;
+
+      if (!comp_unit_maybe_decode_line_info (each, stash))
+	continue;
+
+      if (each->arange.high == 0)
+	unranged_count++;
+      else
+	for (arange = &each->arange; arange; arange = arange->next)
+	  range_count++;
+    }
+
+  stash->unit_ranges = (struct unit_range *)
+    bfd_malloc (range_count * sizeof (struct unit_range));
+  stash->unranged_units = (struct comp_unit **)
+    bfd_malloc (unranged_count * sizeof (struct comp_unit *));
+  /* A lookup can find a unit once for each of its ranges before the
+     duplicates are removed, so the candidates buffer needs room for
+     every range and every unranged unit.  */
+  stash->unit_candidates = (struct comp_unit **)
+    bfd_malloc ((range_count + unranged_count) * sizeof (struct comp_unit *));
+  if ((stash->unit_ranges == NULL && range_count != 0)
+      || (stash->unranged_units == NULL && unranged_count != 0)
+      || (stash->unit_candidates == NULL
+	  && range_count + unranged_count != 0))
+    {
+      stash->unit_index_status = STASH_UNIT_INDEX_DISABLED;
+      return;
+    }
+
+  for (each = stash->all_comp_units; each; each = each->next_unit)
+    {
+      struct arange *arange;
+
+      if (each->error)
+	continue;
+
+      if (each->arange.high == 0)
+	stash->unranged_units[stash->unranged_unit_count++] = each;
+      else
+	for (arange = &each->arange; arange; arange = arange->next)
+	  {
+	    struct unit_range *range
+	      = &stash->unit_ranges[stash->unit_range_count++];
+
+	    range->low = arange->low;
+	    range->high = arange->high;
+	    range->unit = each;
+	  }
+    }
+
+  qsort (stash->unit_ranges, stash->unit_range_count,
+	 sizeof (struct unit_range), compare_unit_ranges);
+
+  max_high = 0;
+  for (i = 0; i < stash->unit_range_count; i++)
+    {
+      if (stash->unit_ranges[i].high > max_high)
+	max_high = stash->unit_ranges[i].high;
+      stash->unit_ranges[i].max_high = max_high;
+    }
+
+  stash->unit_index_status = STASH_UNIT_INDEX_ON;
+}
+
+/* Find the comp. units that may contain ADDR using the unit index of
+   STASH.  Store them in STASH->unit_candidates, in the order of the
+   list of comp. units, and return how many there are.  */
+
+static bfd_size_type
+stash_find_units_in_index (struct dwarf2_debug *stash, bfd_vma addr)
+{
+  bfd_size_type lo = 0;
+  bfd_size_type hi = stash->unit_range_count;
+  bfd_size_type count = 0;
+  bfd_size_type i;
+
+  BFD_ASSERT (stash->unit_index_status == STASH_UNIT_INDEX_ON);
+
+  /* Find the first range starting above ADDR.  */
+  while (lo < hi)
+    {
+      bfd_size_type mid = (lo + hi) / 2;
+
+      if (stash->unit_ranges[mid].low <= addr)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+
+  /* Walk back over the ranges starting at or below ADDR, until none
+     of the remaining ones can reach it.  */
+  for (i = lo; i > 0 && stash->unit_ranges[i - 1].max_high > addr; i--)
+    if (stash->unit_ranges[i - 1].high > addr)
+      stash->unit_candidates[count++] = stash->unit_ranges[i - 1].unit;
+
+  for (i = 0; i < stash->unranged_unit_count; i++)
+    stash->unit_candidates[count++] = stash->unranged_units[i];
+
+  if (count > 1)
+    {
+      bfd_size_type j;
+
+      qsort (stash->unit_candidates, count, sizeof (struct comp_unit *),
+	     compare_unit_candidates);
+
+      /* A unit may have several ranges containing ADDR.  */
+      for (i = 1, j = 1; i < count; i++)
+	if (stash->unit_candidates[i] != stash->unit_candidates[j - 1])
+	  stash->unit_candidates[j++] = stash->unit_candidates[i];
+      count = j;
+    }
+
+  return count;
+}
+
 /* Read debug information from DEBUG_BFD when DEBUG_BFD is specified.
    If DEBUG_BFD is not specified, we read debug information from ABFD
    or its gnu_debuglink. The results will be stored in PINFO.
@@ -4569,6 +4892,13 @@ _bfd_dwarf2_find_nearest_line (bfd *abfd,
 
   stash->inliner_chain = NULL;
 
+  /* The DWARF2 spec says that the initial length field, and the
+     offset of the abbreviation table, should both be 4-byte values.
+     However, some compilers do things differently.  */
+  if (addr_size == 0)
+    addr_size = 4;
+  BFD_ASSERT (addr_size == 4 || addr_size == 8);
+
   /* Check the previously read comp. units first.  */
   if (do_line)
     {
@@ -4612,8 +4942,27 @@ _bfd_dwarf2_find_nearest_line (bfd *abfd,
       struct funcinfo *local_function = NULL;
       unsigned int local_linenumber = 0;
       unsigned int local_discriminator = 0;
+      bfd_size_type candidate_count = 0;
+      bfd_size_type i = 0;
 
-      for (each = stash->all_comp_units; each; each = each->next_unit)
+      /* Once many addresses have been looked up, build an index of
+	 the address ranges of the comp. units, and only look at the
+	 units that it finds may contain ADDR.  */
+      if (stash->unit_index_status == STASH_UNIT_INDEX_OFF)
+	stash_maybe_build_unit_index (stash, addr_size, debug_sections);
+
+      if (stash->unit_index_status == STASH_UNIT_INDEX_ON)
+	{
+	  candidate_count = stash_find_units_in_index (stash, addr);
+	  each = candidate_count > 0 ? stash->unit_candidates[0] : NULL;
+	}
+      else
+	each = stash->all_comp_units;
+
+      for (; each;
+	   each = (stash->unit_index_status == STASH_UNIT_INDEX_ON
+		   ? (++i < candidate_count ? stash->unit_candidates[i] : NULL)
+		   : each->next_unit))
 	{
 	  bfd_vma range = (bfd_vma) -1;
 
@@ -4660,89 +5009,19 @@ _bfd_dwarf2_find_nearest_line (bfd *abfd,
 	}
     }
 
-  /* The DWARF2 spec says that the initial length field, and the
-     offset of the abbreviation table, should both be 4-byte values.
-     However, some compilers do things differently.  */
-  if (addr_size == 0)
-    addr_size = 4;
-  BFD_ASSERT (addr_size == 4 || addr_size == 8);
-
   /* Read each remaining comp. units checking each as they are read.  */
   while (stash->info_ptr < stash->info_ptr_end)
     {
-      bfd_vma length;
-      unsigned int offset_size = addr_size;
-      bfd_byte *info_ptr_unit = stash->info_ptr;
-
-      length = read_4_bytes (stash->bfd_ptr, stash->info_ptr, stash->info_ptr_end);
-      /* A 0xffffff length is the DWARF3 way of indicating
-	 we use 64-bit offsets, instead of 32-bit offsets.  */
-      if (length == 0xffffffff)
-	{
-	  offset_size = 8;
-	  length = read_8_bytes (stash->bfd_ptr, stash->info_ptr + 4, stash->info_ptr_end);
-	  stash->info_ptr += 12;
-	}
-      /* A zero length is the IRIX way of indicating 64-bit offsets,
-	 mostly because the 64-bit length will generally fit in 32
-	 bits, and the endianness helps.  */
-      else if (length == 0)
+      if (!stash_read_comp_unit (stash, addr_size, debug_sections, &each))
 	{
-	  offset_size = 8;
-	  length = read_4_bytes (stash->bfd_ptr, stash->info_ptr + 4, stash->info_ptr_end);
-	  stash->info_ptr += 8;
-	}
-      /* In the absence of the hints above, we assume 32-bit DWARF2
-	 offsets even for targets with 64-bit addresses, because:
-	   a) most of the time these targets will not have generated
-	      more than 2Gb of debug info and so will not need 64-bit
-	      offsets,
-	 and
-	   b) if they do use 64-bit offsets but they are not using
-	      the size hints that are tested for above then they are
-	      not conforming to the DWARF3 standard anyway.  */
-      else if (addr_size == 8)
-	{
-	  offset_size = 4;
-	  stash->info_ptr += 4;
+	  /* The dwarf information is damaged, don't trust it any
+	     more.  */
+	  found = FALSE;
+	  break;
 	}
-      else
-	stash->info_ptr += 4;
 
-      if (length > 0)
+      if (each != NULL)
 	{
-	  bfd_byte * new_ptr;
-
-	  /* PR 21151  */
-	  if (stash->info_ptr + length > stash->info_ptr_end)
-	    return FALSE;
-
-	  each = parse_comp_unit (stash, length, info_ptr_unit,
-				  offset_size);
-	  if (!each)
-	    /* The dwarf information is damaged, don't trust it any
-	       more.  */
-	    break;
-
-	  new_ptr = stash->info_ptr + length;
-	  /* PR 17512: file: 1500698c.  */
-	  if (new_ptr < stash->info_ptr)
-	    {
-	      /* A corrupt length value - do not trust the info any more.  */
-	      found = FALSE;
-	      break;
-	    }
-	  else
-	    stash->info_ptr = new_ptr;
-
-	  if (stash->all_comp_units)
-	    stash->all_comp_units->prev_unit = each;
-	  else
-	    stash->last_comp_unit = each;
-
-	  each->next_unit = stash->all_comp_units;
-	  stash->all_comp_units = each;
-
 	  /* DW_AT_low_pc and DW_AT_high_pc are optional for
 	     compilation units.  If we don't have them (i.e.,
 	     unit->high == 0), we need to consult the line info table
@@ -4766,14 +5045,6 @@ _bfd_dwarf2_find_nearest_line (bfd *abfd,
 						     discriminator_ptr,
 						     stash) != 0);
 
-	  if ((bfd_vma) (stash->info_ptr - stash->sec_info_ptr)
-	      == stash->sec->size)
-	    {
-	      stash->sec = find_debug_info (stash->bfd_ptr, debug_sections,
-					    stash->sec);
-	      stash->sec_info_ptr = stash->info_ptr;
-	    }
-
 	  if (found)
 	    goto done;
 	}
@@ -4924,10 +5195,865 @@ _bfd_dwarf2_cleanup_debug_info (bfd *abfd, void **pinfo)
     free (stash->sec_vma);
   if (stash->adjusted_sections)
     free (stash->adjusted_sections);
+  if (stash->unit_ranges)
+    free (stash->unit_ranges);
+  if (stash->unranged_units)
+    free (stash->unranged_units);
+  if (stash->unit_candidates)
+    free (stash->unit_candidates);
   if (stash->alt_bfd_ptr)
     bfd_close (stash->alt_bfd_ptr);
 }
 
+/* Address to line index files.
+
+   An index file records, for each range of addresses of an executable
+   or shared library that has DWARF line information, the file name,
+   line number and function name that bfd_find_nearest_line returns for
+   the range, followed by the chain of locations that
+   bfd_find_inliner_info then returns.  It is named after the build-id
+   of the file it describes, and is laid out so that it can be mapped
+   into memory and searched without any parsing.  All the numbers in an
+   index file are little-endian, so that the file does not depend on
+   the byte order of the host that wrote it.  */
+
+#define LINE_INDEX_MAGIC	"BFDLIDX"
+#define LINE_INDEX_VERSION	2
+#define LINE_INDEX_NONE		((unsigned int) -1)
+
+/* The header of an index file.  It is followed by the build-id, padded
+   to a multiple of 8 bytes, the ranges, the frames and the strings.  */
+
+struct line_index_external_header
+{
+  char magic[8];
+  unsigned char version[4];
+  unsigned char build_id_size[4];
+  unsigned char range_count[4];
+  unsigned char frame_count[4];
+  unsigned char string_size[4];
+  unsigned char pad[4];
+};
+
+/* A range of an index file, see struct line_index_range.  */
+
+struct line_index_external_range
+{
+  unsigned char low[8];
+  unsigned char high[8];
+  unsigned char frame[4];
+};
+
+/* A frame of an index file, see struct line_index_frame.  */
+
+struct line_index_external_frame
+{
+  unsigned char filename[4];
+  unsigned char functionname[4];
+  unsigned char line[4];
+  unsigned char discriminator[4];
+  unsigned char next[4];
+};
+
+/* A range of addresses which all have the same location.  The ranges
+   are sorted by address and do not overlap.  */
+
+struct line_index_range
+{
+  bfd_uint64_t low;
+  bfd_uint64_t high;
+
+  /* The first frame of the location.  */
+  unsigned int frame;
+};
+
+/* One frame of a location.  The strings are offsets into the string
+   table, or LINE_INDEX_NONE for a NULL string.  */
+
+struct line_index_frame
+{
+  unsigned int filename;
+  unsigned int functionname;
+  unsigned int line;
+  unsigned int discriminator;
+
+  /* The frame of the function this one is inlined into, or
+     LINE_INDEX_NONE.  */
+  unsigned int next;
+};
+
+struct bfd_line_index
+{
+  /* The contents of the index file.  */
+  bfd_byte *contents;
+  bfd_size_type size;
+
+  /* TRUE if CONTENTS is mapped from the index file, FALSE if it was
+     allocated with bfd_malloc.  */
+  bfd_boolean mapped;
+
+  const struct line_index_external_range *ranges;
+  unsigned int range_count;
+  const struct line_index_external_frame *frames;
+  unsigned int frame_count;
+  const char *strings;
+  unsigned int string_size;
+
+  /* The next frame for _bfd_elf_line_index_find_inliner_info.  */
+  unsigned int next_frame;
+};
+
+/* A string of an index file being built.  */
+
+struct line_index_string
+{
+  char *string;
+  unsigned int offset;
+};
+
+/* The state of an index file being built.  */
+
+struct line_index_builder
+{
+  /* The addresses at which the location may change.  */
+  bfd_vma *bounds;
+  bfd_size_type bound_count;
+  bfd_size_type bound_alloc;
+
+  struct line_index_range *ranges;
+  bfd_size_type range_count;
+  bfd_size_type range_alloc;
+
+  struct line_index_frame *frames;
+  bfd_size_type frame_count;
+  bfd_size_type frame_alloc;
+
+  char *strings;
+  bfd_size_type string_size;
+  bfd_size_type string_alloc;
+
+  /* The strings already in STRINGS.  */
+  htab_t string_htab;
+};
+
+/* Make room for COUNT more elements of SIZE bytes in the array *VEC
+   which holds *USED elements out of *ALLOC.  */
+
+static bfd_boolean
+line_index_reserve (void **vec, bfd_size_type *alloc, bfd_size_type used,
+		    bfd_size_type count, bfd_size_type size)
+{
+  bfd_size_type new_alloc;
+  void *new_vec;
+
+  if (used + count <= *alloc)
+    return TRUE;
+
+  new_alloc = *alloc != 0 ? *alloc * 2 : 256;
+  while (new_alloc < used + count)
+    new_alloc *= 2;
+  new_vec = bfd_realloc (*vec, new_alloc * size);
+  if (new_vec == NULL)
+    return FALSE;
+  *vec = new_vec;
+  *alloc = new_alloc;
+  return TRUE;
+}
+
+static bfd_boolean
+line_index_add_bound (struct line_index_builder *builder, bfd_vma addr)
+{
+  if (!line_index_reserve ((void **) &builder->bounds, &builder->bound_alloc,
+			   builder->bound_count, 1, sizeof (bfd_vma)))
+    return FALSE;
+  builder->bounds[builder->bound_count++] = addr;
+  return TRUE;
+}
+
+static hashval_t
+line_index_string_hash (const void *p)
+{
+  const struct line_index_string *s = (const struct line_index_string *) p;
+
+  return htab_hash_string (s->string);
+}
+
+static int
+line_index_string_eq (const void *p1, const void *p2)
+{
+  const struct line_index_string *s1 = (const struct line_index_string *) p1;
+  const struct line_index_string *s2 = (const struct line_index_string *) p2;
+
+  return strcmp (s1->string, s2->string) == 0;
+}
+
+static void
+line_index_string_del (void *p)
+{
+  struct line_index_string *s = (struct line_index_string *) p;
+
+  free (s->string);
+  free (s);
+}
+
+/* Add STRING to the string table of BUILDER if it is not already
+   there, and set *OFFSET to its offset.  */
+
+static bfd_boolean
+line_index_add_string (struct line_index_builder *builder,
+		       const char *string, unsigned int *offset)
+{
+  struct line_index_string key, *entry;
+  bfd_size_type len;
+  void **slot;
+
+  if (string == NULL)
+    {
+      *offset = LINE_INDEX_NONE;
+      return TRUE;
+    }
+
+  key.string = (char *) string;
+  slot = htab_find_slot (builder->string_htab, &key, INSERT);
+  if (slot == NULL)
+    return FALSE;
+  if (*slot != NULL)
+    {
+      *offset = ((struct line_index_string *) *slot)->offset;
+      return TRUE;
+    }
+
+  len = strlen (string) + 1;
+  entry = (struct line_index_string *) bfd_malloc (sizeof (*entry));
+  if (entry == NULL)
+    return FALSE;
+  entry->string = (char *) bfd_malloc (len);
+  if (entry->string == NULL
+      || !line_index_reserve ((void **) &builder->strings,
+			      &builder->string_alloc, builder->string_size,
+			      len, 1))
+    {
+      free (entry->string);
+      free (entry);
+      htab_clear_slot (builder->string_htab, slot);
+      return FALSE;
+    }
+  memcpy (entry->string, string, len);
+  entry->offset = builder->string_size;
+  memcpy (builder->strings + builder->string_size, string, len);
+  builder->string_size += len;
+  *slot = entry;
+  *offset = entry->offset;
+  return TRUE;
+}
+
+/* Collect in BUILDER every address at which the location returned by
+   bfd_find_nearest_line for ABFD may change: the bounds of the
+   sections, of the symbols, of the comp. units and functions, and of
+   the rows of the line tables.  */
+
+static bfd_boolean
+line_index_collect_bounds (bfd *abfd, asymbol **symbols,
+			   struct line_index_builder *builder)
+{
+  void *pinfo = NULL;
+  struct dwarf2_debug *stash;
+  struct comp_unit *each;
+  asection *sec;
+  unsigned int addr_size = bfd_get_arch_size (abfd) == 64 ? 8 : 4;
+  bfd_boolean ok = TRUE;
+
+  for (sec = abfd->sections; sec != NULL; sec = sec->next)
+    if ((sec->flags & SEC_ALLOC) != 0)
+      {
+	if (!line_index_add_bound (builder, sec->vma)
+	    || !line_index_add_bound (builder,
+				      sec->vma + bfd_get_section_size (sec)))
+	  return FALSE;
+      }
+
+  /* _bfd_elf_find_function chooses a function by its entry point and
+     size as given by the backend, which on some targets are not the
+     symbol's value.  */
+  if (symbols != NULL)
+    {
+      const struct elf_backend_data *bed = get_elf_backend_data (abfd);
+      asymbol **p;
+
+      for (p = symbols; *p != NULL; p++)
+	{
+	  asection *sym_sec = (*p)->section;
+	  bfd_vma code_off;
+	  bfd_size_type size;
+
+	  if (sym_sec == NULL || bfd_is_abs_section (sym_sec)
+	      || bfd_is_und_section (sym_sec))
+	    continue;
+	  size = bed->maybe_function_sym (*p, sym_sec, &code_off);
+	  if (size != 0
+	      && (!line_index_add_bound (builder, sym_sec->vma + code_off)
+		  || !line_index_add_bound (builder,
+					    sym_sec->vma + code_off + size)))
+	    return FALSE;
+	}
+    }
+
+  if (!_bfd_dwarf2_slurp_debug_info (abfd, NULL, dwarf_debug_sections,
+				     symbols, &pinfo, FALSE))
+    {
+      _bfd_dwarf2_cleanup_debug_info (abfd, &pinfo);
+      return FALSE;
+    }
+  stash = (struct dwarf2_debug *) pinfo;
+
+  /* If the debug information is damaged, index the comp. units read
+     before the damage.  */
+  while (stash->info_ptr < stash->info_ptr_end)
+    if (!stash_read_comp_unit (stash, addr_size, dwarf_debug_sections,
+			       &each))
+      break;
+
+  for (each = stash->all_comp_units; each != NULL && ok;
+       each = each->next_unit)
+    {
+      struct arange *arange;
+      struct funcinfo *func;
+      unsigned int i;
+
+      if (!comp_unit_maybe_decode_line_info (each, stash))
+	continue;
+
+      for (arange = &each->arange; arange != NULL; arange = arange->next)
+	ok = (ok
+	      && line_index_add_bound (builder, arange->low)
+	      && line_index_add_bound (builder, arange->high));
+
+      for (i = 0; i < each->line_table->num_sequences; i++)
+	{
+	  struct line_info *line;
+
+	  for (line = each->line_table->sequences[i].last_line;
+	       line != NULL;
+	       line = line->prev_line)
+	    ok = ok && line_index_add_bound (builder, line->address);
+	}
+
+      for (func = each->function_table; func != NULL; func = func->prev_func)
+	for (arange = &func->arange; arange != NULL; arange = arange->next)
+	  ok = (ok
+		&& line_index_add_bound (builder, arange->low)
+		&& line_index_add_bound (builder, arange->high));
+    }
+
+  _bfd_dwarf2_cleanup_debug_info (abfd, &pinfo);
+  return ok;
+}
+
+static int
+compare_line_index_bounds (const void *a, const void *b)
+{
+  bfd_vma addr1 = *(const bfd_vma *) a;
+  bfd_vma addr2 = *(const bfd_vma *) b;
+
+  if (addr1 < addr2)
+    return -1;
+  if (addr1 > addr2)
+    return 1;
+  return 0;
+}
+
+/* Return TRUE if the COUNT frames in NEW_FRAMES, linked in order, are
+   the same as the frames of BUILDER starting at FRAME.  */
+
+static bfd_boolean
+line_index_same_frames (struct line_index_builder *builder,
+			unsigned int frame,
+			const struct line_index_frame *new_frames,
+			unsigned int count)
+{
+  unsigned int i;
+
+  for (i = 0; i < count; i++)
+    {
+      const struct line_index_frame *old_frame;
+
+      if (frame == LINE_INDEX_NONE)
+	return FALSE;
+      old_frame = &builder->frames[frame];
+      if (old_frame->filename != new_frames[i].filename
+	  || old_frame->functionname != new_frames[i].functionname
+	  || old_frame->line != new_frames[i].line
+	  || old_frame->discriminator != new_frames[i].discriminator)
+	return FALSE;
+      frame = old_frame->next;
+    }
+
+  return frame == LINE_INDEX_NONE;
+}
+
+/* Record in BUILDER the location of ABFD at ADDR, which is the same up
+   to END.  */
+
+static bfd_boolean
+line_index_add_range (bfd *abfd, asymbol **symbols,
+		      struct line_index_builder *builder,
+		      bfd_vma addr, bfd_vma end)
+{
+  asection *sec;
+  const char *filename;
+  const char *functionname;
+  unsigned int line;
+  unsigned int discriminator;
+  struct line_index_frame chain[64];
+  unsigned int count;
+  unsigned int i;
+
+  /* Use the same section as addr2line would.  */
+  for (sec = abfd->sections; sec != NULL; sec = sec->next)
+    if ((sec->flags & SEC_ALLOC) != 0
+	&& addr >= sec->vma
+	&& addr < sec->vma + bfd_get_section_size (sec))
+      break;
+  if (sec == NULL)
+    return TRUE;
+
+  /* Only the locations with line information come from the DWARF
+     information; the others are left to bfd_find_nearest_line.  */
+  if (!bfd_find_nearest_line_discriminator (abfd, sec, symbols,
+					    addr - sec->vma, &filename,
+					    &functionname, &line,
+					    &discriminator)
+      || line == 0)
+    return TRUE;
+
+  count = 0;
+  do
+    {
+      if (count == ARRAY_SIZE (chain))
+	return TRUE;
+      if (!line_index_add_string (builder, filename, &chain[count].filename)
+	  || !line_index_add_string (builder, functionname,
+				     &chain[count].functionname))
+	return FALSE;
+      chain[count].line = line;
+      chain[count].discriminator = discriminator;
+      count++;
+      discriminator = 0;
+    }
+  while (bfd_find_inliner_info (abfd, &filename, &functionname, &line));
+
+  if (builder->range_count > 0)
+    {
+      struct line_index_range *prev = &builder->ranges[builder->range_count - 1];
+
+      if (prev->high == addr
+	  && line_index_same_frames (builder, prev->frame, chain, count))
+	{
+	  prev->high = end;
+	  return TRUE;
+	}
+    }
+
+  if (!line_index_reserve ((void **) &builder->ranges, &builder->range_alloc,
+			   builder->range_count, 1,
+			   sizeof (struct line_index_range))
+      || !line_index_reserve ((void **) &builder->frames,
+			      &builder->frame_alloc, builder->frame_count,
+			      count, sizeof (struct line_index_frame)))
+    return FALSE;
+
+  for (i = 0; i < count; i++)
+    {
+      chain[i].next = (i + 1 < count
+		       ? builder->frame_count + i + 1 : LINE_INDEX_NONE);
+      builder->frames[builder->frame_count + i] = chain[i];
+    }
+
+  builder->ranges[builder->range_count].low = addr;
+  builder->ranges[builder->range_count].high = end;
+  builder->ranges[builder->range_count].frame = builder->frame_count;
+  builder->range_count++;
+  builder->frame_count += count;
+  return TRUE;
+}
+
+/* Return the size of the build-id of ABFD in an index file.  */
+
+static bfd_size_type
+line_index_build_id_size (bfd *abfd)
+{
+  return (abfd->build_id->size + 7) & ~(bfd_size_type) 7;
+}
+
+/* Set up INDEX to use the index file contents in INDEX->contents.
+   ABFD is the file that it describes.  Return FALSE if the contents
+   are not a valid index file for ABFD.  */
+
+static bfd_boolean
+line_index_init (bfd *abfd, struct bfd_line_index *index)
+{
+  const struct line_index_external_header *header;
+  bfd_size_type offset;
+
+  if (index->size < sizeof (*header))
+    return FALSE;
+
+  header = (const struct line_index_external_header *) index->contents;
+  if (memcmp (header->magic, LINE_INDEX_MAGIC, sizeof (header->magic)) != 0
+      || bfd_getl32 (header->version) != LINE_INDEX_VERSION
+      || bfd_getl32 (header->build_id_size) != abfd->build_id->size
+      || index->size < sizeof (*header) + line_index_build_id_size (abfd)
+      || memcmp (index->contents + sizeof (*header), abfd->build_id->data,
+		 abfd->build_id->size) != 0)
+    return FALSE;
+
+  index->range_count = bfd_getl32 (header->range_count);
+  index->frame_count = bfd_getl32 (header->frame_count);
+  index->string_size = bfd_getl32 (header->string_size);
+  offset = sizeof (*header) + line_index_build_id_size (abfd);
+  if (index->size != (offset
+		      + (bfd_size_type) index->range_count
+		      * sizeof (struct line_index_external_range)
+		      + (bfd_size_type) index->frame_count
+		      * sizeof (struct line_index_external_frame)
+		      + index->string_size))
+    return FALSE;
+
+  index->ranges = ((const struct line_index_external_range *)
+		   (index->contents + offset));
+  offset += ((bfd_size_type) index->range_count
+	     * sizeof (struct line_index_external_range));
+  index->frames = ((const struct line_index_external_frame *)
+		   (index->contents + offset));
+  offset += ((bfd_size_type) index->frame_count
+	     * sizeof (struct line_index_external_frame));
+  index->strings = (const char *) (index->contents + offset);
+  if (index->string_size != 0
+      && index->strings[index->string_size - 1] != '\0')
+    return FALSE;
+  index->next_frame = LINE_INDEX_NONE;
+  return TRUE;
+}
+
+/* Open the index file FILENAME for ABFD.  Return NULL if it does not
+   exist or is not valid.  */
+
+static struct bfd_line_index *
+line_index_read (bfd *abfd, const char *filename)
+{
+  struct bfd_line_index *index;
+  struct stat st;
+  FILE *file;
+
+  file = _bfd_real_fopen (filename, FOPEN_RB);
+  if (file == NULL)
+    return NULL;
+
+  index = (struct bfd_line_index *) bfd_zmalloc (sizeof (*index));
+  if (index == NULL || fstat (fileno (file), &st) != 0)
+    {
+      free (index);
+      fclose (file);
+      return NULL;
+    }
+  index->size = st.st_size;
+
+#ifdef HAVE_MMAP
+  if (index->size > 0)
+    {
+      void *map = mmap (NULL, index->size, PROT_READ, MAP_PRIVATE,
+			fileno (file), 0);
+
+      if (map != MAP_FAILED)
+	{
+	  index->contents = (bfd_byte *) map;
+	  index->mapped = TRUE;
+	}
+    }
+#endif
+  if (!index->mapped)
+    {
+      index->contents = (bfd_byte *) bfd_malloc (index->size);
+      if (index->contents == NULL
+	  || fread (index->contents, 1, index->size, file) != index->size)
+	{
+	  fclose (file);
+	  _bfd_elf_close_line_index (index);
+	  return NULL;
+	}
+    }
+  fclose (file);
+
+  if (!line_index_init (abfd, index))
+    {
+      _bfd_elf_close_line_index (index);
+      return NULL;
+    }
+  return index;
+}
+
+/* Build the index of ABFD, and try to save it in FILENAME.  */
+
+static struct bfd_line_index *
+line_index_build (bfd *abfd, asymbol **symbols, const char *filename)
+{
+  struct line_index_builder builder;
+  struct line_index_external_header *header;
+  struct bfd_line_index *index = NULL;
+  bfd_size_type build_id_size = line_index_build_id_size (abfd);
+  bfd_size_type ranges_size, frames_size;
+  bfd_byte *p;
+  bfd_size_type i;
+
+  memset (&builder, 0, sizeof (builder));
+  builder.string_htab = htab_create_alloc (1024, line_index_string_hash,
+					   line_index_string_eq,
+					   line_index_string_del,
+					   calloc, free);
+  if (builder.string_htab == NULL
+      || !line_index_collect_bounds (abfd, symbols, &builder))
+    goto out;
+
+  qsort (builder.bounds, builder.bound_count, sizeof (bfd_vma),
+	 compare_line_index_bounds);
+
+  for (i = 0; i + 1 < builder.bound_count; i++)
+    if (builder.bounds[i] != builder.bounds[i + 1]
+	&& !line_index_add_range (abfd, symbols, &builder,
+				  builder.bounds[i], builder.bounds[i + 1]))
+      goto out;
+
+  index = (struct bfd_line_index *) bfd_zmalloc (sizeof (*index));
+  if (index == NULL)
+    goto out;
+
+  ranges_size = (builder.range_count
+		 * sizeof (struct line_index_external_range));
+  frames_size = (builder.frame_count
+		 * sizeof (struct line_index_external_frame));
+  index->size = (sizeof (*header) + build_id_size + ranges_size + frames_size
+		 + builder.string_size);
+  index->contents = (bfd_byte *) bfd_zmalloc (index->size);
+  if (index->contents == NULL)
+    {
+      free (index);
+      index = NULL;
+      goto out;
+    }
+
+  header = (struct line_index_external_header *) index->contents;
+  memcpy (header->magic, LINE_INDEX_MAGIC, sizeof (header->magic));
+  bfd_putl32 (LINE_INDEX_VERSION, header->version);
+  bfd_putl32 (abfd->build_id->size, header->build_id_size);
+  bfd_putl32 (builder.range_count, header->range_count);
+  bfd_putl32 (builder.frame_count, header->frame_count);
+  bfd_putl32 (builder.string_size, header->string_size);
+
+  p = index->contents + sizeof (*header);
+  memcpy (p, abfd->build_id->data, abfd->build_id->size);
+  p += build_id_size;
+  for (i = 0; i < builder.range_count; i++)
+    {
+      struct line_index_external_range *range
+	= (struct line_index_external_range *) p;
+
+      bfd_putl64 (builder.ranges[i].low, range->low);
+      bfd_putl64 (builder.ranges[i].high, range->high);
+      bfd_putl32 (builder.ranges[i].frame, range->frame);
+      p += sizeof (*range);
+    }
+  for (i = 0; i < builder.frame_count; i++)
+    {
+      struct line_index_external_frame *frame
+	= (struct line_index_external_frame *) p;
+
+      bfd_putl32 (builder.frames[i].filename, frame->filename);
+      bfd_putl32 (builder.frames[i].functionname, frame->functionname);
+      bfd_putl32 (builder.frames[i].line, frame->line);
+      bfd_putl32 (builder.frames[i].discriminator, frame->discriminator);
+      bfd_putl32 (builder.frames[i].next, frame->next);
+      p += sizeof (*frame);
+    }
+  if (builder.string_size != 0)
+    memcpy (p, builder.strings, builder.string_size);
+
+  if (!line_index_init (abfd, index))
+    {
+      _bfd_elf_close_line_index (index);
+      index = NULL;
+      goto out;
+    }
+
+  /* Write the file under a temporary name and rename it, so that a
+     concurrent reader never sees a partial file.  A failure only
+     means that the index is built again next time.  */
+  {
+    char *tmpname = (char *) bfd_malloc (strlen (filename) + 32);
+
+    if (tmpname != NULL)
+      {
+	FILE *file;
+
+	sprintf (tmpname, "%s.%ld.tmp", filename, (long) getpid ());
+	file = _bfd_real_fopen (tmpname, FOPEN_WB);
+	if (file != NULL)
+	  {
+	    bfd_boolean written
+	      = fwrite (index->contents, 1, index->size, file) == index->size;
+
+	    if (fclose (file) != 0 || !written
+		|| rename (tmpname, filename) != 0)
+	      unlink (tmpname);
+	  }
+	free (tmpname);
+      }
+  }
+
+ out:
+  free (builder.bounds);
+  free (builder.ranges);
+  free (builder.frames);
+  free (builder.strings);
+  if (builder.string_htab != NULL)
+    htab_delete (builder.string_htab);
+  return index;
+}
+
+/* Open the address to line index of ABFD in the directory DIR,
+   building it and saving it there if it does not exist yet.  SYMBOLS
+   is the symbol table of ABFD, as for bfd_find_nearest_line.  Return
+   NULL if ABFD cannot have an index, because it is not an ELF
+   executable or shared library with a build-id, or if the index cannot
+   be built.  */
+
+struct bfd_line_index *
+_bfd_elf_open_line_index (bfd *abfd, asymbol **symbols, const char *dir)
+{
+  struct bfd_line_index *index;
+  char *filename;
+  char *p;
+  bfd_size_type i;
+
+  if (bfd_get_flavour (abfd) != bfd_target_elf_flavour
+      || (abfd->flags & (EXEC_P | DYNAMIC)) == 0
+      || abfd->build_id == NULL
+      || abfd->build_id->size == 0)
+    return NULL;
+
+  filename = (char *) bfd_malloc (strlen (dir) + 2 * abfd->build_id->size
+				  + sizeof ("/.lidx"));
+  if (filename == NULL)
+    return NULL;
+  p = filename + sprintf (filename, "%s/", dir);
+  for (i = 0; i < abfd->build_id->size; i++)
+    p += sprintf (p, "%02x", abfd->build_id->data[i]);
+  strcpy (p, ".lidx");
+
+  index = line_index_read (abfd, filename);
+  if (index == NULL)
+    index = line_index_build (abfd, symbols, filename);
+
+  free (filename);
+  return index;
+}
+
+/* Find the location of ADDR in INDEX, like bfd_find_nearest_line.
+   Return FALSE if INDEX has no location for ADDR, in which case
+   bfd_find_nearest_line should be used.  */
+
+bfd_boolean
+_bfd_elf_line_index_find_nearest_line (struct bfd_line_index *index,
+				  bfd_vma addr,
+				  const char **filename_ptr,
+				  const char **functionname_ptr,
+				  unsigned int *line_ptr,
+				  unsigned int *discriminator_ptr)
+{
+  unsigned int lo = 0;
+  unsigned int hi = index->range_count;
+  const struct line_index_external_range *range;
+  unsigned int frame;
+
+  index->next_frame = LINE_INDEX_NONE;
+
+  /* Find the first range starting above ADDR.  */
+  while (lo < hi)
+    {
+      unsigned int mid = lo + (hi - lo) / 2;
+
+      if (bfd_getl64 (index->ranges[mid].low) <= addr)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+
+  if (lo == 0)
+    return FALSE;
+  range = &index->ranges[lo - 1];
+  if (addr >= bfd_getl64 (range->high))
+    return FALSE;
+
+  frame = bfd_getl32 (range->frame);
+  index->next_frame = frame;
+  if (!_bfd_elf_line_index_find_inliner_info (index, filename_ptr,
+					 functionname_ptr, line_ptr))
+    return FALSE;
+  if (discriminator_ptr != NULL)
+    *discriminator_ptr = bfd_getl32 (index->frames[frame].discriminator);
+  return TRUE;
+}
+
+/* After a successful call to _bfd_elf_line_index_find_nearest_line, return
+   the next location in the chain of inlined functions, like
+   bfd_find_inliner_info.  */
+
+bfd_boolean
+_bfd_elf_line_index_find_inliner_info (struct bfd_line_index *index,
+				  const char **filename_ptr,
+				  const char **functionname_ptr,
+				  unsigned int *line_ptr)
+{
+  const struct line_index_external_frame *frame;
+  unsigned int filename;
+  unsigned int functionname;
+
+  if (index->next_frame == LINE_INDEX_NONE
+      || index->next_frame >= index->frame_count)
+    return FALSE;
+
+  frame = &index->frames[index->next_frame];
+  filename = bfd_getl32 (frame->filename);
+  functionname = bfd_getl32 (frame->functionname);
+  if ((filename != LINE_INDEX_NONE && filename >= index->string_size)
+      || (functionname != LINE_INDEX_NONE
+	  && functionname >= index->string_size))
+    return FALSE;
+
+  *filename_ptr = (filename == LINE_INDEX_NONE
+		   ? NULL : index->strings + filename);
+  *functionname_ptr = (functionname == LINE_INDEX_NONE
+		       ? NULL : index->strings + functionname);
+  *line_ptr = bfd_getl32 (frame->line);
+  index->next_frame = bfd_getl32 (frame->next);
+  return TRUE;
+}
+
+/* Free INDEX.  */
+
+void
+_bfd_elf_close_line_index (struct bfd_line_index *index)
+{
+  if (index == NULL)
+    return;
+#ifdef HAVE_MMAP
+  if (index->mapped)
+    munmap (index->contents, index->size);
+  else
+#endif
+    free (index->contents);
+  free (index);
+}
+
 /* Find the function to a particular section and offset,
    for error reporting.  */
 
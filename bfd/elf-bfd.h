@@ -2138,6 +2138,16 @@ extern bfd_boolean _bfd_elf_find_inliner_info
   (bfd *, const char **, const char **, unsigned int *);
 extern asymbol *_bfd_elf_find_function
   (bfd *, asymbol **, asection *, bfd_vma, const char **, const char **);
+struct bfd_line_index;
+extern struct bfd_line_index *_bfd_elf_open_line_index
+  (bfd *, asymbol **, const char *);
+extern bfd_boolean _bfd_elf_line_index_find_nearest_line
+  (struct bfd_line_index *, bfd_vma, const char **, const char **,
+   unsigned int *, unsigned int *);
+extern bfd_boolean _bfd_elf_line_index_find_inliner_info
+  (struct bfd_line_index *, const char **, const char **, unsigned int *);
+extern void _bfd_elf_close_line_index
+  (struct bfd_line_index *);
 #define _bfd_elf_read_minisymbols _bfd_generic_read_minisymbols
 #define _bfd_elf_minisymbol_to_symbol _bfd_generic_minisymbol_to_symbol
 extern int _bfd_elf_sizeof_headers
@@ -315,30 +315,6 @@ _bfd_elf_strtab_emit (register bfd *abfd, struct elf_strtab_hash *tab)
   return TRUE;
 }
 
-/* Compare two elf_strtab_hash_entry structures.  Called via qsort.  */
-
-static int
-strrevcmp (const void *a, const void *b)
-{
-  struct elf_strtab_hash_entry *A = *(struct elf_strtab_hash_entry **) a;
-  struct elf_strtab_hash_entry *B = *(struct elf_strtab_hash_entry **) b;
-  unsigned int lenA = A->len;
-  unsigned int lenB = B->len;
-  const unsigned char *s = (const unsigned char *) A->root.string + lenA - 1;
-  const unsigned char *t = (const unsigned char *) B->root.string + lenB - 1;
-  int l = lenA < lenB ? lenA : lenB;
-
-  while (l)
-    {
-      if (*s != *t)
-	return (int) *s - (int) *t;
-      s--;
-      t--;
-      l--;
-    }
-  return lenA - lenB;
-}
-
 static inline int
 is_suffix (const struct elf_strtab_hash_entry *A,
 	   const struct elf_strtab_hash_entry *B)
@@ -358,14 +334,15 @@ is_suffix (const struct elf_strtab_hash_entry *A,
 void
 _bfd_elf_strtab_finalize (struct elf_strtab_hash *tab)
 {
-  struct elf_strtab_hash_entry **array, **a, *e;
+  struct bfd_suffix_sort_entry *array, *a;
+  struct elf_strtab_hash_entry *e;
   bfd_size_type amt, sec_size;
   size_t size, i;
 
   /* Sort the strings by suffix and length.  */
   amt = tab->size;
-  amt *= sizeof (struct elf_strtab_hash_entry *);
-  array = (struct elf_strtab_hash_entry **) bfd_malloc (amt);
+  amt *= sizeof (struct bfd_suffix_sort_entry);
+  array = (struct bfd_suffix_sort_entry *) bfd_malloc (amt);
   if (array == NULL)
     goto alloc_failure;
 
@@ -374,9 +351,12 @@ _bfd_elf_strtab_finalize (struct elf_strtab_hash *tab)
       e = tab->array[i];
       if (e->refcount)
 	{
-	  *a++ = e;
-	  /* Adjust the length to not include the zero terminator.  */
-	  e->len -= 1;
+	  a->string = (const unsigned char *) e->root.string;
+	  /* Do not include the zero terminator.  */
+	  a->len = e->len - 1;
+	  a->group = 0;
+	  a->entry = e;
+	  a++;
 	}
       else
 	e->len = 0;
@@ -385,7 +365,7 @@ _bfd_elf_strtab_finalize (struct elf_strtab_hash *tab)
   size = a - array;
   if (size != 0)
     {
-      qsort (array, size, sizeof (struct elf_strtab_hash_entry *), strrevcmp);
+      _bfd_suffix_sort (array, size);
 
       /* Loop over the sorted array and merge suffixes.  Start from the
 	 end because we want eg.
@@ -401,13 +381,12 @@ _bfd_elf_strtab_finalize (struct elf_strtab_hash *tab)
 	 s1 _______^
 
 	 ie. we don't want s1 pointing into the old s2.  */
-      e = *--a;
-      e->len += 1;
+      e = (struct elf_strtab_hash_entry *) (--a)->entry;
       while (--a >= array)
 	{
-	  struct elf_strtab_hash_entry *cmp = *a;
+	  struct elf_strtab_hash_entry *cmp
+	    = (struct elf_strtab_hash_entry *) a->entry;
 
-	  cmp->len += 1;
 	  if (is_suffix (e, cmp))
 	    {
 	      cmp->u.suffix = e;
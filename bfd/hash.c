@@ -92,6 +92,20 @@ SUBSECTION
 	Use <<bfd_hash_set_default_size>> to set the default size of
 	hash table to use.
 
+@findex bfd_hash_table_init_open
+@findex bfd_hash_set_default_open_addressing
+	By default a hash table keeps a chain of entries for each
+	bucket.  The function <<bfd_hash_table_init_open>>, which
+	takes the same arguments as <<bfd_hash_table_init_n>>, instead
+	creates a table which uses open addressing: the table is an
+	array of slots, each holding an entry together with its hash
+	code and string length, so that most probes do not have to
+	read the entry itself.  Use
+	<<bfd_hash_set_default_open_addressing>> to make
+	<<bfd_hash_table_init>> create such tables.  Code which walks
+	the <<table>> array or follows the <<next>> field of an entry
+	directly must only be used on chained tables.
+
 INODE
 Looking Up or Entering a String, Traversing a Hash Table, Creating and Freeing a Hash Table, Hash Tables
 SUBSECTION
@@ -361,6 +375,10 @@ higher_prime_number (unsigned long n)
 }
 
 static unsigned long bfd_default_hash_table_size = DEFAULT_SIZE;
+static bfd_boolean bfd_default_hash_table_open = FALSE;
+
+/* The number of slots in the smallest open addressing table.  */
+#define MIN_OPEN_SIZE 16
 
 /* Create a new hash table, given a number of entries.  */
 
@@ -397,6 +415,7 @@ bfd_hash_table_init_n (struct bfd_hash_table *table,
       return FALSE;
     }
   memset ((void *) table->table, 0, alloc);
+  table->slots = NULL;
   table->size = size;
   table->entsize = entsize;
   table->count = 0;
@@ -405,6 +424,61 @@ bfd_hash_table_init_n (struct bfd_hash_table *table,
   return TRUE;
 }
 
+/* Create a new hash table which uses open addressing, given a number
+   of entries.  The number of slots is SIZE rounded up to a power of
+   two.  */
+
+bfd_boolean
+bfd_hash_table_init_open
+  (struct bfd_hash_table *table,
+   struct bfd_hash_entry *(*newfunc) (struct bfd_hash_entry *,
+				      struct bfd_hash_table *,
+				      const char *),
+   unsigned int entsize,
+   unsigned int size)
+{
+  unsigned long alloc;
+  unsigned int nslots;
+
+  for (nslots = MIN_OPEN_SIZE; nslots < size; nslots *= 2)
+    if (nslots * 2 < nslots)
+      {
+	bfd_set_error (bfd_error_no_memory);
+	return FALSE;
+      }
+
+  alloc = nslots;
+  alloc *= sizeof (struct bfd_hash_slot);
+  if (alloc / sizeof (struct bfd_hash_slot) != nslots)
+    {
+      bfd_set_error (bfd_error_no_memory);
+      return FALSE;
+    }
+
+  table->memory = (void *) objalloc_create ();
+  if (table->memory == NULL)
+    {
+      bfd_set_error (bfd_error_no_memory);
+      return FALSE;
+    }
+  table->slots = (struct bfd_hash_slot *)
+      objalloc_alloc ((struct objalloc *) table->memory, alloc);
+  if (table->slots == NULL)
+    {
+      bfd_hash_table_free (table);
+      bfd_set_error (bfd_error_no_memory);
+      return FALSE;
+    }
+  memset ((void *) table->slots, 0, alloc);
+  table->table = NULL;
+  table->size = nslots;
+  table->entsize = entsize;
+  table->count = 0;
+  table->frozen = 0;
+  table->newfunc = newfunc;
+  return TRUE;
+}
+
 /* Create a new hash table with the default number of entries.  */
 
 bfd_boolean
@@ -414,6 +488,9 @@ bfd_hash_table_init (struct bfd_hash_table *table,
 							const char *),
 		     unsigned int entsize)
 {
+  if (bfd_default_hash_table_open)
+    return bfd_hash_table_init_open (table, newfunc, entsize,
+				     bfd_default_hash_table_size);
   return bfd_hash_table_init_n (table, newfunc, entsize,
 				bfd_default_hash_table_size);
 }
@@ -451,6 +528,210 @@ bfd_hash_hash (const char *string, unsigned int *lenp)
   return hash;
 }
 
+/* Return the first slot to probe for HASH in an open addressing table
+   of SIZE slots.  The low bits of bfd_hash_hash are not well mixed,
+   so scramble them before masking.  */
+
+static inline unsigned int
+bfd_hash_open_index (unsigned int hash, unsigned int size)
+{
+  hash *= 0x9e3779b1;
+  return (hash ^ (hash >> 16)) & (size - 1);
+}
+
+/* Look up STRING, of length LEN and hash code HASH, in the open
+   addressing TABLE.  */
+
+static struct bfd_hash_entry *
+bfd_hash_open_lookup (struct bfd_hash_table *table,
+		      const char *string,
+		      unsigned long hash,
+		      unsigned int len)
+{
+  unsigned int mask = table->size - 1;
+  unsigned int i;
+
+  /* There is always at least one empty slot.  */
+  for (i = bfd_hash_open_index (hash, table->size); ; i = (i + 1) & mask)
+    {
+      struct bfd_hash_slot *slot = &table->slots[i];
+
+      if (slot->entry == NULL)
+	return NULL;
+      if (slot->hash == (unsigned int) hash
+	  && slot->len == len
+	  && memcmp (slot->entry->string, string, len) == 0)
+	return slot->entry;
+    }
+}
+
+/* Put ENT, whose string has length LEN, into a free slot of the open
+   addressing TABLE.  If there are already entries for the same
+   string, ENT goes in front of them so that lookups find the newest
+   entry, as they do in a chained table.  */
+
+static void
+bfd_hash_open_place (struct bfd_hash_table *table,
+		     struct bfd_hash_entry *ent,
+		     unsigned int len)
+{
+  unsigned int mask = table->size - 1;
+  unsigned int hash = ent->hash;
+  unsigned int i;
+
+  for (i = bfd_hash_open_index (hash, table->size); ; i = (i + 1) & mask)
+    {
+      struct bfd_hash_slot *slot = &table->slots[i];
+
+      if (slot->entry == NULL)
+	{
+	  slot->entry = ent;
+	  slot->hash = hash;
+	  slot->len = len;
+	  return;
+	}
+      if (slot->hash == hash
+	  && slot->len == len
+	  && memcmp (slot->entry->string, ent->string, len) == 0)
+	{
+	  struct bfd_hash_entry *older = slot->entry;
+
+	  slot->entry = ent;
+	  ent = older;
+	}
+    }
+}
+
+/* Double the number of slots in the open addressing TABLE.  Return
+   FALSE if that is not possible.  */
+
+static bfd_boolean
+bfd_hash_open_grow (struct bfd_hash_table *table)
+{
+  unsigned int newsize = table->size * 2;
+  unsigned long alloc = (unsigned long) newsize * sizeof (struct bfd_hash_slot);
+  struct bfd_hash_slot *newslots;
+  unsigned int mask = table->size - 1;
+  unsigned int start;
+  unsigned int i;
+
+  if (newsize < table->size
+      || alloc / sizeof (struct bfd_hash_slot) != newsize)
+    return FALSE;
+
+  newslots = ((struct bfd_hash_slot *)
+	      objalloc_alloc ((struct objalloc *) table->memory, alloc));
+  if (newslots == NULL)
+    return FALSE;
+  memset (newslots, 0, alloc);
+
+  /* Start just after an empty slot, so that each run of entries for
+     the same string is moved in probe order and stays newest first.
+     Only the stored hash codes are needed, not the entries.  */
+  for (start = 0; table->slots[start].entry != NULL; start++)
+    ;
+  for (i = (start + 1) & mask; i != start; i = (i + 1) & mask)
+    {
+      struct bfd_hash_slot *slot = &table->slots[i];
+      unsigned int j;
+
+      if (slot->entry == NULL)
+	continue;
+      for (j = bfd_hash_open_index (slot->hash, newsize);
+	   newslots[j].entry != NULL;
+	   j = (j + 1) & (newsize - 1))
+	;
+      newslots[j] = *slot;
+    }
+
+  table->slots = newslots;
+  table->size = newsize;
+  return TRUE;
+}
+
+/* Insert an entry for STRING, of length LEN and hash code HASH, into
+   the open addressing TABLE.  */
+
+static struct bfd_hash_entry *
+bfd_hash_open_insert (struct bfd_hash_table *table,
+		      const char *string,
+		      unsigned long hash,
+		      unsigned int len)
+{
+  struct bfd_hash_entry *hashp;
+
+  /* Keep at least half the slots empty so that probe sequences stay
+     short.  A frozen table may fill up further, but always keeps one
+     empty slot to end each probe.  */
+  if (!table->frozen
+      && (table->count + 1) * 2 > table->size
+      && !bfd_hash_open_grow (table))
+    table->frozen = 1;
+  if (table->count + 2 > table->size
+      && !bfd_hash_open_grow (table))
+    {
+      bfd_set_error (bfd_error_no_memory);
+      return NULL;
+    }
+
+  hashp = (*table->newfunc) (NULL, table, string);
+  if (hashp == NULL)
+    return NULL;
+  hashp->next = NULL;
+  hashp->string = string;
+  hashp->hash = hash;
+  bfd_hash_open_place (table, hashp, len);
+  table->count++;
+  return hashp;
+}
+
+/* Find the slot holding ENT in the open addressing TABLE.  */
+
+static unsigned int
+bfd_hash_open_find (struct bfd_hash_table *table,
+		    struct bfd_hash_entry *ent)
+{
+  unsigned int mask = table->size - 1;
+  unsigned int i;
+
+  for (i = bfd_hash_open_index (ent->hash, table->size);
+       table->slots[i].entry != ent;
+       i = (i + 1) & mask)
+    if (table->slots[i].entry == NULL)
+      abort ();
+  return i;
+}
+
+/* Remove ENT from the open addressing TABLE.  Later entries in the
+   same run of full slots are moved back to fill the gap, so no
+   deleted markers are needed.  */
+
+static void
+bfd_hash_open_remove (struct bfd_hash_table *table,
+		      struct bfd_hash_entry *ent)
+{
+  unsigned int mask = table->size - 1;
+  unsigned int i;
+  unsigned int j;
+
+  i = bfd_hash_open_find (table, ent);
+  for (j = (i + 1) & mask;
+       table->slots[j].entry != NULL;
+       j = (j + 1) & mask)
+    {
+      unsigned int k = bfd_hash_open_index (table->slots[j].hash,
+					    table->size);
+
+      /* The entry at J can only move back to I if its first probe is
+	 not cyclically within (I, J].  */
+      if (i <= j ? (i < k && k <= j) : (i < k || k <= j))
+	continue;
+      table->slots[i] = table->slots[j];
+      i = j;
+    }
+  table->slots[i].entry = NULL;
+}
+
 /* Look up a string in a hash table.  */
 
 struct bfd_hash_entry *
@@ -465,15 +746,24 @@ bfd_hash_lookup (struct bfd_hash_table *table,
   unsigned int _index;
 
   hash = bfd_hash_hash (string, &len);
-  _index = hash % table->size;
-  for (hashp = table->table[_index];
-       hashp != NULL;
-       hashp = hashp->next)
+  if (table->slots != NULL)
     {
-      if (hashp->hash == hash
-	  && strcmp (hashp->string, string) == 0)
+      hashp = bfd_hash_open_lookup (table, string, hash, len);
+      if (hashp != NULL)
 	return hashp;
     }
+  else
+    {
+      _index = hash % table->size;
+      for (hashp = table->table[_index];
+	   hashp != NULL;
+	   hashp = hashp->next)
+	{
+	  if (hashp->hash == hash
+	      && strcmp (hashp->string, string) == 0)
+	    return hashp;
+	}
+    }
 
   if (! create)
     return NULL;
@@ -493,9 +783,48 @@ bfd_hash_lookup (struct bfd_hash_table *table,
       string = new_string;
     }
 
+  if (table->slots != NULL)
+    return bfd_hash_open_insert (table, string, hash, len);
   return bfd_hash_insert (table, string, hash);
 }
 
+/* Hint that STRING will shortly be looked up in TABLE.  If ENTRY is
+   FALSE, prefetch the bucket that bfd_hash_lookup will search.  If
+   ENTRY is TRUE, prefetch the first entry on that bucket's chain;
+   this is only worthwhile once an earlier call has brought the
+   bucket itself into the cache.  */
+
+void
+_bfd_hash_prefetch (struct bfd_hash_table *table ATTRIBUTE_UNUSED,
+		   const char *string ATTRIBUTE_UNUSED,
+		   bfd_boolean entry ATTRIBUTE_UNUSED)
+{
+#if GCC_VERSION >= 3001
+  unsigned long hash = bfd_hash_hash (string, NULL);
+
+  if (table->slots != NULL)
+    {
+      struct bfd_hash_slot *slot;
+
+      slot = &table->slots[bfd_hash_open_index (hash, table->size)];
+      if (!entry)
+	__builtin_prefetch (slot);
+      else if (slot->entry != NULL)
+	__builtin_prefetch (slot->entry);
+    }
+  else
+    {
+      struct bfd_hash_entry **bucket;
+
+      bucket = &table->table[hash % table->size];
+      if (!entry)
+	__builtin_prefetch (bucket);
+      else if (*bucket != NULL)
+	__builtin_prefetch (*bucket);
+    }
+#endif
+}
+
 /* Insert an entry in a hash table.  */
 
 struct bfd_hash_entry *
@@ -506,6 +835,9 @@ bfd_hash_insert (struct bfd_hash_table *table,
   struct bfd_hash_entry *hashp;
   unsigned int _index;
 
+  if (table->slots != NULL)
+    return bfd_hash_open_insert (table, string, hash, strlen (string));
+
   hashp = (*table->newfunc) (NULL, table, string);
   if (hashp == NULL)
     return NULL;
@@ -571,6 +903,17 @@ bfd_hash_rename (struct bfd_hash_table *table,
   unsigned int _index;
   struct bfd_hash_entry **pph;
 
+  if (table->slots != NULL)
+    {
+      unsigned int len;
+
+      bfd_hash_open_remove (table, ent);
+      ent->string = string;
+      ent->hash = bfd_hash_hash (string, &len);
+      bfd_hash_open_place (table, ent, len);
+      return;
+    }
+
   _index = ent->hash % table->size;
   for (pph = &table->table[_index]; *pph != NULL; pph = &(*pph)->next)
     if (*pph == ent)
@@ -596,6 +939,12 @@ bfd_hash_replace (struct bfd_hash_table *table,
   unsigned int _index;
   struct bfd_hash_entry **pph;
 
+  if (table->slots != NULL)
+    {
+      table->slots[bfd_hash_open_find (table, old)].entry = nw;
+      return;
+    }
+
   _index = old->hash % table->size;
   for (pph = &table->table[_index];
        (*pph) != NULL;
@@ -648,14 +997,29 @@ bfd_hash_traverse (struct bfd_hash_table *table,
   unsigned int i;
 
   table->frozen = 1;
-  for (i = 0; i < table->size; i++)
+  if (table->slots != NULL)
     {
-      struct bfd_hash_entry *p;
-
-      for (p = table->table[i]; p != NULL; p = p->next)
-	if (! (*func) (p, info))
+      /* A full table grows even when frozen.  The old slots stay
+	 allocated, so carry on walking those.  */
+      struct bfd_hash_slot *slots = table->slots;
+      unsigned int size = table->size;
+
+      for (i = 0; i < size; i++)
+	if (slots[i].entry != NULL
+	    && ! (*func) (slots[i].entry, info))
 	  goto out;
     }
+  else
+    {
+      for (i = 0; i < table->size; i++)
+	{
+	  struct bfd_hash_entry *p;
+
+	  for (p = table->table[i]; p != NULL; p = p->next)
+	    if (! (*func) (p, info))
+	      goto out;
+	}
+    }
  out:
   table->frozen = 0;
 }
@@ -678,6 +1042,12 @@ bfd_hash_set_default_size (unsigned long hash_size)
   bfd_default_hash_table_size = hash_size_primes[_index];
   return bfd_default_hash_table_size;
 }
+
+void
+bfd_hash_set_default_open_addressing (bfd_boolean open_addressing)
+{
+  bfd_default_hash_table_open = open_addressing;
+}
 
 /* A few different object file formats (a.out, COFF, ELF) use a string
    table.  These functions support adding strings to a string table,
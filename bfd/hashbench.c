@@ -0,0 +1,303 @@
+/* hashbench.c -- Microbenchmark for the BFD hash table code.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+
+   This file is part of BFD, the Binary File Descriptor library.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.  */
+
+/* This program replays the hash table traffic of a link against both
+   hash table engines.  It is not built by default; use
+   "make hashbench" in the bfd build directory, then
+
+	./hashbench [-n REPEAT] [-s SIZE] FILE...
+
+   where FILE... are the object files and archives of a real link, in
+   link order.  Every global, weak, common or undefined symbol of
+   every object (including every archive member) is entered into the
+   table in order, much as bfd_link_add_symbols does.  Then every
+   name is looked up again, as relocation processing does, and the
+   table is traversed once, as writing the symbol table does.  The
+   best time of REPEAT runs of each phase is reported for a chained
+   table and an open addressing table, both created with SIZE
+   initial slots, and the two tables are checked to hold the same
+   entries.  */
+
+#include "sysdep.h"
+#include "bfd.h"
+#include "libiberty.h"
+#include "getopt.h"
+
+static const char *program_name;
+
+/* Linker hash table entries are much larger than a bare
+   bfd_hash_entry, which matters for the cache behaviour being
+   measured, so pad the entries to a typical size.  */
+
+struct bench_entry
+{
+  struct bfd_hash_entry root;
+  char payload[128 - sizeof (struct bfd_hash_entry)];
+};
+
+static struct bfd_hash_entry *
+bench_newfunc (struct bfd_hash_entry *entry,
+	       struct bfd_hash_table *table,
+	       const char *string ATTRIBUTE_UNUSED)
+{
+  if (entry == NULL)
+    entry = (struct bfd_hash_entry *)
+      bfd_hash_allocate (table, sizeof (struct bench_entry));
+  return entry;
+}
+
+/* The names entered into the table, in order.  */
+static const char **names;
+static size_t name_count;
+static size_t name_alloc;
+
+static void
+add_name (const char *name)
+{
+  if (name_count == name_alloc)
+    {
+      name_alloc = name_alloc ? name_alloc * 2 : 4096;
+      names = (const char **) xrealloc (names,
+					name_alloc * sizeof (*names));
+    }
+  names[name_count++] = name;
+}
+
+/* Record the names of the external symbols of object ABFD.  The
+   symbol table is deliberately never freed, since the names point
+   into it.  */
+
+static void
+add_object (bfd *abfd)
+{
+  long storage;
+  long count;
+  long i;
+  asymbol **syms;
+
+  if ((bfd_get_file_flags (abfd) & HAS_SYMS) == 0)
+    return;
+  storage = bfd_get_symtab_upper_bound (abfd);
+  if (storage <= 0)
+    return;
+  syms = (asymbol **) xmalloc (storage);
+  count = bfd_canonicalize_symtab (abfd, syms);
+  for (i = 0; i < count; i++)
+    {
+      asymbol *sym = syms[i];
+
+      if ((sym->flags & (BSF_GLOBAL | BSF_WEAK | BSF_GNU_UNIQUE)) != 0
+	  || bfd_is_und_section (sym->section)
+	  || bfd_is_com_section (sym->section))
+	add_name (bfd_asymbol_name (sym));
+    }
+}
+
+static void
+add_file (const char *filename)
+{
+  bfd *abfd;
+
+  abfd = bfd_openr (filename, NULL);
+  if (abfd == NULL)
+    {
+      bfd_perror (filename);
+      xexit (1);
+    }
+  if (bfd_check_format (abfd, bfd_archive))
+    {
+      bfd *member = NULL;
+
+      while ((member = bfd_openr_next_archived_file (abfd, member)) != NULL)
+	if (bfd_check_format (member, bfd_object))
+	  add_object (member);
+    }
+  else if (bfd_check_format (abfd, bfd_object))
+    add_object (abfd);
+  else
+    {
+      bfd_perror (filename);
+      xexit (1);
+    }
+}
+
+static bfd_boolean
+count_entry (struct bfd_hash_entry *entry ATTRIBUTE_UNUSED, void *data)
+{
+  ++*(size_t *) data;
+  return TRUE;
+}
+
+/* The best times in microseconds of the three phases for one
+   engine.  */
+
+struct bench_times
+{
+  long insert;
+  long lookup;
+  long traverse;
+};
+
+static void
+run (bfd_boolean open_addressing, unsigned int size, int repeat,
+     struct bench_times *best, struct bfd_hash_table *keep)
+{
+  int r;
+
+  for (r = 0; r < repeat; r++)
+    {
+      struct bfd_hash_table table;
+      bfd_boolean ok;
+      size_t i;
+      size_t n;
+      long start;
+      long insert;
+      long lookup;
+      long traverse;
+
+      if (open_addressing)
+	ok = bfd_hash_table_init_open (&table, bench_newfunc,
+				       sizeof (struct bench_entry), size);
+      else
+	ok = bfd_hash_table_init_n (&table, bench_newfunc,
+				    sizeof (struct bench_entry), size);
+      if (!ok)
+	{
+	  bfd_perror ("hashbench");
+	  xexit (1);
+	}
+
+      start = get_run_time ();
+      for (i = 0; i < name_count; i++)
+	if (bfd_hash_lookup (&table, names[i], TRUE, FALSE) == NULL)
+	  {
+	    bfd_perror ("hashbench");
+	    xexit (1);
+	  }
+      insert = get_run_time () - start;
+
+      start = get_run_time ();
+      for (i = 0; i < name_count; i++)
+	if (bfd_hash_lookup (&table, names[i], FALSE, FALSE) == NULL)
+	  abort ();
+      lookup = get_run_time () - start;
+
+      start = get_run_time ();
+      n = 0;
+      bfd_hash_traverse (&table, count_entry, &n);
+      traverse = get_run_time () - start;
+      if (n != table.count)
+	abort ();
+
+      if (r == 0 || insert < best->insert)
+	best->insert = insert;
+      if (r == 0 || lookup < best->lookup)
+	best->lookup = lookup;
+      if (r == 0 || traverse < best->traverse)
+	best->traverse = traverse;
+
+      if (r == repeat - 1)
+	*keep = table;
+      else
+	bfd_hash_table_free (&table);
+    }
+}
+
+static void
+report (const char *engine, const struct bench_times *t)
+{
+  printf ("%-16s %10ld %10ld %10ld\n", engine, t->insert, t->lookup,
+	  t->traverse);
+}
+
+static void
+usage (FILE *stream, int status)
+{
+  fprintf (stream, "Usage: %s [-n REPEAT] [-s SIZE] FILE...\n",
+	   program_name);
+  xexit (status);
+}
+
+int
+main (int argc, char **argv)
+{
+  int repeat = 5;
+  unsigned int size = 4051;
+  struct bench_times chained;
+  struct bench_times open_times;
+  struct bfd_hash_table chained_table;
+  struct bfd_hash_table open_table;
+  size_t i;
+  int c;
+
+  program_name = argv[0];
+  xmalloc_set_program_name (program_name);
+
+  while ((c = getopt (argc, argv, "n:s:h")) != EOF)
+    switch (c)
+      {
+      case 'n':
+	repeat = atoi (optarg);
+	if (repeat < 1)
+	  usage (stderr, 1);
+	break;
+      case 's':
+	size = strtoul (optarg, NULL, 0);
+	if (size < 1)
+	  usage (stderr, 1);
+	break;
+      case 'h':
+	usage (stdout, 0);
+	break;
+      default:
+	usage (stderr, 1);
+      }
+  if (optind == argc)
+    usage (stderr, 1);
+
+  bfd_init ();
+
+  for (; optind < argc; optind++)
+    add_file (argv[optind]);
+
+  run (FALSE, size, repeat, &chained, &chained_table);
+  run (TRUE, size, repeat, &open_times, &open_table);
+
+  /* Both engines must agree on what the table holds.  */
+  if (chained_table.count != open_table.count)
+    abort ();
+  for (i = 0; i < name_count; i++)
+    if (strcmp (bfd_hash_lookup (&chained_table, names[i],
+				 FALSE, FALSE)->string,
+		bfd_hash_lookup (&open_table, names[i],
+				 FALSE, FALSE)->string) != 0)
+      abort ();
+
+  printf ("%lu operations, %u entries, best of %d runs (microseconds)\n",
+	  (unsigned long) name_count, open_table.count, repeat);
+  printf ("%-16s %10s %10s %10s\n", "engine", "insert", "lookup",
+	  "traverse");
+  report ("chained", &chained);
+  report ("open addressing", &open_times);
+
+  bfd_hash_table_free (&chained_table);
+  bfd_hash_table_free (&open_table);
+  return 0;
+}
@@ -598,6 +598,10 @@ extern void _bfd_dwarf2_cleanup_debug_info
 extern struct bfd_hash_entry *bfd_section_hash_newfunc
   (struct bfd_hash_entry *, struct bfd_hash_table *, const char *);
 
+/* Hint that a string will shortly be looked up in a hash table.  */
+extern void _bfd_hash_prefetch
+  (struct bfd_hash_table *, const char *, bfd_boolean entry);
+
 /* A routine to create entries for a bfd_link_hash_table.  */
 extern struct bfd_hash_entry *_bfd_link_hash_newfunc
   (struct bfd_hash_entry *entry, struct bfd_hash_table *table,
@@ -732,6 +736,26 @@ extern bfd_vma _bfd_merged_section_offset
 
 extern void _bfd_merge_sections_free (void *);
 
+/* An element of the array sorted by _bfd_suffix_sort.  */
+
+struct bfd_suffix_sort_entry
+{
+  /* The string, and its length not counting the terminator.  */
+  const unsigned char *string;
+  unsigned int len;
+  /* Strings are ordered by GROUP before anything else.  */
+  unsigned int group;
+  /* The caller's data for this string.  */
+  void *entry;
+};
+
+/* Sort strings by GROUP, then by their contents read backwards, shorter
+   strings first.  A string that is a suffix of another thus sorts
+   before it, with only strings ending in the same suffix in between.  */
+
+extern void _bfd_suffix_sort
+  (struct bfd_suffix_sort_entry *, size_t);
+
 /* Create a string table.  */
 extern struct bfd_strtab_hash *_bfd_stringtab_init
   (void);
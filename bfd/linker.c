@@ -635,26 +635,34 @@ unwrap_hash_lookup (struct bfd_link_info *info,
    real symbol in a bfd_hash_travere.  This traversal calls func with
    the real symbol.  */
 
+struct link_hash_traverse_info
+{
+  bfd_boolean (*func) (struct bfd_link_hash_entry *, void *);
+  void *info;
+};
+
+static bfd_boolean
+link_hash_traverse_real (struct bfd_hash_entry *ent, void *data)
+{
+  struct link_hash_traverse_info *tinfo
+    = (struct link_hash_traverse_info *) data;
+  struct bfd_link_hash_entry *p = (struct bfd_link_hash_entry *) ent;
+
+  return (*tinfo->func) (p->type == bfd_link_hash_warning ? p->u.i.link : p,
+			 tinfo->info);
+}
+
 void
 bfd_link_hash_traverse
   (struct bfd_link_hash_table *htab,
    bfd_boolean (*func) (struct bfd_link_hash_entry *, void *),
    void *info)
 {
-  unsigned int i;
+  struct link_hash_traverse_info tinfo;
 
-  htab->table.frozen = 1;
-  for (i = 0; i < htab->table.size; i++)
-    {
-      struct bfd_link_hash_entry *p;
-
-      p = (struct bfd_link_hash_entry *) htab->table.table[i];
-      for (; p != NULL; p = (struct bfd_link_hash_entry *) p->root.next)
-	if (!(*func) (p->type == bfd_link_hash_warning ? p->u.i.link : p, info))
-	  goto out;
-    }
- out:
-  htab->table.frozen = 0;
+  tinfo.func = func;
+  tinfo.info = info;
+  bfd_hash_traverse (&htab->table, link_hash_traverse_real, &tinfo);
 }
 
 /* Add a symbol to the linker hash table undefs list.  */
@@ -543,55 +543,143 @@ error_return:
   return FALSE;
 }
 
+/* Subarrays no longer than this are sorted by insertion sort.  */
+#define SUFFIX_SORT_SMALL 12
+
+/* Return the key of E at DEPTH for _bfd_suffix_sort: its group at
+   depth zero, then its characters from last to first, each plus one,
+   then zero once they run out.  */
+
+static inline unsigned int
+suffix_sort_key (const struct bfd_suffix_sort_entry *e, unsigned int depth)
+{
+  if (depth == 0)
+    return e->group;
+  if (depth > e->len)
+    return 0;
+  return e->string[e->len - depth] + 1;
+}
+
+/* Compare A and B, which have equal keys below DEPTH.  */
+
 static int
-strrevcmp (const void *a, const void *b)
+suffix_sort_compare (const struct bfd_suffix_sort_entry *a,
+		     const struct bfd_suffix_sort_entry *b,
+		     unsigned int depth)
 {
-  struct sec_merge_hash_entry *A = *(struct sec_merge_hash_entry **) a;
-  struct sec_merge_hash_entry *B = *(struct sec_merge_hash_entry **) b;
-  unsigned int lenA = A->len;
-  unsigned int lenB = B->len;
-  const unsigned char *s = (const unsigned char *) A->root.string + lenA - 1;
-  const unsigned char *t = (const unsigned char *) B->root.string + lenB - 1;
-  int l = lenA < lenB ? lenA : lenB;
-
-  while (l)
+  for (;; depth++)
     {
-      if (*s != *t)
-	return (int) *s - (int) *t;
-      s--;
-      t--;
-      l--;
+      unsigned int ka = suffix_sort_key (a, depth);
+      unsigned int kb = suffix_sort_key (b, depth);
+
+      if (ka != kb)
+	return ka < kb ? -1 : 1;
+      if (ka == 0 && depth != 0)
+	return 0;
     }
-  return lenA - lenB;
 }
 
-/* Like strrevcmp, but for the case where all strings have the same
-   alignment > entsize.  */
+static inline void
+suffix_sort_swap (struct bfd_suffix_sort_entry *a,
+		  struct bfd_suffix_sort_entry *b)
+{
+  struct bfd_suffix_sort_entry t = *a;
+  *a = *b;
+  *b = t;
+}
 
-static int
-strrevcmp_align (const void *a, const void *b)
+/* Sort the N entries of ARRAY, which have equal keys below DEPTH.
+   This is a multikey quicksort: the array is split three ways on the
+   key at DEPTH, and only those entries equal to the pivot move on to
+   the next key.  A suffix shared by many strings is thus examined
+   about log N times, not once per comparison as when qsort compares
+   whole strings.  */
+
+static void
+suffix_sort (struct bfd_suffix_sort_entry *array, size_t n,
+	     unsigned int depth)
 {
-  struct sec_merge_hash_entry *A = *(struct sec_merge_hash_entry **) a;
-  struct sec_merge_hash_entry *B = *(struct sec_merge_hash_entry **) b;
-  unsigned int lenA = A->len;
-  unsigned int lenB = B->len;
-  const unsigned char *s = (const unsigned char *) A->root.string + lenA - 1;
-  const unsigned char *t = (const unsigned char *) B->root.string + lenB - 1;
-  int l = lenA < lenB ? lenA : lenB;
-  int tail_align = (lenA & (A->alignment - 1)) - (lenB & (A->alignment - 1));
-
-  if (tail_align != 0)
-    return tail_align;
-
-  while (l)
+  while (n > SUFFIX_SORT_SMALL)
+    {
+      struct bfd_suffix_sort_entry *part[3];
+      size_t part_n[3];
+      unsigned int part_depth[3];
+      unsigned int k0, k1, k2, pivot;
+      size_t lt, i, gt;
+      int big, j;
+
+      /* Use the median of three keys as the pivot.  */
+      k0 = suffix_sort_key (&array[0], depth);
+      k1 = suffix_sort_key (&array[n / 2], depth);
+      k2 = suffix_sort_key (&array[n - 1], depth);
+      if (k0 > k1)
+	{
+	  unsigned int t = k0;
+	  k0 = k1;
+	  k1 = t;
+	}
+      pivot = k2 < k0 ? k0 : k2 > k1 ? k1 : k2;
+
+      lt = 0;
+      i = 0;
+      gt = n;
+      while (i < gt)
+	{
+	  unsigned int k = suffix_sort_key (&array[i], depth);
+
+	  if (k < pivot)
+	    suffix_sort_swap (&array[lt++], &array[i++]);
+	  else if (k > pivot)
+	    suffix_sort_swap (&array[i], &array[--gt]);
+	  else
+	    i++;
+	}
+
+      part[0] = array;
+      part_n[0] = lt;
+      part_depth[0] = depth;
+      part[1] = array + lt;
+      part_n[1] = gt - lt;
+      part_depth[1] = depth + 1;
+      part[2] = array + gt;
+      part_n[2] = n - gt;
+      part_depth[2] = depth;
+
+      /* Strings that have all ended at this depth are equal, and the
+	 hash tables never hold two equal strings, but be safe.  */
+      if (pivot == 0 && depth != 0)
+	part_n[1] = 0;
+
+      /* Recurse on the two smaller parts and loop on the biggest,
+	 which keeps the recursion depth logarithmic.  */
+      big = 0;
+      for (j = 1; j < 3; j++)
+	if (part_n[j] > part_n[big])
+	  big = j;
+      for (j = 0; j < 3; j++)
+	if (j != big && part_n[j] > 1)
+	  suffix_sort (part[j], part_n[j], part_depth[j]);
+      array = part[big];
+      n = part_n[big];
+      depth = part_depth[big];
+    }
+
+  if (n > 1)
     {
-      if (*s != *t)
-	return (int) *s - (int) *t;
-      s--;
-      t--;
-      l--;
+      size_t i, j;
+
+      for (i = 1; i < n; i++)
+	for (j = i;
+	     j > 0 && suffix_sort_compare (&array[j - 1], &array[j], depth) > 0;
+	     j--)
+	  suffix_sort_swap (&array[j - 1], &array[j]);
     }
-  return lenA - lenB;
+}
+
+void
+_bfd_suffix_sort (struct bfd_suffix_sort_entry *array, size_t n)
+{
+  suffix_sort (array, n, 0);
 }
 
 static inline int
@@ -612,23 +700,28 @@ is_suffix (const struct sec_merge_hash_entry *A,
 static void
 merge_strings (struct sec_merge_info *sinfo)
 {
-  struct sec_merge_hash_entry **array, **a, *e;
+  struct bfd_suffix_sort_entry *array, *p;
+  struct sec_merge_hash_entry **a, *e;
   struct sec_merge_sec_info *secinfo;
   bfd_size_type size, amt;
   unsigned int alignment = 0;
+  unsigned int entsize = sinfo->htab->entsize;
 
   /* Now sort the strings */
-  amt = sinfo->htab->size * sizeof (struct sec_merge_hash_entry *);
-  array = (struct sec_merge_hash_entry **) bfd_malloc (amt);
+  amt = sinfo->htab->size * sizeof (struct bfd_suffix_sort_entry);
+  array = (struct bfd_suffix_sort_entry *) bfd_malloc (amt);
   if (array == NULL)
     goto alloc_failure;
 
-  for (e = sinfo->htab->first, a = array; e; e = e->next)
+  for (e = sinfo->htab->first, p = array; e; e = e->next)
     if (e->alignment)
       {
-	*a++ = e;
-	/* Adjust the length to not include the zero terminator.  */
-	e->len -= sinfo->htab->entsize;
+	p->string = (const unsigned char *) e->root.string;
+	/* Do not include the zero terminator.  */
+	p->len = e->len - entsize;
+	p->group = 0;
+	p->entry = e;
+	p++;
 	if (alignment != e->alignment)
 	  {
 	    if (alignment == 0)
@@ -638,22 +731,26 @@ merge_strings (struct sec_merge_info *sinfo)
 	  }
       }
 
-  sinfo->htab->size = a - array;
+  sinfo->htab->size = p - array;
   if (sinfo->htab->size != 0)
     {
-      qsort (array, (size_t) sinfo->htab->size,
-	     sizeof (struct sec_merge_hash_entry *),
-	     (alignment != (unsigned) -1 && alignment > sinfo->htab->entsize
-	      ? strrevcmp_align : strrevcmp));
+      /* If all strings have the same alignment, greater than entsize,
+	 a string can only be a suffix of those whose length is the
+	 same modulo the alignment.  Sort on that first.  */
+      if (alignment != (unsigned) -1 && alignment > entsize)
+	for (p = array; p < array + sinfo->htab->size; p++)
+	  p->group = p->len & (alignment - 1);
+
+      _bfd_suffix_sort (array, (size_t) sinfo->htab->size);
 
       /* Loop over the sorted array and merge suffixes */
-      e = *--a;
-      e->len += sinfo->htab->entsize;
-      while (--a >= array)
+      p = array + sinfo->htab->size;
+      e = (struct sec_merge_hash_entry *) (--p)->entry;
+      while (--p >= array)
 	{
-	  struct sec_merge_hash_entry *cmp = *a;
+	  struct sec_merge_hash_entry *cmp
+	    = (struct sec_merge_hash_entry *) p->entry;
 
-	  cmp->len += sinfo->htab->entsize;
 	  if (e->alignment >= cmp->alignment
 	      && !((e->len - cmp->len) & (cmp->alignment - 1))
 	      && is_suffix (e, cmp))
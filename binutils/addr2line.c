@@ -44,12 +44,20 @@ static bfd_boolean with_functions;	/* -f, show function names.  */
 static bfd_boolean do_demangle;		/* -C, demangle names.  */
 static bfd_boolean pretty_print;	/* -p, print on one line.  */
 static bfd_boolean base_names;		/* -s, strip directory names.  */
+static const char *line_index_dir;	/* --line-index, index directory.  */
 
 static int naddr;		/* Number of addresses to process.  */
 static char **addr;		/* Hex addresses to process.  */
 
 static asymbol **syms;		/* Symbol table.  */
 
+static struct bfd_line_index *line_index; /* Address to line index.  */
+
+enum option_values
+{
+  OPTION_LINE_INDEX = 150
+};
+
 static struct option long_options[] =
 {
   {"addresses", no_argument, NULL, 'a'},
@@ -58,6 +66,7 @@ static struct option long_options[] =
   {"exe", required_argument, NULL, 'e'},
   {"functions", no_argument, NULL, 'f'},
   {"inlines", no_argument, NULL, 'i'},
+  {"line-index", required_argument, NULL, OPTION_LINE_INDEX},
   {"pretty-print", no_argument, NULL, 'p'},
   {"section", required_argument, NULL, 'j'},
   {"target", required_argument, NULL, 'b'},
@@ -87,6 +96,7 @@ usage (FILE *stream, int status)
   -e --exe=<executable>  Set the input file name (default is a.out)\n\
   -i --inlines           Unwind inlined functions\n\
   -j --section=<name>    Read section-relative offsets instead of addresses\n\
+      --line-index=<dir> Keep an address to line index of the executable in <dir>\n\
   -p --pretty-print      Make the output easier to read for humans\n\
   -s --basenames         Strip directory names\n\
   -f --functions         Show function names\n\
@@ -159,6 +169,7 @@ static const char *functionname;
 static unsigned int line;
 static unsigned int discriminator;
 static bfd_boolean found;
+static bfd_boolean found_in_line_index;
 
 /* Look for an address in a section.  This is called via
    bfd_map_over_sections.  */
@@ -259,8 +270,14 @@ translate_addresses (bfd *abfd, asection *section)
         }
 
       found = FALSE;
+      found_in_line_index = FALSE;
       if (section)
 	find_offset_in_section (abfd, section);
+      else if (line_index != NULL
+	       && _bfd_elf_line_index_find_nearest_line (line_index, pc, &filename,
+						    &functionname, &line,
+						    &discriminator))
+	found = found_in_line_index = TRUE;
       else
 	bfd_map_over_sections (abfd, find_address_in_section, NULL);
 
@@ -330,6 +347,9 @@ translate_addresses (bfd *abfd, asection *section)
 		printf ("?\n");
               if (!unwind_inlines)
                 found = FALSE;
+              else if (found_in_line_index)
+                found = _bfd_elf_line_index_find_inliner_info (line_index, &filename,
+							  &functionname, &line);
               else
                 found = bfd_find_inliner_info (abfd, &filename, &functionname,
 					       &line);
@@ -399,8 +419,17 @@ process_file (const char *file_name, const char *section_name,
 
   slurp_symtab (abfd);
 
+  if (line_index_dir != NULL && section == NULL)
+    line_index = _bfd_elf_open_line_index (abfd, syms, line_index_dir);
+
   translate_addresses (abfd, section);
 
+  if (line_index != NULL)
+    {
+      _bfd_elf_close_line_index (line_index);
+      line_index = NULL;
+    }
+
   if (syms != NULL)
     {
       free (syms);
@@ -494,6 +523,9 @@ main (int argc, char **argv)
 	case 'j':
 	  section_name = optarg;
 	  break;
+	case OPTION_LINE_INDEX:
+	  line_index_dir = optarg;
+	  break;
 	default:
 	  usage (stderr, 1);
 	  break;
@@ -150,17 +150,24 @@ find_complaint (struct complaints *complaints, const char *file,
 
 static int stop_whining = 0;
 
+/* If non-NULL, the complaints issued by the current thread are
+   appended to this vector instead of being printed.  See
+   scoped_defer_complaints.  */
+
+static thread_local std::vector<deferred_complaint> *deferred_complaints;
+
 /* Print a complaint, and link the complaint block into a chain for
-   later handling.  */
+   later handling.  The complaint is identified by KEY, which is the
+   format it was issued with; FMT is the format used to print it.  */
 
-static void ATTRIBUTE_PRINTF (4, 0)
-vcomplaint (struct complaints **c, const char *file, 
-	    int line, const char *fmt,
-	    va_list args)
+static void ATTRIBUTE_PRINTF (5, 0)
+vcomplaint_1 (struct complaints **c, const char *file,
+	      int line, const char *key, const char *fmt,
+	      va_list args)
 {
   struct complaints *complaints = get_complaints (c);
   struct complain *complaint = find_complaint (complaints, file, 
-					       line, fmt);
+					       line, key);
   enum complaint_series series;
 
   gdb_assert (complaints != NULL);
@@ -179,7 +186,7 @@ vcomplaint (struct complaints **c, const char *file,
      warnings.  'fmt' is this function's printf-format parameter, so
      the compiler can assume the passed in argument is a literal
      string somewhere up the call chain.  */
-  gdb_assert (complaint->fmt == fmt);
+  gdb_assert (complaint->fmt == key);
 
   if (complaint->file != NULL)
     internal_vwarning (complaint->file, complaint->line, fmt, args);
@@ -238,6 +245,59 @@ vcomplaint (struct complaints **c, const char *file,
   gdb_flush (gdb_stderr);
 }
 
+/* Print a complaint, or save it if complaints are deferred.  */
+
+static void ATTRIBUTE_PRINTF (4, 0)
+vcomplaint (struct complaints **c, const char *file,
+	    int line, const char *fmt,
+	    va_list args)
+{
+  if (deferred_complaints != NULL)
+    {
+      char *msg = xstrvprintf (fmt, args);
+
+      deferred_complaints->push_back ({ c, file, line, fmt, msg });
+      xfree (msg);
+      return;
+    }
+
+  vcomplaint_1 (c, file, line, fmt, fmt, args);
+}
+
+/* Issue the formatted complaint of a deferred_complaint, identified
+   by KEY.  */
+
+static void ATTRIBUTE_PRINTF (5, 6)
+reissue_complaint (struct complaints **c, const char *file,
+		   int line, const char *key, const char *fmt, ...)
+{
+  va_list args;
+
+  va_start (args, fmt);
+  vcomplaint_1 (c, file, line, key, fmt, args);
+  va_end (args);
+}
+
+scoped_defer_complaints::scoped_defer_complaints
+  (std::vector<deferred_complaint> *vec)
+  : m_saved (deferred_complaints)
+{
+  deferred_complaints = vec;
+}
+
+scoped_defer_complaints::~scoped_defer_complaints ()
+{
+  deferred_complaints = m_saved;
+}
+
+void
+reissue_complaints (const std::vector<deferred_complaint> &vec)
+{
+  for (const deferred_complaint &dc : vec)
+    reissue_complaint (dc.complaints, dc.file, dc.line, dc.fmt,
+		       "%s", dc.message.c_str ());
+}
+
 void
 complaint (struct complaints **complaints, const char *fmt, ...)
 {
@@ -48,5 +48,42 @@ extern void internal_complaint (struct complaints **complaints,
 extern void clear_complaints (struct complaints **complaints,
 			      int less_verbose, int noisy);
 
+/* A complaint that was issued while complaints were deferred.  */
+
+struct deferred_complaint
+{
+  struct complaints **complaints;
+  const char *file;
+  int line;
+  const char *fmt;
+
+  /* The complaint, formatted.  */
+  std::string message;
+};
+
+/* While an object of this type exists, the complaints issued by the
+   current thread are appended to a vector instead of being printed.
+   Threads other than the main thread must use this; the main thread
+   then issues the complaints with reissue_complaints.  */
+
+class scoped_defer_complaints
+{
+public:
+  explicit scoped_defer_complaints (std::vector<deferred_complaint> *vec);
+  ~scoped_defer_complaints ();
+
+  /* Disable copy.  */
+  scoped_defer_complaints (const scoped_defer_complaints &) = delete;
+  void operator= (const scoped_defer_complaints &) = delete;
+
+private:
+  std::vector<deferred_complaint> *m_saved;
+};
+
+/* Issue the complaints in VEC, in order, as if they had just been
+   issued by the current thread.  */
+
+extern void reissue_complaints (const std::vector<deferred_complaint> &vec);
+
 
 #endif /* !defined (COMPLAINTS_H) */
@@ -23,7 +23,8 @@
 #include "gdbcore.h"
 #include "target-dcache.h"
 #include "inferior.h"
-#include "splay-tree.h"
+#include "common/byte-vector.h"
+#include <algorithm>
 
 /* Commands with a prefix of `{set,show} dcache'.  */
 static struct cmd_list_element *dcache_set_list = NULL;
@@ -42,19 +43,26 @@ static struct cmd_list_element *dcache_show_list = NULL;
    significantly.  This is most useful when accessing a large amount
    of data, such as when performing a backtrace.
 
-   The cache is a splay tree along with a linked list for replacement.
-   Each block caches a LINE_SIZE area of memory.  Within each line we
+   The cache is set-associative: a line can only be stored in one of
+   the ASSOCIATIVITY ways of the set selected by its address, and the
+   least recently used way of that set is evicted to make room for it.
+   The lines and their data are kept in two flat arrays, so looking up
+   an address only scans a handful of adjacent entries.
+
+   Each line caches a LINE_SIZE area of memory.  Within each line we
    remember the address of the line (which must be a multiple of
    LINE_SIZE) and the actual data block.
 
-   Lines are only allocated as needed, so DCACHE_SIZE really specifies the
-   *maximum* number of lines in the cache.
+   When a read misses, the lines the request still needs are read from
+   the target in one go.  If the access is sequential (the line that
+   missed immediately follows the last line read from the target), the
+   following PREFETCH lines are read along with it; streaming accesses
+   such as a backtrace or a large "x" command then need far fewer
+   target round trips.
 
    At present, the cache is write-through rather than writeback: as soon
    as data is written to the cache, it is also immediately written to
-   the target.  Therefore, cache lines are never "dirty".  Whether a given
-   line is valid or not depends on where it is stored in the dcache_struct;
-   there is no per-block valid flag.  */
+   the target.  Therefore, cache lines are never "dirty".  */
 
 /* NOTE: Interaction of dcache and memory region attributes
 
@@ -69,7 +77,10 @@ static struct cmd_list_element *dcache_show_list = NULL;
    the last bit of the .text segment and the first bit of the .data
    segment fall within the same dcache page with a ro/cacheable memory
    region defined for the .text segment and a rw/non-cacheable memory
-   region defined for the .data segment.  */
+   region defined for the .data segment.
+
+   Lines are never read ahead past the end of the memory region of the
+   line that was requested.  */
 
 /* The maximum number of lines stored.  The total size of the cache is
    equal to DCACHE_SIZE times LINE_SIZE.  */
@@ -82,6 +93,17 @@ static unsigned dcache_size = DCACHE_DEFAULT_SIZE;
 #define DCACHE_DEFAULT_LINE_SIZE 64
 static unsigned dcache_line_size = DCACHE_DEFAULT_LINE_SIZE;
 
+/* The number of ways of each set.  */
+#define DCACHE_DEFAULT_ASSOCIATIVITY 4
+static unsigned dcache_associativity = DCACHE_DEFAULT_ASSOCIATIVITY;
+
+/* The number of lines read ahead on sequential accesses.  */
+#define DCACHE_DEFAULT_PREFETCH 8
+static unsigned dcache_prefetch = DCACHE_DEFAULT_PREFETCH;
+
+/* The maximum number of lines read from the target at once.  */
+#define DCACHE_MAX_READ_LINES 64
+
 /* Each cache block holds LINE_SIZE bytes of data
    starting at a multiple-of-LINE_SIZE address.  */
 
@@ -91,33 +113,51 @@ static unsigned dcache_line_size = DCACHE_DEFAULT_LINE_SIZE;
 
 struct dcache_block
 {
-  /* For least-recently-allocated and free lists.  */
-  struct dcache_block *prev;
-  struct dcache_block *next;
-
   CORE_ADDR addr;		/* address of data */
+  ULONGEST lru;			/* dcache clock at the last use */
   int refs;			/* # hits */
-  gdb_byte data[1];		/* line_size bytes at given address */
+  unsigned int valid : 1;	/* the line holds data */
+  unsigned int prefetched : 1;	/* read ahead, not used yet */
 };
 
 struct dcache_struct
 {
-  splay_tree tree;
-  struct dcache_block *oldest; /* least-recently-allocated list.  */
+  /* The lines, grouped by set: way WAY of set SET is
+     BLOCKS[SET * ASSOC + WAY].  NULL until the first line is
+     allocated.  */
+  struct dcache_block *blocks;
+
+  /* The data of the lines; the data of BLOCKS[I] is at
+     DATA + I * LINE_SIZE.  */
+  gdb_byte *data;
 
-  /* The free list is maintained identically to OLDEST to simplify
-     the code: we only need one set of accessors.  */
-  struct dcache_block *freelist;
+  /* The geometry BLOCKS and DATA were allocated with.  */
+  unsigned n_sets;
+  unsigned assoc;
 
   /* The number of in-use lines in the cache.  */
   int size;
   CORE_ADDR line_size;  /* current line_size.  */
 
+  /* Incremented on each use of a line, for LRU replacement.  */
+  ULONGEST clock;
+
+  /* The address of the line following the last line read from the
+     target.  A miss on it means the memory is read sequentially.  */
+  CORE_ADDR stream_next;
+
+  /* Statistics, kept across invalidations.  */
+  ULONGEST hits;
+  ULONGEST misses;
+  ULONGEST prefetched;
+  ULONGEST prefetch_hits;
+  ULONGEST target_reads;
+
   /* The ptid of last inferior to use cache or null_ptid.  */
   ptid_t ptid;
 };
 
-typedef void (block_func) (struct dcache_block *block, void *param);
+static struct dcache_block *dcache_lookup (DCACHE *dcache, CORE_ADDR addr);
 
 static struct dcache_block *dcache_hit (DCACHE *dcache, CORE_ADDR addr);
 
@@ -136,83 +176,51 @@ show_dcache_enabled_p (struct ui_file *file, int from_tty,
   fprintf_filtered (file, _("Deprecated remotecache flag is %s.\n"), value);
 }
 
-/* Add BLOCK to circular block list BLIST, behind the block at *BLIST.
-   *BLIST is not updated (unless it was previously NULL of course).
-   This is for the least-recently-allocated list's sake:
-   BLIST points to the oldest block.
-   ??? This makes for poor cache usage of the free list,
-   but is it measurable?  */
+/* Return the data of line DB.  */
 
-static void
-append_block (struct dcache_block **blist, struct dcache_block *block)
+static gdb_byte *
+dcache_block_data (DCACHE *dcache, struct dcache_block *db)
 {
-  if (*blist)
-    {
-      block->next = *blist;
-      block->prev = (*blist)->prev;
-      block->prev->next = block;
-      (*blist)->prev = block;
-      /* We don't update *BLIST here to maintain the invariant that for the
-	 least-recently-allocated list *BLIST points to the oldest block.  */
-    }
-  else
-    {
-      block->next = block;
-      block->prev = block;
-      *blist = block;
-    }
+  return dcache->data + (db - dcache->blocks) * dcache->line_size;
 }
 
-/* Remove BLOCK from circular block list BLIST.  */
+/* Return the first way of the set that the line containing ADDR maps
+   to.  */
 
-static void
-remove_block (struct dcache_block **blist, struct dcache_block *block)
+static struct dcache_block *
+dcache_set (DCACHE *dcache, CORE_ADDR addr)
 {
-  if (block->next == block)
-    {
-      *blist = NULL;
-    }
-  else
-    {
-      block->next->prev = block->prev;
-      block->prev->next = block->next;
-      /* If we removed the block *BLIST points to, shift it to the next block
-	 to maintain the invariant that for the least-recently-allocated list
-	 *BLIST points to the oldest block.  */
-      if (*blist == block)
-	*blist = block->next;
-    }
+  ULONGEST line = addr / dcache->line_size;
+
+  return &dcache->blocks[(line % dcache->n_sets) * dcache->assoc];
 }
 
-/* Iterate over all elements in BLIST, calling FUNC.
-   PARAM is passed to FUNC.
-   FUNC may remove the block it's passed, but only that block.  */
+/* Free the lines of DCACHE.  */
 
 static void
-for_each_block (struct dcache_block **blist, block_func *func, void *param)
+dcache_free_lines (DCACHE *dcache)
 {
-  struct dcache_block *db;
-
-  if (*blist == NULL)
-    return;
-
-  db = *blist;
-  do
-    {
-      struct dcache_block *next = db->next;
-
-      func (db, param);
-      db = next;
-    }
-  while (*blist && db != *blist);
+  xfree (dcache->blocks);
+  xfree (dcache->data);
+  dcache->blocks = NULL;
+  dcache->data = NULL;
+  dcache->size = 0;
 }
 
-/* BLOCK_FUNC routine for dcache_free.  */
+/* Allocate the lines of DCACHE according to the current settings.  */
 
 static void
-free_block (struct dcache_block *block, void *param)
+dcache_allocate_lines (DCACHE *dcache)
 {
-  xfree (block);
+  dcache->assoc = std::min (dcache_associativity, dcache_size);
+  dcache->n_sets = dcache_size / dcache->assoc;
+  dcache->line_size = dcache_line_size;
+
+  size_t n_lines = (size_t) dcache->n_sets * dcache->assoc;
+
+  dcache->blocks = XCNEWVEC (struct dcache_block, n_lines);
+  dcache->data = (gdb_byte *) xmalloc (n_lines * dcache->line_size);
+  dcache->size = 0;
 }
 
 /* Free a data cache.  */
@@ -220,46 +228,38 @@ free_block (struct dcache_block *block, void *param)
 void
 dcache_free (DCACHE *dcache)
 {
-  splay_tree_delete (dcache->tree);
-  for_each_block (&dcache->oldest, free_block, NULL);
-  for_each_block (&dcache->freelist, free_block, NULL);
+  dcache_free_lines (dcache);
   xfree (dcache);
 }
 
-
-/* BLOCK_FUNC function for dcache_invalidate.
-   This doesn't remove the block from the oldest list on purpose.
-   dcache_invalidate will do it later.  */
-
-static void
-invalidate_block (struct dcache_block *block, void *param)
-{
-  DCACHE *dcache = (DCACHE *) param;
-
-  splay_tree_remove (dcache->tree, (splay_tree_key) block->addr);
-  append_block (&dcache->freelist, block);
-}
-
 /* Free all the data cache blocks, thus discarding all cached data.  */
 
 void
 dcache_invalidate (DCACHE *dcache)
 {
-  for_each_block (&dcache->oldest, invalidate_block, dcache);
-
-  dcache->oldest = NULL;
   dcache->size = 0;
   dcache->ptid = null_ptid;
+  dcache->stream_next = 0;
 
-  if (dcache->line_size != dcache_line_size)
+  if (dcache->blocks == NULL)
+    dcache->line_size = dcache_line_size;
+  else if (dcache->line_size != dcache_line_size
+	   || dcache->assoc != std::min (dcache_associativity, dcache_size)
+	   || dcache->n_sets != dcache_size / dcache->assoc)
     {
-      /* We've been asked to use a different line size.
-	 All of our freelist blocks are now the wrong size, so free them.  */
-
-      for_each_block (&dcache->freelist, free_block, dcache);
-      dcache->freelist = NULL;
+      /* We've been asked to use a different geometry.  All of our
+	 lines are now the wrong size, so free them; they are
+	 allocated again when needed.  */
+      dcache_free_lines (dcache);
       dcache->line_size = dcache_line_size;
     }
+  else
+    {
+      size_t n_lines = (size_t) dcache->n_sets * dcache->assoc;
+
+      for (size_t i = 0; i < n_lines; ++i)
+	dcache->blocks[i].valid = 0;
+    }
 }
 
 /* Invalidate the line associated with ADDR.  */
@@ -267,54 +267,65 @@ dcache_invalidate (DCACHE *dcache)
 static void
 dcache_invalidate_line (DCACHE *dcache, CORE_ADDR addr)
 {
-  struct dcache_block *db = dcache_hit (dcache, addr);
+  struct dcache_block *db = dcache_lookup (dcache, addr);
 
   if (db)
     {
-      splay_tree_remove (dcache->tree, (splay_tree_key) db->addr);
-      remove_block (&dcache->oldest, db);
-      append_block (&dcache->freelist, db);
+      db->valid = 0;
       --dcache->size;
     }
 }
 
+/* If ADDR is present in the dcache, return the address of the block
+   containing it, without counting it as a use.  Otherwise return
+   NULL.  */
+
+static struct dcache_block *
+dcache_lookup (DCACHE *dcache, CORE_ADDR addr)
+{
+  struct dcache_block *db;
+  unsigned way;
+
+  if (dcache->blocks == NULL)
+    return NULL;
+
+  addr = MASK (dcache, addr);
+  db = dcache_set (dcache, addr);
+  for (way = 0; way < dcache->assoc; ++way, ++db)
+    if (db->valid && db->addr == addr)
+      return db;
+
+  return NULL;
+}
+
 /* If addr is present in the dcache, return the address of the block
    containing it.  Otherwise return NULL.  */
 
 static struct dcache_block *
 dcache_hit (DCACHE *dcache, CORE_ADDR addr)
 {
-  struct dcache_block *db;
-
-  splay_tree_node node = splay_tree_lookup (dcache->tree,
-					    (splay_tree_key) MASK (dcache, addr));
+  struct dcache_block *db = dcache_lookup (dcache, addr);
 
-  if (!node)
+  if (db == NULL)
     return NULL;
 
-  db = (struct dcache_block *) node->value;
   db->refs++;
+  db->lru = ++dcache->clock;
   return db;
 }
 
-/* Fill a cache line from target memory.
-   The result is 1 for success, 0 if the (entire) cache line
-   wasn't readable.  */
+/* Read LEN bytes of target memory at MEMADDR into MYADDR, splitting
+   the read by memory region.  The result is 1 for success, 0 if the
+   memory wasn't (entirely) readable.  */
 
 static int
-dcache_read_line (DCACHE *dcache, struct dcache_block *db)
+dcache_read_memory (DCACHE *dcache, CORE_ADDR memaddr, gdb_byte *myaddr,
+		    int len)
 {
-  CORE_ADDR memaddr;
-  gdb_byte *myaddr;
-  int len;
   int res;
   int reg_len;
   struct mem_region *region;
 
-  len = dcache->line_size;
-  memaddr = db->addr;
-  myaddr  = db->data;
-
   while (len > 0)
     {
       /* Don't overrun if this block is right at the end of the region.  */
@@ -334,6 +345,7 @@ dcache_read_line (DCACHE *dcache, struct dcache_block *db)
 	  continue;
 	}
 
+      dcache->target_reads++;
       res = target_read_raw_memory (memaddr, myaddr, reg_len);
       if (res != 0)
 	return 0;
@@ -346,67 +358,131 @@ dcache_read_line (DCACHE *dcache, struct dcache_block *db)
   return 1;
 }
 
+/* Fill a cache line from target memory.
+   The result is 1 for success, 0 if the (entire) cache line
+   wasn't readable.  */
+
+static int
+dcache_read_line (DCACHE *dcache, struct dcache_block *db)
+{
+  return dcache_read_memory (dcache, db->addr, dcache_block_data (dcache, db),
+			     dcache->line_size);
+}
+
 /* Get a free cache block, put or keep it on the valid list,
    and return its address.  */
 
 static struct dcache_block *
 dcache_alloc (DCACHE *dcache, CORE_ADDR addr)
 {
-  struct dcache_block *db;
+  struct dcache_block *db, *victim;
+  unsigned way;
 
-  if (dcache->size >= dcache_size)
-    {
-      /* Evict the least recently allocated line.  */
-      db = dcache->oldest;
-      remove_block (&dcache->oldest, db);
+  if (dcache->blocks == NULL)
+    dcache_allocate_lines (dcache);
 
-      splay_tree_remove (dcache->tree, (splay_tree_key) db->addr);
-    }
-  else
+  /* Use a free way of the set if there is one, otherwise evict the
+     least recently used line.  */
+  db = dcache_set (dcache, MASK (dcache, addr));
+  victim = db;
+  for (way = 0; way < dcache->assoc; ++way, ++db)
     {
-      db = dcache->freelist;
-      if (db)
-	remove_block (&dcache->freelist, db);
-      else
-	db = ((struct dcache_block *)
-	      xmalloc (offsetof (struct dcache_block, data)
-		       + dcache->line_size));
-
-      dcache->size++;
+      if (!db->valid)
+	{
+	  victim = db;
+	  dcache->size++;
+	  break;
+	}
+      if (db->lru < victim->lru)
+	victim = db;
     }
 
-  db->addr = MASK (dcache, addr);
-  db->refs = 0;
+  victim->addr = MASK (dcache, addr);
+  victim->refs = 0;
+  victim->lru = ++dcache->clock;
+  victim->valid = 1;
+  victim->prefetched = 0;
 
-  /* Put DB at the end of the list, it's the newest.  */
-  append_block (&dcache->oldest, db);
+  return victim;
+}
 
-  splay_tree_insert (dcache->tree, (splay_tree_key) db->addr,
-		     (splay_tree_value) db);
+/* Read the line containing ADDR, which is not in DCACHE, from the
+   target, along with the lines following it that are not cached
+   either, up to the end of the request (WANTED lines in total) and,
+   if the access is sequential, PREFETCH more.  Return the line
+   containing ADDR, or NULL if it could not be read.  */
 
-  return db;
-}
+static struct dcache_block *
+dcache_fill (DCACHE *dcache, CORE_ADDR addr, ULONGEST wanted)
+{
+  CORE_ADDR line = MASK (dcache, addr);
+  struct mem_region *region = lookup_mem_region (line);
+  struct dcache_block *db;
+  ULONGEST n_lines, max_lines, i;
 
-/* Using the data cache DCACHE, store in *PTR the contents of the byte at
-   address ADDR in the remote machine.  
+  dcache->misses++;
 
-   Returns 1 for success, 0 for error.  */
+  if (dcache->blocks == NULL)
+    dcache_allocate_lines (dcache);
 
-static int
-dcache_peek_byte (DCACHE *dcache, CORE_ADDR addr, gdb_byte *ptr)
-{
-  struct dcache_block *db = dcache_hit (dcache, addr);
+  n_lines = wanted;
+  if (line == dcache->stream_next)
+    n_lines += dcache_prefetch;
 
-  if (!db)
+  /* Lines read together must all fit in the cache at once, and the
+     read must stay within the memory region of ADDR.  */
+  max_lines = std::min ((ULONGEST) DCACHE_MAX_READ_LINES,
+			(ULONGEST) dcache->n_sets * dcache->assoc);
+  n_lines = std::min (n_lines, max_lines);
+  for (i = 1; i < n_lines; ++i)
     {
-      db = dcache_alloc (dcache, addr);
+      CORE_ADDR next = line + i * dcache->line_size;
 
-      if (!dcache_read_line (dcache, db))
-         return 0;
+      if (next < line
+	  || (region->hi != 0 && next + dcache->line_size > region->hi)
+	  || dcache_lookup (dcache, next) != NULL)
+	break;
     }
+  n_lines = i;
 
-  *ptr = db->data[XFORM (dcache, addr)];
-  return 1;
+  if (n_lines > 1)
+    {
+      gdb::byte_vector buf (n_lines * dcache->line_size);
+
+      if (dcache_read_memory (dcache, line, buf.data (), buf.size ()))
+	{
+	  /* Allocate the requested line last, so that it is the most
+	     recently used line and the others can't evict it.  */
+	  for (i = n_lines; i-- > 0; )
+	    {
+	      db = dcache_alloc (dcache, line + i * dcache->line_size);
+	      memcpy (dcache_block_data (dcache, db),
+		      buf.data () + i * dcache->line_size,
+		      dcache->line_size);
+	      /* Only the lines past the end of the request are read
+		 ahead; the others are about to be used.  */
+	      if (i >= wanted)
+		{
+		  db->prefetched = 1;
+		  dcache->prefetched++;
+		}
+	    }
+
+	  dcache->stream_next = line + n_lines * dcache->line_size;
+	  return db;
+	}
+
+      /* Reading ahead failed, for instance because the following
+	 lines are not mapped.  Just read the line that was asked
+	 for.  */
+    }
+
+  db = dcache_alloc (dcache, line);
+  if (!dcache_read_line (dcache, db))
+    return NULL;
+
+  dcache->stream_next = line + dcache->line_size;
+  return db;
 }
 
 /* Write the byte at PTR into ADDR in the data cache.
@@ -424,18 +500,7 @@ dcache_poke_byte (DCACHE *dcache, CORE_ADDR addr, const gdb_byte *ptr)
   struct dcache_block *db = dcache_hit (dcache, addr);
 
   if (db)
-    db->data[XFORM (dcache, addr)] = *ptr;
-}
-
-static int
-dcache_splay_tree_compare (splay_tree_key a, splay_tree_key b)
-{
-  if (a > b)
-    return 1;
-  else if (a == b)
-    return 0;
-  else
-    return -1;
+    dcache_block_data (dcache, db)[XFORM (dcache, addr)] = *ptr;
 }
 
 /* Allocate and initialize a data cache.  */
@@ -443,15 +508,8 @@ dcache_splay_tree_compare (splay_tree_key a, splay_tree_key b)
 DCACHE *
 dcache_init (void)
 {
-  DCACHE *dcache = XNEW (DCACHE);
-
-  dcache->tree = splay_tree_new (dcache_splay_tree_compare,
-				 NULL,
-				 NULL);
+  DCACHE *dcache = XCNEW (DCACHE);
 
-  dcache->oldest = NULL;
-  dcache->freelist = NULL;
-  dcache->size = 0;
   dcache->line_size = dcache_line_size;
   dcache->ptid = null_ptid;
 
@@ -480,15 +538,44 @@ dcache_read_memory_partial (struct target_ops *ops, DCACHE *dcache,
       dcache->ptid = inferior_ptid;
     }
 
-  for (i = 0; i < len; i++)
+  i = 0;
+  while (i < len)
     {
-      if (!dcache_peek_byte (dcache, memaddr + i, myaddr + i))
+      CORE_ADDR addr = memaddr + i;
+      ULONGEST offset = XFORM (dcache, addr);
+      ULONGEST chunk = std::min<ULONGEST> (len - i, dcache->line_size - offset);
+      struct dcache_block *db = dcache_hit (dcache, addr);
+
+      if (db != NULL)
 	{
-	  /* That failed.  Discard its cache line so we don't have a
-	     partially read line.  */
-	  dcache_invalidate_line (dcache, memaddr + i);
-	  break;
+	  /* The first read of a line read ahead is a hit on the read
+	     ahead, not on data the cache already held.  */
+	  if (db->prefetched)
+	    {
+	      db->prefetched = 0;
+	      dcache->prefetch_hits++;
+	    }
+	  else
+	    dcache->hits++;
 	}
+      else
+	{
+	  /* The number of lines the rest of the request spans.  */
+	  ULONGEST wanted = ((offset + len - i + dcache->line_size - 1)
+			     / dcache->line_size);
+
+	  db = dcache_fill (dcache, addr, wanted);
+	  if (db == NULL)
+	    {
+	      /* That failed.  Discard its cache line so we don't have a
+		 partially read line.  */
+	      dcache_invalidate_line (dcache, addr);
+	      break;
+	    }
+	}
+
+      memcpy (myaddr + i, dcache_block_data (dcache, db) + offset, chunk);
+      i += chunk;
     }
 
   if (i == 0)
@@ -536,14 +623,38 @@ dcache_update (DCACHE *dcache, enum target_xfer_status status,
       }
 }
 
+/* Return the lines of DCACHE that hold data, sorted by address.  */
+
+static std::vector<struct dcache_block *>
+dcache_sorted_lines (DCACHE *dcache)
+{
+  std::vector<struct dcache_block *> lines;
+
+  if (dcache->blocks != NULL)
+    {
+      size_t n_lines = (size_t) dcache->n_sets * dcache->assoc;
+
+      for (size_t i = 0; i < n_lines; ++i)
+	if (dcache->blocks[i].valid)
+	  lines.push_back (&dcache->blocks[i]);
+    }
+
+  std::sort (lines.begin (), lines.end (),
+	     [] (const struct dcache_block *a, const struct dcache_block *b)
+	     {
+	       return a->addr < b->addr;
+	     });
+  return lines;
+}
+
 /* Print DCACHE line INDEX.  */
 
 static void
 dcache_print_line (DCACHE *dcache, int index)
 {
-  splay_tree_node n;
   struct dcache_block *db;
-  int i, j;
+  gdb_byte *data;
+  int j;
 
   if (dcache == NULL)
     {
@@ -551,29 +662,23 @@ dcache_print_line (DCACHE *dcache, int index)
       return;
     }
 
-  n = splay_tree_min (dcache->tree);
+  std::vector<struct dcache_block *> lines = dcache_sorted_lines (dcache);
 
-  for (i = index; i > 0; --i)
-    {
-      if (!n)
-	break;
-      n = splay_tree_successor (dcache->tree, n->key);
-    }
-
-  if (!n)
+  if (index >= lines.size ())
     {
       printf_filtered (_("No such cache line exists.\n"));
       return;
     }
-    
-  db = (struct dcache_block *) n->value;
+
+  db = lines[index];
+  data = dcache_block_data (dcache, db);
 
   printf_filtered (_("Line %d: address %s [%d hits]\n"),
 		   index, paddress (target_gdbarch (), db->addr), db->refs);
 
   for (j = 0; j < dcache->line_size; j++)
     {
-      printf_filtered ("%02x ", db->data[j]);
+      printf_filtered ("%02x ", data[j]);
 
       /* Print a newline every 16 bytes (48 characters).  */
       if ((j % 16 == 15) && (j != dcache->line_size - 1))
@@ -587,8 +692,8 @@ dcache_print_line (DCACHE *dcache, int index)
 static void
 dcache_info_1 (DCACHE *dcache, char *exp)
 {
-  splay_tree_node n;
   int i, refcount;
+  unsigned n_lines;
 
   if (exp)
     {
@@ -605,8 +710,18 @@ dcache_info_1 (DCACHE *dcache, char *exp)
       return;
     }
 
+  /* The number of lines is rounded down to a whole number of sets.  */
+  if (dcache != NULL && dcache->blocks != NULL)
+    n_lines = dcache->n_sets * dcache->assoc;
+  else
+    {
+      unsigned assoc = std::min (dcache_associativity, dcache_size);
+
+      n_lines = dcache_size / assoc * assoc;
+    }
+
   printf_filtered (_("Dcache %u lines of %u bytes each.\n"),
-		   dcache_size,
+		   n_lines,
 		   dcache ? (unsigned) dcache->line_size
 		   : dcache_line_size);
 
@@ -619,24 +734,28 @@ dcache_info_1 (DCACHE *dcache, char *exp)
   printf_filtered (_("Contains data for %s\n"),
 		   target_pid_to_str (dcache->ptid));
 
-  refcount = 0;
+  if (dcache->blocks != NULL)
+    printf_filtered (_("Organized as %u sets of %u lines.\n"),
+		     dcache->n_sets, dcache->assoc);
 
-  n = splay_tree_min (dcache->tree);
+  refcount = 0;
   i = 0;
 
-  while (n)
+  for (struct dcache_block *db : dcache_sorted_lines (dcache))
     {
-      struct dcache_block *db = (struct dcache_block *) n->value;
-
       printf_filtered (_("Line %d: address %s [%d hits]\n"),
 		       i, paddress (target_gdbarch (), db->addr), db->refs);
       i++;
       refcount += db->refs;
-
-      n = splay_tree_successor (dcache->tree, n->key);
     }
 
   printf_filtered (_("Cache state: %d active lines, %d hits\n"), i, refcount);
+  printf_filtered (_("Total: %s hits, %s misses, %s target reads\n"),
+		   pulongest (dcache->hits), pulongest (dcache->misses),
+		   pulongest (dcache->target_reads));
+  printf_filtered (_("Read ahead: %s lines, %s of them used\n"),
+		   pulongest (dcache->prefetched),
+		   pulongest (dcache->prefetch_hits));
 }
 
 static void
@@ -671,6 +790,18 @@ set_dcache_line_size (char *args, int from_tty,
   target_dcache_invalidate ();
 }
 
+static void
+set_dcache_associativity (char *args, int from_tty,
+			  struct cmd_list_element *c)
+{
+  if (dcache_associativity == 0)
+    {
+      dcache_associativity = DCACHE_DEFAULT_ASSOCIATIVITY;
+      error (_("Dcache associativity must be greater than 0."));
+    }
+  target_dcache_invalidate ();
+}
+
 static void
 set_dcache_command (char *arg, int from_tty)
 {
@@ -704,7 +835,8 @@ exists only for compatibility reasons."),
 	    _("\
 Print information on the dcache performance.\n\
 With no arguments, this command prints the cache configuration and a\n\
-summary of each line in the cache.  Use \"info dcache <lineno> to dump\"\n\
+summary of each line in the cache, followed by hit, miss and\n\
+read-ahead counts.  Use \"info dcache <lineno> to dump\"\n\
 the contents of a given line."));
 
   add_prefix_cmd ("dcache", class_obscure, set_dcache_command, _("\
@@ -730,4 +862,24 @@ Show number of dcache lines."),
 			     set_dcache_size,
 			     NULL,
 			     &dcache_set_list, &dcache_show_list);
+  add_setshow_zuinteger_cmd ("associativity", class_obscure,
+			     &dcache_associativity, _("\
+Set number of dcache lines per set."), _("\
+Show number of dcache lines per set."), _("\
+A line of memory can only be cached in one of the lines of the set\n\
+selected by its address; the least recently used line of the set is\n\
+replaced when a new line is read."),
+			     set_dcache_associativity,
+			     NULL,
+			     &dcache_set_list, &dcache_show_list);
+  add_setshow_zuinteger_cmd ("prefetch", class_obscure,
+			     &dcache_prefetch, _("\
+Set number of dcache lines read ahead."), _("\
+Show number of dcache lines read ahead."), _("\
+When memory is read sequentially, this many lines following the\n\
+requested ones are read from the target along with them.\n\
+Zero disables reading ahead."),
+			     NULL,
+			     NULL,
+			     &dcache_set_list, &dcache_show_list);
 }
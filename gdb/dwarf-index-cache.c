@@ -0,0 +1,520 @@
+/* Caching of GDB/DWARF index files.
+
+   Copyright (C) 2017 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "dwarf-index-cache.h"
+#include "bfd.h"
+#include "command.h"
+#include "gdbcmd.h"
+#include "filenames.h"
+#include "filestuff.h"
+#include <algorithm>
+#include <sys/stat.h>
+#include <fcntl.h>
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
+#if CXX_STD_THREAD
+#include <thread>
+#endif
+
+/* Whether the index cache is used.  */
+static int index_cache_enabled = 0;
+
+/* The directory holding the cached index files.  NULL until the
+   default has been computed or the user set it.  */
+static char *index_cache_directory;
+
+/* Print debugging messages about the index cache.  */
+static int debug_index_cache = 0;
+
+/* Number of lookups that found, respectively did not find, an index
+   in the cache, and number of indices stored, in this session.  */
+static unsigned int index_cache_hits;
+static unsigned int index_cache_misses;
+static unsigned int index_cache_stores;
+
+/* Command lists for "set/show index-cache".  */
+static struct cmd_list_element *set_index_cache_prefix_list;
+static struct cmd_list_element *show_index_cache_prefix_list;
+
+index_cache_resource::~index_cache_resource ()
+{
+#ifdef HAVE_MMAP
+  if (m_mapped)
+    {
+      int res = munmap ((void *) m_data, m_size);
+
+      gdb_assert (res == 0);
+      return;
+    }
+#endif
+
+  xfree ((void *) m_data);
+}
+
+/* Return the directory to use for the cache, computing the default
+   ($XDG_CACHE_HOME/gdb, or $HOME/.cache/gdb) the first time.  Return
+   NULL if no directory could be found.  */
+
+static const char *
+get_index_cache_directory ()
+{
+  if (index_cache_directory != NULL)
+    return index_cache_directory;
+
+  const char *xdg = getenv ("XDG_CACHE_HOME");
+  if (xdg != NULL && *xdg != '\0')
+    index_cache_directory = concat (xdg, SLASH_STRING, "gdb", (char *) NULL);
+  else
+    {
+      const char *home = getenv ("HOME");
+
+      if (home == NULL || *home == '\0')
+	return NULL;
+      index_cache_directory = concat (home, SLASH_STRING, ".cache",
+				      SLASH_STRING, "gdb", (char *) NULL);
+    }
+
+  return index_cache_directory;
+}
+
+/* Create directory DIR and its missing parents.  Return true on
+   success.  */
+
+static bool
+make_cache_directory (const char *dir)
+{
+  std::string path (dir);
+
+  for (size_t i = 1; i <= path.size (); ++i)
+    {
+      if (i < path.size () && !IS_DIR_SEPARATOR (path[i]))
+	continue;
+
+      std::string component = path.substr (0, i);
+      if (mkdir (component.c_str (), S_IRWXU) != 0 && errno != EEXIST)
+	return false;
+    }
+
+  return true;
+}
+
+/* Return the base name (without INDEX_SUFFIX) of the cache
+   file for BUILD_ID.  */
+
+static std::string
+build_id_to_basename (const struct bfd_build_id *build_id)
+{
+  std::string result;
+
+  for (bfd_size_type i = 0; i < build_id->size; ++i)
+    {
+      char buf[3];
+
+      xsnprintf (buf, sizeof (buf), "%02x", (unsigned) build_id->data[i]);
+      result += buf;
+    }
+
+  return result;
+}
+
+/* See dwarf-index-cache.h.  */
+
+bool
+index_cache_enabled_p ()
+{
+  return index_cache_enabled;
+}
+
+/* See dwarf-index-cache.h.  */
+
+std::unique_ptr<index_cache_resource>
+index_cache_lookup (const struct bfd_build_id *build_id)
+{
+  const char *dir = get_index_cache_directory ();
+
+  if (!index_cache_enabled || dir == NULL || build_id == NULL)
+    return NULL;
+
+  std::string filename = (std::string (dir) + SLASH_STRING
+			  + build_id_to_basename (build_id) + INDEX_SUFFIX);
+
+  int fd = gdb_open_cloexec (filename.c_str (), O_RDONLY | O_BINARY, 0);
+  if (fd < 0)
+    {
+      if (debug_index_cache)
+	fprintf_unfiltered (gdb_stdlog, "index-cache: no file %s\n",
+			    filename.c_str ());
+      ++index_cache_misses;
+      return NULL;
+    }
+
+  struct cleanup *back_to = make_cleanup_close (fd);
+  struct stat st;
+  if (fstat (fd, &st) != 0 || st.st_size == 0)
+    {
+      do_cleanups (back_to);
+      ++index_cache_misses;
+      return NULL;
+    }
+
+  size_t size = st.st_size;
+  std::unique_ptr<index_cache_resource> result;
+
+#ifdef HAVE_MMAP
+  void *addr = mmap (NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (addr != MAP_FAILED)
+    result.reset (new index_cache_resource ((const gdb_byte *) addr,
+					    size, true));
+  else
+#endif
+    {
+      gdb_byte *buf = (gdb_byte *) xmalloc (size);
+
+      if (read (fd, buf, size) == (ssize_t) size)
+	result.reset (new index_cache_resource (buf, size, false));
+      else
+	xfree (buf);
+    }
+
+  do_cleanups (back_to);
+
+  if (result == NULL)
+    {
+      ++index_cache_misses;
+      return NULL;
+    }
+
+  if (debug_index_cache)
+    fprintf_unfiltered (gdb_stdlog, "index-cache: using %s\n",
+			filename.c_str ());
+  ++index_cache_hits;
+  return result;
+}
+
+/* An index being stored in the cache.  */
+
+struct index_cache_writer
+{
+  /* The objfile whose index this is.  */
+  struct objfile *objfile;
+
+  /* The cache directory.  */
+  std::string dir;
+
+  /* The base name of the temporary file, and the full names of the
+     temporary and of the final file.  */
+  std::string tmp_basename;
+  std::string tmp_name;
+  std::string filename;
+
+  /* The function that writes the index.  */
+  std::function<void (const char *, const char *)> write;
+
+  /* Set once the index has been written and renamed into place.  */
+  bool stored = false;
+
+  /* If the index couldn't be stored, the reason why.  */
+  std::string error_message;
+
+#if CXX_STD_THREAD
+  /* The thread writing the index, if it is written in the
+     background.  */
+  std::thread thread;
+#endif
+};
+
+/* The indices being stored, in the order they were started.  They
+   are only accounted for (and reported) by index_cache_wait and
+   index_cache_wait_all, on the main thread.  */
+static std::vector<std::unique_ptr<index_cache_writer>> index_cache_writers;
+
+/* Write the index described by WRITER.  This may run on a separate
+   thread, so it must not touch any global state.  */
+
+static void
+index_cache_write (index_cache_writer *writer)
+{
+  const char *dir = writer->dir.c_str ();
+
+  TRY
+    {
+      if (!make_cache_directory (dir))
+	error (_("Can't create directory `%s': %s"), dir,
+	       safe_strerror (errno));
+
+      writer->write (dir, writer->tmp_basename.c_str ());
+
+      if (rename (writer->tmp_name.c_str (), writer->filename.c_str ()) != 0)
+	{
+	  int save_errno = errno;
+
+	  unlink (writer->tmp_name.c_str ());
+	  error (_("Can't rename `%s' to `%s': %s"),
+		 writer->tmp_name.c_str (), writer->filename.c_str (),
+		 safe_strerror (save_errno));
+	}
+
+      writer->stored = true;
+    }
+  CATCH (except, RETURN_MASK_ERROR)
+    {
+      writer->error_message = except.message;
+    }
+  END_CATCH
+}
+
+/* See dwarf-index-cache.h.  */
+
+void
+index_cache_store
+  (struct objfile *objfile, const struct bfd_build_id *build_id,
+   std::function<void (const char *dir, const char *basename)> write,
+   bool background)
+{
+  static unsigned int counter;
+  const char *dir = get_index_cache_directory ();
+
+  if (!index_cache_enabled || dir == NULL || build_id == NULL)
+    return;
+
+  std::unique_ptr<index_cache_writer> writer (new index_cache_writer);
+  std::string basename = build_id_to_basename (build_id);
+
+  /* Write to a file with a unique name first, and rename it only once
+     it is complete, so that a concurrent session never sees a
+     partially written index.  */
+  writer->objfile = objfile;
+  writer->dir = dir;
+  writer->tmp_basename = (basename + "." + pulongest (getpid ())
+			  + "." + pulongest (counter++));
+  writer->tmp_name = (writer->dir + SLASH_STRING + writer->tmp_basename
+		      + INDEX_SUFFIX);
+  writer->filename = writer->dir + SLASH_STRING + basename + INDEX_SUFFIX;
+  writer->write = std::move (write);
+
+#if CXX_STD_THREAD
+  if (background)
+    writer->thread = std::thread (index_cache_write, writer.get ());
+  else
+#endif
+    index_cache_write (writer.get ());
+
+  index_cache_writers.push_back (std::move (writer));
+
+  if (!background)
+    index_cache_wait (objfile);
+}
+
+/* Wait for WRITER to complete, and account for it.  */
+
+static void
+index_cache_finish (index_cache_writer *writer)
+{
+#if CXX_STD_THREAD
+  if (writer->thread.joinable ())
+    writer->thread.join ();
+#endif
+
+  if (writer->stored)
+    {
+      ++index_cache_stores;
+      if (debug_index_cache)
+	fprintf_unfiltered (gdb_stdlog, "index-cache: wrote %s\n",
+			    writer->filename.c_str ());
+    }
+  else if (debug_index_cache)
+    fprintf_unfiltered (gdb_stdlog,
+			"index-cache: couldn't write %s: %s\n",
+			writer->filename.c_str (),
+			writer->error_message.c_str ());
+}
+
+/* See dwarf-index-cache.h.  */
+
+void
+index_cache_wait (struct objfile *objfile)
+{
+  auto it = std::remove_if (index_cache_writers.begin (),
+			    index_cache_writers.end (),
+			    [=] (const std::unique_ptr<index_cache_writer> &w)
+			    {
+			      if (w->objfile != objfile)
+				return false;
+			      index_cache_finish (w.get ());
+			      return true;
+			    });
+
+  index_cache_writers.erase (it, index_cache_writers.end ());
+}
+
+/* See dwarf-index-cache.h.  */
+
+void
+index_cache_wait_all ()
+{
+  for (const auto &writer : index_cache_writers)
+    index_cache_finish (writer.get ());
+
+  index_cache_writers.clear ();
+}
+
+/* A final cleanup, so that GDB does not exit in the middle of writing
+   an index.  */
+
+static void
+index_cache_wait_cleanup (void *ignore)
+{
+  index_cache_wait_all ();
+}
+
+/* "set index-cache" handler.  */
+
+static void
+set_index_cache_command (char *arg, int from_tty)
+{
+  printf_unfiltered (_("\
+Missing arguments.  See \"help set index-cache\" for help.\n"));
+}
+
+/* "show index-cache" handler.  */
+
+static void
+show_index_cache_command (char *arg, int from_tty)
+{
+  const char *dir = get_index_cache_directory ();
+
+  printf_unfiltered (_("The index cache is currently %s.\n"),
+		     index_cache_enabled ? _("enabled") : _("disabled"));
+  printf_unfiltered (_("The directory of the index cache is \"%s\".\n"),
+		     dir != NULL ? dir : "");
+}
+
+/* "set index-cache on" handler.  */
+
+static void
+set_index_cache_on_command (char *arg, int from_tty)
+{
+  if (arg != NULL && *arg != '\0')
+    error (_("Garbage after \"set index-cache on\"."));
+
+  index_cache_enabled = 1;
+}
+
+/* "set index-cache off" handler.  */
+
+static void
+set_index_cache_off_command (char *arg, int from_tty)
+{
+  if (arg != NULL && *arg != '\0')
+    error (_("Garbage after \"set index-cache off\"."));
+
+  index_cache_enabled = 0;
+}
+
+/* "set index-cache directory" handler.  */
+
+static void
+set_index_cache_directory_command (char *arg, int from_tty,
+				   struct cmd_list_element *element)
+{
+  /* Make sure the directory is absolute and tilde-expanded.  */
+  gdb::unique_xmalloc_ptr<char> abs (gdb_abspath (index_cache_directory));
+
+  xfree (index_cache_directory);
+  index_cache_directory = abs.release ();
+}
+
+/* "show index-cache directory" handler.  */
+
+static void
+show_index_cache_directory (struct ui_file *file, int from_tty,
+			    struct cmd_list_element *c, const char *value)
+{
+  const char *dir = get_index_cache_directory ();
+
+  fprintf_filtered (file, _("The directory of the index cache is \"%s\".\n"),
+		    dir != NULL ? dir : "");
+}
+
+/* "show index-cache stats" handler.  */
+
+static void
+show_index_cache_stats_command (char *arg, int from_tty)
+{
+  /* Account for the indices still being written.  */
+  index_cache_wait_all ();
+
+  printf_unfiltered (_("  Cache hits (this session): %u\n"),
+		     index_cache_hits);
+  printf_unfiltered (_("Cache misses (this session): %u\n"),
+		     index_cache_misses);
+  printf_unfiltered (_("Cache stores (this session): %u\n"),
+		     index_cache_stores);
+}
+
+/* Provide a prototype to silence -Wmissing-prototypes.  */
+extern initialize_file_ftype _initialize_dwarf_index_cache;
+
+void
+_initialize_dwarf_index_cache (void)
+{
+  make_final_cleanup (index_cache_wait_cleanup, NULL);
+
+  add_prefix_cmd ("index-cache", class_files, set_index_cache_command,
+		  _("Set index-cache options"), &set_index_cache_prefix_list,
+		  "set index-cache ", 0, &setlist);
+  add_prefix_cmd ("index-cache", class_files, show_index_cache_command,
+		  _("Show index-cache options"), &show_index_cache_prefix_list,
+		  "show index-cache ", 0, &showlist);
+
+  add_cmd ("on", class_files, set_index_cache_on_command,
+	   _("Enable the index cache.\n\
+When on, GDB looks in the cache for the index of each objfile whose\n\
+symbols it reads, and stores a new index there when it builds partial\n\
+symbol tables for an objfile that has none."),
+	   &set_index_cache_prefix_list);
+
+  add_cmd ("off", class_files, set_index_cache_off_command,
+	   _("Disable the index cache."), &set_index_cache_prefix_list);
+
+  add_setshow_filename_cmd ("directory", class_files, &index_cache_directory,
+			    _("Set the directory of the index cache."),
+			    _("Show the directory of the index cache."),
+			    _("\
+Index files are stored in this directory, named after the build-id of\n\
+the objfile they describe.  The default is $XDG_CACHE_HOME/gdb, or\n\
+$HOME/.cache/gdb."),
+			    set_index_cache_directory_command,
+			    show_index_cache_directory,
+			    &set_index_cache_prefix_list,
+			    &show_index_cache_prefix_list);
+
+  add_cmd ("stats", class_files, show_index_cache_stats_command,
+	   _("Show some stats about the index cache."),
+	   &show_index_cache_prefix_list);
+
+  add_setshow_boolean_cmd ("index-cache", class_maintenance,
+			   &debug_index_cache, _("\
+Set display of index-cache debug messages."), _("\
+Show display of index-cache debug messages."), _("\
+When on, GDB prints messages about index cache lookups and stores."),
+			   NULL, NULL, &setdebuglist, &showdebuglist);
+}
@@ -0,0 +1,121 @@
+/* Caching of GDB/DWARF index files.
+
+   Copyright (C) 2017 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef DWARF_INDEX_CACHE_H
+#define DWARF_INDEX_CACHE_H
+
+/* The index cache stores, for each objfile without a .gdb_index
+   section, the index GDB would have written for it with "save
+   gdb-index", under a name derived from the objfile's build-id.  A
+   later session maps that index and uses it exactly like a
+   .gdb_index section: it skips the scan of all the DIEs that builds
+   partial symbol tables, and expands a CU into a full symtab only
+   when a lookup in the index points to it.
+
+   Full symtabs themselves are not cached, neither per objfile nor per
+   CU.  They are graphs of symbols, blocks and types allocated on the
+   objfile obstack, whose addresses depend on where the objfile is
+   relocated, and which point into other CUs (DW_FORM_ref_addr,
+   imported units, type units, the dwz file) and back into the DWARF
+   itself (location expressions and dynamic type properties keep
+   pointers to their dwarf2_per_cu_data).  Storing them in a mappable
+   form would mean a second, position-independent representation of
+   all of these.  Caching the index instead keeps the part of a
+   session's start-up that does not depend on what is looked up --
+   reading every DIE -- and leaves process_full_comp_unit to run only
+   for the CUs that are actually used.  */
+
+#include <functional>
+
+struct bfd_build_id;
+struct objfile;
+
+/* The suffix of index files.  */
+#define INDEX_SUFFIX ".gdb-index"
+
+/* The contents of an index file found in the cache.  The contents
+   are mapped (or read) into memory when the object is created, and
+   stay valid until it is destroyed.  */
+
+class index_cache_resource
+{
+public:
+  index_cache_resource (const gdb_byte *data, size_t size, bool mapped)
+    : m_data (data), m_size (size), m_mapped (mapped)
+  {}
+
+  ~index_cache_resource ();
+
+  /* Disable copy.  */
+  index_cache_resource (const index_cache_resource &) = delete;
+  void operator= (const index_cache_resource &) = delete;
+
+  /* The contents of the index file.  */
+  const gdb_byte *data () const
+  { return m_data; }
+
+  /* The size of the index file, in bytes.  */
+  size_t size () const
+  { return m_size; }
+
+private:
+  const gdb_byte *m_data;
+  size_t m_size;
+
+  /* True if M_DATA was mmapped, false if it was xmalloc'd.  */
+  bool m_mapped;
+};
+
+/* Return true if the index cache is enabled.  */
+
+extern bool index_cache_enabled_p ();
+
+/* Look in the cache for the index of the objfile whose build-id is
+   BUILD_ID.  Return NULL if there is none.  */
+
+extern std::unique_ptr<index_cache_resource>
+  index_cache_lookup (const struct bfd_build_id *build_id);
+
+/* Store the index of OBJFILE, whose build-id is BUILD_ID, in the
+   cache.  WRITE is called to do the actual writing; it must create an
+   index file named BASENAME with INDEX_SUFFIX appended in directory
+   DIR, or throw an error.  Errors are not propagated to the caller,
+   they are only reported if "set debug index-cache" is on.
+
+   If BACKGROUND is true, WRITE is called on a separate thread, and
+   everything it uses must stay valid and unchanged until
+   index_cache_wait has been called for OBJFILE.  */
+
+extern void index_cache_store
+  (struct objfile *objfile, const struct bfd_build_id *build_id,
+   std::function<void (const char *dir, const char *basename)> write,
+   bool background);
+
+/* Wait until the index of OBJFILE being written in the background,
+   if any, has been stored.  The indices of other objfiles are left
+   alone.  */
+
+extern void index_cache_wait (struct objfile *objfile);
+
+/* Wait until all the indices being written in the background have
+   been stored.  */
+
+extern void index_cache_wait_all ();
+
+#endif /* DWARF_INDEX_CACHE_H */
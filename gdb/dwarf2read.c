@@ -75,11 +75,17 @@
 #include "common/underlying.h"
 #include "common/byte-vector.h"
 #include "filename-seen-cache.h"
+#include "dwarf-index-cache.h"
 #include <fcntl.h>
 #include <sys/types.h>
 #include <algorithm>
 #include <unordered_set>
 #include <unordered_map>
+#if CXX_STD_THREAD
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
 
 typedef struct symbol *symbolp;
 DEF_VEC_P (symbolp);
@@ -326,6 +332,10 @@ public:
   /* The mapped index, or NULL if .gdb_index is missing or not being used.  */
   mapped_index *index_table = NULL;
 
+  /* If the index was found in the index cache rather than in the
+     .gdb_index section, this holds its contents.  */
+  std::unique_ptr<index_cache_resource> index_cache_res;
+
   /* When using index_table, this keeps track of all quick_file_names entries.
      TUs typically share line table entries with a CU, so we maintain a
      separate table of all line table entries to support the sharing.
@@ -516,6 +526,11 @@ struct dwarf2_cu
      with partial_die->offset.SECT_OFF as hash.  */
   htab_t partial_dies;
 
+  /* Non-NULL while a worker thread is reading the partial DIEs of this
+     CU.  Work that is not thread-safe is recorded here, and done later
+     by the main thread.  See dwarf2_build_psymtabs_hard.  */
+  struct dwarf2_preloaded_cu *preload;
+
   /* Storage for things with the same lifetime as this read-in compilation
      unit, including partial DIEs.  */
   struct obstack comp_unit_obstack;
@@ -1266,6 +1281,10 @@ struct partial_die_info
     /* Flag set if spec_offset uses DW_FORM_GNU_ref_alt.  */
     unsigned int spec_is_dwz : 1;
 
+    /* Flag set if NAME was read by a worker thread and still has to
+       be canonicalized.  */
+    unsigned int canonicalize_name : 1;
+
     /* The name of this DIE.  Normally the value of DW_AT_name, but
        sometimes a default name for unnamed DIEs.  */
     const char *name;
@@ -1525,6 +1544,19 @@ show_dwarf_max_cache_age (struct ui_file *file, int from_tty,
 			    "DWARF compilation units is %s.\n"),
 		    value);
 }
+
+/* The number of worker threads used to read partial DIEs while
+   building partial symbol tables.  -1 means one less than the number
+   of processors, and zero disables the worker threads.  */
+static int dwarf_psymtab_threads = -1;
+static void
+show_dwarf_psymtab_threads (struct ui_file *file, int from_tty,
+			    struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("The number of threads used to read "
+			    "DWARF partial symbols is %s.\n"),
+		    value);
+}
 
 /* local function prototypes */
 
@@ -2212,9 +2244,6 @@ attr_value_as_address (struct attribute *attr)
   return addr;
 }
 
-/* The suffix for an index file.  */
-#define INDEX_SUFFIX ".gdb-index"
-
 /* See declaration.  */
 
 dwarf2_per_objfile::dwarf2_per_objfile (struct objfile *objfile_,
@@ -2232,6 +2261,10 @@ dwarf2_per_objfile::dwarf2_per_objfile (struct objfile *objfile_,
 
 dwarf2_per_objfile::~dwarf2_per_objfile ()
 {
+  /* An index for this objfile may be being written to the index
+     cache in the background.  */
+  index_cache_wait (objfile);
+
   /* Cached DIE trees use xmalloc and the comp_unit_obstack.  */
   free_cached_comp_units ();
 
@@ -3264,44 +3297,42 @@ find_slot_in_mapped_hash (struct mapped_index *index, const char *name,
     }
 }
 
-/* A helper function that reads the .gdb_index from SECTION and fills
-   in MAP.  FILENAME is the name of the file containing the section;
-   it is used for error reporting.  DEPRECATED_OK is nonzero if it is
-   ok to use deprecated sections.
+/* A helper function that reads the index contents from BUFFER, which
+   is SIZE bytes long, and fills in MAP.  FILENAME is the name of the
+   file containing the index; it is used for error reporting.
+   DEPRECATED_OK is nonzero if it is ok to use deprecated indices.
 
    CU_LIST, CU_LIST_ELEMENTS, TYPES_LIST, and TYPES_LIST_ELEMENTS are
    out parameters that are filled in with information about the CU and
-   TU lists in the section.
+   TU lists in the index.
 
    Returns 1 if all went well, 0 otherwise.  */
 
 static int
-read_index_from_section (struct objfile *objfile,
-			 const char *filename,
-			 int deprecated_ok,
-			 struct dwarf2_section_info *section,
-			 struct mapped_index *map,
-			 const gdb_byte **cu_list,
-			 offset_type *cu_list_elements,
-			 const gdb_byte **types_list,
-			 offset_type *types_list_elements)
+read_index_from_buffer (struct objfile *objfile,
+			const char *filename,
+			int deprecated_ok,
+			const gdb_byte *buffer,
+			bfd_size_type size,
+			struct mapped_index *map,
+			const gdb_byte **cu_list,
+			offset_type *cu_list_elements,
+			const gdb_byte **types_list,
+			offset_type *types_list_elements)
 {
   const gdb_byte *addr;
   offset_type version;
   offset_type *metadata;
+  offset_type offsets[5];
+  offset_type pool_size;
+  offset_type slot;
   int i;
 
-  if (dwarf2_section_empty_p (section))
-    return 0;
-
-  /* Older elfutils strip versions could keep the section in the main
-     executable while splitting it for the separate debug info file.  */
-  if ((get_section_flags (section) & SEC_HAS_CONTENTS) == 0)
+  /* The version number and the five offsets of the header.  */
+  if (size < 6 * sizeof (offset_type) || size > (offset_type) -1)
     return 0;
 
-  dwarf2_read_section (objfile, section);
-
-  addr = section->buffer;
+  addr = buffer;
   /* Version check.  */
   version = MAYBE_SWAP (*(offset_type *) addr);
   /* Versions earlier than 3 emitted every copy of a psymbol.  This
@@ -3355,41 +3386,107 @@ to use the section anyway."),
     return 0;
 
   map->version = version;
-  map->total_size = section->size;
+  map->total_size = size;
 
   metadata = (offset_type *) (addr + sizeof (offset_type));
 
-  i = 0;
-  *cu_list = addr + MAYBE_SWAP (metadata[i]);
-  *cu_list_elements = ((MAYBE_SWAP (metadata[i + 1]) - MAYBE_SWAP (metadata[i]))
-		       / 8);
-  ++i;
-
-  *types_list = addr + MAYBE_SWAP (metadata[i]);
-  *types_list_elements = ((MAYBE_SWAP (metadata[i + 1])
-			   - MAYBE_SWAP (metadata[i]))
-			  / 8);
-  ++i;
-
-  map->address_table = addr + MAYBE_SWAP (metadata[i]);
-  map->address_table_size = (MAYBE_SWAP (metadata[i + 1])
-			     - MAYBE_SWAP (metadata[i]));
-  ++i;
-
-  map->symbol_table = (offset_type *) (addr + MAYBE_SWAP (metadata[i]));
-  map->symbol_table_slots = ((MAYBE_SWAP (metadata[i + 1])
-			      - MAYBE_SWAP (metadata[i]))
+  /* The tables must follow the header in order, inside the index.
+     This matters most for index files from the index cache, which may
+     have been truncated or damaged.  */
+  for (i = 0; i < 5; ++i)
+    {
+      offsets[i] = MAYBE_SWAP (metadata[i]);
+      if (offsets[i] < 6 * sizeof (offset_type)
+	  || offsets[i] > size
+	  || (i > 0 && offsets[i] < offsets[i - 1]))
+	return 0;
+    }
+
+  /* The CU list, the TU list and the address table are read a whole
+     entry at a time.  */
+  if ((offsets[1] - offsets[0]) % 16 != 0
+      || (offsets[2] - offsets[1]) % 24 != 0
+      || (offsets[3] - offsets[2]) % 20 != 0)
+    return 0;
+
+  *cu_list = addr + offsets[0];
+  *cu_list_elements = (offsets[1] - offsets[0]) / 8;
+
+  *types_list = addr + offsets[1];
+  *types_list_elements = (offsets[2] - offsets[1]) / 8;
+
+  map->address_table = addr + offsets[2];
+  map->address_table_size = offsets[3] - offsets[2];
+
+  map->symbol_table = (offset_type *) (addr + offsets[3]);
+  map->symbol_table_slots = ((offsets[4] - offsets[3])
 			     / (2 * sizeof (offset_type)));
-  ++i;
+  if (map->symbol_table_slots == 0)
+    return 0;
+
+  map->constant_pool = (char *) (addr + offsets[4]);
+
+  /* Every symbol name must be a string inside the constant pool, and
+     every CU vector must fit in it.  */
+  pool_size = size - offsets[4];
+  for (slot = 0; slot < map->symbol_table_slots; ++slot)
+    {
+      offset_type name = MAYBE_SWAP (map->symbol_table[2 * slot]);
+      offset_type vec = MAYBE_SWAP (map->symbol_table[2 * slot + 1]);
+      offset_type vec_len;
 
-  map->constant_pool = (char *) (addr + MAYBE_SWAP (metadata[i]));
+      if (name == 0 && vec == 0)
+	continue;
+
+      if (name >= pool_size
+	  || memchr (map->constant_pool + name, '\0', pool_size - name) == NULL
+	  || pool_size < sizeof (offset_type)
+	  || vec > pool_size - sizeof (offset_type))
+	return 0;
+
+      vec_len = MAYBE_SWAP (*(offset_type *) (map->constant_pool + vec));
+      if (vec_len > (pool_size - vec) / sizeof (offset_type) - 1)
+	return 0;
+    }
 
   return 1;
 }
 
+/* A helper function that reads the .gdb_index from SECTION and fills
+   in MAP.  The other arguments are as for read_index_from_buffer.  */
 
-/* Read the index file.  If everything went ok, initialize the "quick"
-   elements of all the CUs and return 1.  Otherwise, return 0.  */
+static int
+read_index_from_section (struct objfile *objfile,
+			 const char *filename,
+			 int deprecated_ok,
+			 struct dwarf2_section_info *section,
+			 struct mapped_index *map,
+			 const gdb_byte **cu_list,
+			 offset_type *cu_list_elements,
+			 const gdb_byte **types_list,
+			 offset_type *types_list_elements)
+{
+  if (dwarf2_section_empty_p (section))
+    return 0;
+
+  /* Older elfutils strip versions could keep the section in the main
+     executable while splitting it for the separate debug info file.  */
+  if ((get_section_flags (section) & SEC_HAS_CONTENTS) == 0)
+    return 0;
+
+  dwarf2_read_section (objfile, section);
+
+  return read_index_from_buffer (objfile, filename, deprecated_ok,
+				 section->buffer, section->size, map,
+				 cu_list, cu_list_elements,
+				 types_list, types_list_elements);
+}
+
+
+/* Read the index file.  The index is taken from the .gdb_index
+   section if there is one, and from the index cache otherwise.  If
+   everything went ok, initialize the "quick" elements of all the CUs
+   and return 1.  Otherwise, return 0.  */
 
 static int
 dwarf2_read_index (struct objfile *objfile)
@@ -3398,13 +3495,26 @@ dwarf2_read_index (struct objfile *objfile)
   const gdb_byte *cu_list, *types_list, *dwz_list = NULL;
   offset_type cu_list_elements, types_list_elements, dwz_list_elements = 0;
   struct dwz_file *dwz;
+  std::unique_ptr<index_cache_resource> cache_res;
 
   if (!read_index_from_section (objfile, objfile_name (objfile),
 				use_deprecated_index_sections,
 				&dwarf2_per_objfile->gdb_index, &local_map,
 				&cu_list, &cu_list_elements,
 				&types_list, &types_list_elements))
-    return 0;
+    {
+      if (index_cache_enabled_p ())
+	cache_res = index_cache_lookup (build_id_bfd_get (objfile->obfd));
+
+      if (cache_res == NULL
+	  || !read_index_from_buffer (objfile, objfile_name (objfile),
+				      use_deprecated_index_sections,
+				      cache_res->data (), cache_res->size (),
+				      &local_map,
+				      &cu_list, &cu_list_elements,
+				      &types_list, &types_list_elements))
+	return 0;
+    }
 
   /* Don't use the index if it's empty.  */
   if (local_map.symbol_table_slots == 0)
@@ -3457,6 +3567,7 @@ dwarf2_read_index (struct objfile *objfile)
   *map = local_map;
 
   dwarf2_per_objfile->index_table = map;
+  dwarf2_per_objfile->index_cache_res = std::move (cache_res);
   dwarf2_per_objfile->using_index = 1;
   dwarf2_per_objfile->quick_file_names_table =
     create_quick_file_names_table (dwarf2_per_objfile->n_comp_units);
@@ -4460,6 +4571,41 @@ dwarf2_initialize_objfile (struct objfile *objfile)
 
 
 
+static void write_psymtabs_to_index (struct dwarf2_per_objfile *per_objfile,
+				     const char *dir, const char *basename);
+
+/* Store an index for OBJFILE, whose partial symbols were just read, in
+   the index cache, so that the next session can use it instead of
+   reading the partial symbols again.  The index is written on a
+   background thread: the psymtabs it is built from do not change
+   anymore.  objfile_relocate1, which changes the address map and the
+   section offsets, and ~dwarf2_per_objfile wait for it to complete.  */
+
+static void
+dwarf2_store_index_in_cache (struct objfile *objfile)
+{
+  struct dwarf2_per_objfile *per_objfile = dwarf2_per_objfile;
+  const struct bfd_build_id *build_id = build_id_bfd_get (objfile->obfd);
+
+  /* An index for a file using a dwz file is only usable if the dwz
+     file has an index too.  */
+  if (build_id == NULL || dwarf2_get_dwz_file () != NULL)
+    return;
+
+  /* Type units from DWO files may still be added to the signatured
+     type table while the index is written, so write it right away in
+     that case.  */
+  bool background = (per_objfile->dwo_files == NULL
+		     && per_objfile->dwp_file == NULL);
+
+  index_cache_store (objfile, build_id,
+		     [=] (const char *dir, const char *basename)
+		     {
+		       write_psymtabs_to_index (per_objfile, dir, basename);
+		     },
+		     background);
+}
+
 /* Build a partial symbol table.  */
 
 void
@@ -4479,6 +4625,9 @@ dwarf2_build_psymtabs (struct objfile *objfile)
       psymtab_discarder psymtabs (objfile);
       dwarf2_build_psymtabs_hard (objfile);
       psymtabs.keep ();
+
+      if (index_cache_enabled_p ())
+	dwarf2_store_index_in_cache (objfile);
     }
   CATCH (except, RETURN_MASK_ERROR)
     {
@@ -6179,8 +6328,73 @@ struct process_psymtab_comp_unit_data
      language.  */
 
   enum language pretend_language;
+
+  /* If non-NULL, the partial DIEs of the CU were already read by a
+     worker thread.  */
+
+  struct dwarf2_preloaded_cu *preload;
+};
+
+/* A partial symbol that load_partial_dies found while running in a
+   worker thread.  It is added to the objfile by the main thread.  */
+
+struct dwarf2_deferred_psymbol
+{
+  const char *name;
+
+  /* True if NAME still has to be canonicalized.  */
+  bool canonicalize_name;
+
+  domain_enum domain;
+  enum address_class aclass;
+
+  /* True for the global partial symbol list, false for the static
+     one.  */
+  bool is_global;
 };
 
+/* A compilation unit whose partial DIEs were read by a worker thread
+   while building the partial symbol tables.  See
+   dwarf2_build_psymtabs_hard.  */
+
+struct dwarf2_preloaded_cu
+{
+  dwarf2_preloaded_cu () = default;
+  ~dwarf2_preloaded_cu ();
+
+  /* Disable copy.  */
+  dwarf2_preloaded_cu (const dwarf2_preloaded_cu &) = delete;
+  void operator= (const dwarf2_preloaded_cu &) = delete;
+
+  /* The CU, which is not yet linked to its dwarf2_per_cu_data.  This
+     is reset to NULL when the main thread takes it over.  */
+  struct dwarf2_cu *cu = NULL;
+
+  /* The top level DIE of the CU, and what init_cutu_and_read_dies
+     would have passed to process_psymtab_comp_unit_reader along with
+     it.  */
+  struct die_info *comp_unit_die = NULL;
+  int has_children = 0;
+  const gdb_byte *info_ptr = NULL;
+
+  /* The result of load_partial_dies.  */
+  struct partial_die_info *first_die = NULL;
+
+  /* Linked partial DIEs whose names must be canonicalized.  */
+  std::vector<partial_die_info *> names_to_canonicalize;
+
+  /* Partial symbols load_partial_dies would have added directly, in
+     order.  */
+  std::vector<dwarf2_deferred_psymbol> psymbols;
+
+  /* The complaints issued while reading the CU, which the main thread
+     issues when it takes the CU over.  */
+  std::vector<deferred_complaint> complaints;
+};
+
+static struct partial_die_info *finish_preloaded_partial_dies
+  (struct dwarf2_preloaded_cu *preload, struct dwarf2_cu *cu);
+
 /* die_reader_func for process_psymtab_comp_unit.  */
 
 static void
@@ -6250,7 +6464,10 @@ process_psymtab_comp_unit_reader (const struct die_reader_specs *reader,
       lowpc = ((CORE_ADDR) -1);
       highpc = ((CORE_ADDR) 0);
 
-      first_die = load_partial_dies (reader, info_ptr, 1);
+      if (info->preload != NULL)
+	first_die = finish_preloaded_partial_dies (info->preload, cu);
+      else
+	first_die = load_partial_dies (reader, info_ptr, 1);
 
       scan_partial_symbols (first_die, &lowpc, &highpc,
 			    cu_bounds_kind <= PC_BOUNDS_INVALID, cu);
@@ -6336,6 +6553,7 @@ process_psymtab_comp_unit (struct dwarf2_per_cu_data *this_cu,
       process_psymtab_comp_unit_data info;
       info.want_partial_unit = want_partial_unit;
       info.pretend_language = pretend_language;
+      info.preload = NULL;
       init_cutu_and_read_dies (this_cu, NULL, 0, 0,
 			       process_psymtab_comp_unit_reader, &info);
     }
@@ -6344,6 +6562,327 @@ process_psymtab_comp_unit (struct dwarf2_per_cu_data *this_cu,
   age_cached_comp_units ();
 }
 
+dwarf2_preloaded_cu::~dwarf2_preloaded_cu ()
+{
+  if (cu != NULL)
+    {
+      /* This CU was never handed over to the main thread, so it must
+	 not be unlinked from its per_cu like free_heap_comp_unit
+	 would do.  */
+      dwarf2_free_abbrev_table (cu);
+      obstack_free (&cu->comp_unit_obstack, NULL);
+      xfree (cu);
+    }
+}
+
+/* Worker thread part of dwarf2_build_psymtabs_hard: read the header,
+   the top level DIE and the partial DIEs of the CU described by
+   PER_CU, a private copy of the CU's dwarf2_per_cu_data.  Return NULL
+   if the CU must be read by the main thread instead, e.g. because it
+   is a dummy CU or lives in a DWO file.
+
+   This follows init_cutu_and_read_dies and
+   process_psymtab_comp_unit_reader, but only calls code that is safe
+   to run outside of the main thread.  All the sections used here must
+   have been read in beforehand.  Complaints are saved in the result,
+   to be issued by the main thread.  */
+
+static std::unique_ptr<dwarf2_preloaded_cu>
+preload_psymtab_comp_unit (struct dwarf2_per_cu_data *per_cu)
+{
+  struct dwarf2_section_info *section = per_cu->section;
+  struct dwarf2_section_info *abbrev_section
+    = get_abbrev_section_for_cu (per_cu);
+  bfd *abfd = get_section_bfd_owner (section);
+  const gdb_byte *begin_info_ptr, *info_ptr;
+  struct die_reader_specs reader;
+  std::unique_ptr<dwarf2_preloaded_cu> preload (new dwarf2_preloaded_cu);
+  scoped_defer_complaints defer_complaints (&preload->complaints);
+  struct dwarf2_cu *cu;
+
+  /* Like init_one_comp_unit, but PER_CU->cu is left alone.  */
+  cu = XCNEW (struct dwarf2_cu);
+  cu->per_cu = per_cu;
+  cu->objfile = per_cu->objfile;
+  obstack_init (&cu->comp_unit_obstack);
+  cu->preload = preload.get ();
+  preload->cu = cu;
+
+  begin_info_ptr = info_ptr = section->buffer + to_underlying (per_cu->sect_off);
+  info_ptr = read_and_check_comp_unit_head (&cu->header, section,
+					    abbrev_section, info_ptr,
+					    rcuh_kind::COMPILE);
+
+  /* Leave dummy compilation units to init_cutu_and_read_dies.  */
+  if (info_ptr >= begin_info_ptr + per_cu->length
+      || peek_abbrev_code (abfd, info_ptr) == 0)
+    return NULL;
+
+  dwarf2_read_abbrevs (cu, abbrev_section);
+
+  init_cu_die_reader (&reader, cu, section, NULL);
+  info_ptr = read_full_die (&reader, &preload->comp_unit_die, info_ptr,
+			    &preload->has_children);
+
+  /* Partial units are only read when imported, and DWO files are
+     opened on demand; both are left to the main thread.  */
+  if (preload->comp_unit_die->tag != DW_TAG_compile_unit
+      || dwarf2_attr (preload->comp_unit_die, DW_AT_GNU_dwo_name, cu) != NULL)
+    return NULL;
+
+  prepare_one_comp_unit (cu, preload->comp_unit_die, language_minimal);
+
+  preload->info_ptr = info_ptr;
+  if (preload->has_children)
+    preload->first_die = load_partial_dies (&reader, info_ptr, 1);
+
+  return preload;
+}
+
+/* Main thread part of reading a CU preloaded by
+   preload_psymtab_comp_unit: do the work load_partial_dies left to
+   us, and return the first partial DIE of PRELOAD.  */
+
+static struct partial_die_info *
+finish_preloaded_partial_dies (struct dwarf2_preloaded_cu *preload,
+			       struct dwarf2_cu *cu)
+{
+  struct objfile *objfile = cu->objfile;
+
+  reissue_complaints (preload->complaints);
+
+  for (partial_die_info *pdi : preload->names_to_canonicalize)
+    {
+      pdi->name
+	= dwarf2_canonicalize_name (pdi->name, cu,
+				    &objfile->per_bfd->storage_obstack);
+      pdi->canonicalize_name = 0;
+    }
+
+  for (const dwarf2_deferred_psymbol &psym : preload->psymbols)
+    {
+      const char *name = psym.name;
+
+      if (psym.canonicalize_name)
+	name = dwarf2_canonicalize_name (name, cu,
+					 &objfile->per_bfd->storage_obstack);
+      add_psymbol_to_list (name, strlen (name), 0,
+			   psym.domain, psym.aclass,
+			   psym.is_global
+			   ? &objfile->global_psymbols
+			   : &objfile->static_psymbols,
+			   0, cu->language, objfile);
+    }
+
+  return preload->first_die;
+}
+
+/* Like process_psymtab_comp_unit, for a CU whose partial DIEs were
+   read by a worker thread.  */
+
+static void
+process_preloaded_psymtab_comp_unit (struct dwarf2_per_cu_data *this_cu,
+				     struct dwarf2_preloaded_cu *preload)
+{
+  struct dwarf2_cu *cu = preload->cu;
+  struct die_reader_specs reader;
+  struct cleanup *cleanups;
+  process_psymtab_comp_unit_data info;
+
+  if (this_cu->cu != NULL)
+    free_one_cached_comp_unit (this_cu);
+
+  /* Take the CU over, as if init_cutu_and_read_dies had read it.  */
+  preload->cu = NULL;
+  cu->preload = NULL;
+  cu->per_cu = this_cu;
+  this_cu->cu = cu;
+  this_cu->dwarf_version = cu->header.version;
+  cleanups = make_cleanup (free_heap_comp_unit, cu);
+  make_cleanup (dwarf2_free_abbrev_table, cu);
+
+  init_cu_die_reader (&reader, cu, this_cu->section, NULL);
+
+  info.want_partial_unit = 0;
+  info.pretend_language = language_minimal;
+  info.preload = preload;
+  process_psymtab_comp_unit_reader (&reader, preload->info_ptr,
+				    preload->comp_unit_die,
+				    preload->has_children, &info);
+
+  do_cleanups (cleanups);
+
+  /* Age out any secondary CUs.  */
+  age_cached_comp_units ();
+}
+
+#if CXX_STD_THREAD
+
+/* Reads the partial DIEs of the compilation units of the current
+   objfile on worker threads, ahead of the main thread which builds
+   the partial symbol tables from them in order.  */
+
+class dwarf2_psymtab_preloader
+{
+public:
+
+  dwarf2_psymtab_preloader (int n_threads);
+  ~dwarf2_psymtab_preloader ();
+
+  /* Disable copy.  */
+  dwarf2_psymtab_preloader (const dwarf2_psymtab_preloader &) = delete;
+  void operator= (const dwarf2_psymtab_preloader &) = delete;
+
+  /* Wait for the I'th compilation unit to be read, and return it.
+     Return NULL if the main thread has to read it.  Units must be
+     taken in order.  */
+  std::unique_ptr<dwarf2_preloaded_cu> take (int i);
+
+private:
+
+  void worker ();
+
+  struct slot
+  {
+    /* A copy of the unit's dwarf2_per_cu_data, made before the
+       workers start, so that they never look at data the main thread
+       may be updating.  */
+    struct dwarf2_per_cu_data per_cu;
+
+    std::unique_ptr<dwarf2_preloaded_cu> result;
+    bool done;
+  };
+
+  std::vector<slot> m_slots;
+  std::vector<std::thread> m_threads;
+
+  std::mutex m_mutex;
+
+  /* Signaled when a slot is done.  */
+  std::condition_variable m_done_cond;
+
+  /* Signaled when the main thread takes a slot, or on shutdown.  */
+  std::condition_variable m_taken_cond;
+
+  /* The next slot to hand to a worker.  */
+  int m_next = 0;
+
+  /* The number of slots taken by the main thread.  */
+  int m_taken = 0;
+
+  /* How far the workers may run ahead of the main thread.  This bounds
+     the memory used by preloaded units.  */
+  int m_window;
+
+  bool m_stop = false;
+};
+
+dwarf2_psymtab_preloader::dwarf2_psymtab_preloader (int n_threads)
+  : m_slots (dwarf2_per_objfile->n_comp_units),
+    m_window (8 * n_threads)
+{
+  for (int i = 0; i < dwarf2_per_objfile->n_comp_units; ++i)
+    {
+      m_slots[i].per_cu = *dw2_get_cutu (i);
+      m_slots[i].per_cu.cu = NULL;
+      m_slots[i].done = false;
+    }
+
+  for (int i = 0; i < n_threads; ++i)
+    m_threads.emplace_back (&dwarf2_psymtab_preloader::worker, this);
+}
+
+dwarf2_psymtab_preloader::~dwarf2_psymtab_preloader ()
+{
+  {
+    std::lock_guard<std::mutex> guard (m_mutex);
+    m_stop = true;
+  }
+  m_taken_cond.notify_all ();
+
+  for (std::thread &thread : m_threads)
+    thread.join ();
+}
+
+void
+dwarf2_psymtab_preloader::worker ()
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+
+  while (true)
+    {
+      m_taken_cond.wait (lock, [this] ()
+	{
+	  return m_stop || m_next - m_taken < m_window;
+	});
+      if (m_stop || m_next == (int) m_slots.size ())
+	break;
+
+      slot &s = m_slots[m_next++];
+      std::unique_ptr<dwarf2_preloaded_cu> result;
+
+      lock.unlock ();
+      TRY
+	{
+	  result = preload_psymtab_comp_unit (&s.per_cu);
+	}
+      CATCH (except, RETURN_MASK_ALL)
+	{
+	  /* The main thread will read the unit again and report the
+	     error.  */
+	}
+      END_CATCH
+      lock.lock ();
+
+      s.result = std::move (result);
+      s.done = true;
+      m_done_cond.notify_all ();
+    }
+}
+
+std::unique_ptr<dwarf2_preloaded_cu>
+dwarf2_psymtab_preloader::take (int i)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+
+  gdb_assert (i == m_taken);
+  m_done_cond.wait (lock, [&] () { return m_slots[i].done; });
+  ++m_taken;
+  m_taken_cond.notify_all ();
+
+  return std::move (m_slots[i].result);
+}
+
+#endif /* CXX_STD_THREAD */
+
+/* Return the number of worker threads dwarf2_build_psymtabs_hard
+   should use for the current objfile, or zero if the partial DIEs must
+   all be read by the main thread.  */
+
+static int
+dwarf2_psymtab_worker_threads (void)
+{
+#if CXX_STD_THREAD
+  int n_threads = dwarf_psymtab_threads;
+
+  if (n_threads < 0)
+    n_threads = std::thread::hardware_concurrency () - 1;
+
+  /* The workers never follow references into a dwz file, and their
+     output would be interleaved with debugging output.  */
+  if (n_threads <= 0
+      || dwarf2_per_objfile->n_comp_units < 2
+      || dwarf2_per_objfile->dwz_file != NULL
+      || dwarf_read_debug
+      || dwarf_die_debug)
+    return 0;
+
+  return std::min (n_threads, dwarf2_per_objfile->n_comp_units);
+#else
+  return 0;
+#endif
+}
+
 /* Reader function for build_type_psymtabs.  */
 
 static void
@@ -6699,7 +7238,7 @@ static void
 dwarf2_build_psymtabs_hard (struct objfile *objfile)
 {
   struct cleanup *back_to, *addrmap_cleanup;
-  int i;
+  int i, n_threads;
 
   if (dwarf_read_debug)
     {
@@ -6725,12 +7264,58 @@ dwarf2_build_psymtabs_hard (struct objfile *objfile)
   objfile->psymtabs_addrmap = addrmap_create_mutable (&temp_obstack);
   addrmap_cleanup = make_cleanup (psymtabs_addrmap_cleanup, objfile);
 
-  for (i = 0; i < dwarf2_per_objfile->n_comp_units; ++i)
+  n_threads = dwarf2_psymtab_worker_threads ();
+  if (n_threads == 0)
     {
-      struct dwarf2_per_cu_data *per_cu = dw2_get_cutu (i);
+      for (i = 0; i < dwarf2_per_objfile->n_comp_units; ++i)
+	{
+	  struct dwarf2_per_cu_data *per_cu = dw2_get_cutu (i);
 
-      process_psymtab_comp_unit (per_cu, 0, language_minimal);
+	  process_psymtab_comp_unit (per_cu, 0, language_minimal);
+	}
     }
+#if CXX_STD_THREAD
+  else
+    {
+      /* The worker threads read the partial DIEs of each CU, while
+	 this thread builds the partial symbol tables from them, in
+	 the same order as above.  The sections the workers use must
+	 not be read in lazily behind our back.  */
+      dwarf2_read_section (objfile, &dwarf2_per_objfile->abbrev);
+      dwarf2_read_section (objfile, &dwarf2_per_objfile->str);
+      dwarf2_read_section (objfile, &dwarf2_per_objfile->line_str);
+      dwarf2_read_section (objfile, &dwarf2_per_objfile->addr);
+
+      gdb::optional<dwarf2_psymtab_preloader> preloader;
+      preloader.emplace (n_threads);
+
+      TRY
+	{
+	  for (i = 0; i < dwarf2_per_objfile->n_comp_units; ++i)
+	    {
+	      struct dwarf2_per_cu_data *per_cu = dw2_get_cutu (i);
+	      std::unique_ptr<dwarf2_preloaded_cu> preload
+		= preloader->take (i);
+
+	      /* If this CU has since been marked for reading all its
+		 DIEs, read it again so that the result does not
+		 depend on the timing of the workers.  */
+	      if (preload == NULL || per_cu->load_all_dies)
+		process_psymtab_comp_unit (per_cu, 0, language_minimal);
+	      else
+		process_preloaded_psymtab_comp_unit (per_cu, preload.get ());
+	    }
+	}
+      CATCH (except, RETURN_MASK_ALL)
+	{
+	  /* Stop the workers before any cleanup can free what they
+	     are reading.  */
+	  preloader.reset ();
+	  throw_exception (except);
+	}
+      END_CATCH
+    }
+#endif
 
   /* This has to wait until we read the CUs, we need the list of DWOs.  */
   process_skeletonless_type_units (objfile);
@@ -16033,6 +16618,38 @@ is_type_tag_for_partial (int tag)
     }
 }
 
+/* Add a partial symbol for PART_DIE, which load_partial_dies is about
+   to discard.  If a worker thread is reading CU, the symbol is
+   recorded and added later by the main thread.  */
+
+static void
+add_partial_die_psymbol (struct partial_die_info *part_die,
+			 domain_enum domain, enum address_class aclass,
+			 bool is_global, struct dwarf2_cu *cu)
+{
+  struct objfile *objfile = cu->objfile;
+
+  if (cu->preload != NULL)
+    {
+      dwarf2_deferred_psymbol psym;
+
+      psym.name = part_die->name;
+      psym.canonicalize_name = part_die->canonicalize_name;
+      psym.domain = domain;
+      psym.aclass = aclass;
+      psym.is_global = is_global;
+      cu->preload->psymbols.push_back (psym);
+      return;
+    }
+
+  add_psymbol_to_list (part_die->name, strlen (part_die->name), 0,
+		       domain, aclass,
+		       is_global
+		       ? &objfile->global_psymbols
+		       : &objfile->static_psymbols,
+		       0, cu->language, objfile);
+}
+
 /* Load all DIEs that are interesting for partial symbols into memory.  */
 
 static struct partial_die_info *
@@ -16166,10 +16783,8 @@ load_partial_dies (const struct die_reader_specs *reader,
 	      || part_die->tag == DW_TAG_subrange_type))
 	{
 	  if (building_psymtab && part_die->name != NULL)
-	    add_psymbol_to_list (part_die->name, strlen (part_die->name), 0,
-				 VAR_DOMAIN, LOC_TYPEDEF,
-				 &objfile->static_psymbols,
-				 0, cu->language, objfile);
+	    add_partial_die_psymbol (part_die, VAR_DOMAIN, LOC_TYPEDEF,
+				     0, cu);
 	  info_ptr = locate_pdi_sibling (reader, part_die, info_ptr);
 	  continue;
 	}
@@ -16202,12 +16817,8 @@ load_partial_dies (const struct die_reader_specs *reader,
 	    complaint (&symfile_complaints,
 		       _("malformed enumerator DIE ignored"));
 	  else if (building_psymtab)
-	    add_psymbol_to_list (part_die->name, strlen (part_die->name), 0,
-				 VAR_DOMAIN, LOC_CONST,
-				 cu->language == language_cplus
-				 ? &objfile->global_psymbols
-				 : &objfile->static_psymbols,
-				 0, cu->language, objfile);
+	    add_partial_die_psymbol (part_die, VAR_DOMAIN, LOC_CONST,
+				     cu->language == language_cplus, cu);
 
 	  info_ptr = locate_pdi_sibling (reader, part_die, info_ptr);
 	  continue;
@@ -16228,6 +16839,9 @@ load_partial_dies (const struct die_reader_specs *reader,
       if (first_die == NULL)
 	first_die = part_die;
 
+      if (part_die->canonicalize_name)
+	cu->preload->names_to_canonicalize.push_back (part_die);
+
       /* Maybe add the DIE to the hash table.  Not all DIEs that we
 	 find interesting need to be in the hash table, because we
 	 also have the parent/sibling/child chains; only those that we
@@ -16360,9 +16974,17 @@ read_partial_die (const struct die_reader_specs *reader,
 	      part_die->name = DW_STRING (&attr);
 	      break;
 	    default:
-	      part_die->name
-		= dwarf2_canonicalize_name (DW_STRING (&attr), cu,
-					    &objfile->per_bfd->storage_obstack);
+	      if (cu->preload != NULL && cu->language == language_cplus)
+		{
+		  /* The C++ name parser is not reentrant; leave the
+		     canonicalization to the main thread.  */
+		  part_die->name = DW_STRING (&attr);
+		  part_die->canonicalize_name = 1;
+		}
+	      else
+		part_die->name
+		  = dwarf2_canonicalize_name (DW_STRING (&attr), cu,
+					      &objfile->per_bfd->storage_obstack);
 	      break;
 	    }
 	  break;
@@ -23319,6 +23941,10 @@ dwarf2_per_objfile_free (struct objfile *objfile, void *d)
      cleaning up.  */
   dwarf2_per_objfile = NULL;
 
+  /* Don't free anything an index being written in the background may
+     still use.  */
+  index_cache_wait (objfile);
+
   for (ix = 0; ix < data->n_comp_units; ++ix)
    VEC_free (dwarf2_per_cu_ptr, data->all_comp_units[ix]->imported_symtabs);
 
@@ -23882,15 +24508,22 @@ recursively_write_psymbols (struct objfile *objfile,
 		  1);
 }
 
-/* Create an index file for OBJFILE in the directory DIR.  */
+/* Create an index file for the objfile of PER_OBJFILE in the
+   directory DIR.  The file is named BASENAME with INDEX_SUFFIX
+   appended.  This may be called on a thread other than the main one
+   (see dwarf2_store_index_in_cache), so it must not use any global
+   state, the global dwarf2_per_objfile in particular.  */
 
 static void
-write_psymtabs_to_index (struct objfile *objfile, const char *dir)
+write_psymtabs_to_index (struct dwarf2_per_objfile *per_objfile,
+			 const char *dir, const char *basename)
 {
-  if (dwarf2_per_objfile->using_index)
+  struct objfile *objfile = per_objfile->objfile;
+
+  if (per_objfile->using_index)
     error (_("Cannot use an index to create the index"));
 
-  if (VEC_length (dwarf2_section_info_def, dwarf2_per_objfile->types) > 1)
+  if (VEC_length (dwarf2_section_info_def, per_objfile->types) > 1)
     error (_("Cannot make an index when the file has multiple .debug_types sections"));
 
   if (!objfile->psymtabs || !objfile->psymtabs_addrmap)
@@ -23900,8 +24533,8 @@ write_psymtabs_to_index (struct objfile *objfile, const char *dir)
   if (stat (objfile_name (objfile), &st) < 0)
     perror_with_name (objfile_name (objfile));
 
-  std::string filename (std::string (dir) + SLASH_STRING
-			+ lbasename (objfile_name (objfile)) + INDEX_SUFFIX);
+  std::string filename (std::string (dir) + SLASH_STRING + basename
+			+ INDEX_SUFFIX);
 
   FILE *out_file = gdb_fopen_cloexec (filename.c_str (), "wb").release ();
   if (!out_file)
@@ -23922,7 +24555,7 @@ write_psymtabs_to_index (struct objfile *objfile, const char *dir)
      in the index file).  This will later be needed to write the address
      table.  */
   psym_index_map cu_index_htab;
-  cu_index_htab.reserve (dwarf2_per_objfile->n_comp_units);
+  cu_index_htab.reserve (per_objfile->n_comp_units);
 
   /* The CU list is already sorted, so we don't need to do additional
      work here.  Also, the debug_types entries do not appear in
@@ -23934,10 +24567,10 @@ write_psymtabs_to_index (struct objfile *objfile, const char *dir)
      require rebuilding buckets and thus many trips to
      malloc/free.  */
   size_t psyms_count = 0;
-  for (int i = 0; i < dwarf2_per_objfile->n_comp_units; ++i)
+  for (int i = 0; i < per_objfile->n_comp_units; ++i)
     {
       struct dwarf2_per_cu_data *per_cu
-	= dwarf2_per_objfile->all_comp_units[i];
+	= per_objfile->all_comp_units[i];
       struct partial_symtab *psymtab = per_cu->v.psymtab;
 
       if (psymtab != NULL && psymtab->user == NULL)
@@ -23946,10 +24579,10 @@ write_psymtabs_to_index (struct objfile *objfile, const char *dir)
   /* Generating an index for gdb itself shows a ratio of
      TOTAL_SEEN_SYMS/UNIQUE_SYMS or ~5.  4 seems like a good bet.  */
   std::unordered_set<partial_symbol *> psyms_seen (psyms_count / 4);
-  for (int i = 0; i < dwarf2_per_objfile->n_comp_units; ++i)
+  for (int i = 0; i < per_objfile->n_comp_units; ++i)
     {
       struct dwarf2_per_cu_data *per_cu
-	= dwarf2_per_objfile->all_comp_units[i];
+	= per_objfile->all_comp_units[i];
       struct partial_symtab *psymtab = per_cu->v.psymtab;
 
       /* CU of a shared file from 'dwz -m' may be unused by this main file.
@@ -23976,15 +24609,15 @@ write_psymtabs_to_index (struct objfile *objfile, const char *dir)
 
   /* Write out the .debug_type entries, if any.  */
   data_buf types_cu_list;
-  if (dwarf2_per_objfile->signatured_types)
+  if (per_objfile->signatured_types)
     {
       signatured_type_index_data sig_data (types_cu_list,
 					   psyms_seen);
 
       sig_data.objfile = objfile;
       sig_data.symtab = &symtab;
-      sig_data.cu_index = dwarf2_per_objfile->n_comp_units;
-      htab_traverse_noresize (dwarf2_per_objfile->signatured_types,
+      sig_data.cu_index = per_objfile->n_comp_units;
+      htab_traverse_noresize (per_objfile->signatured_types,
 			      write_one_signatured_type, &sig_data);
     }
 
@@ -24064,7 +24697,8 @@ save_gdb_index_command (char *arg, int from_tty)
 
 	TRY
 	  {
-	    write_psymtabs_to_index (objfile, arg);
+	    write_psymtabs_to_index (dwarf2_per_objfile, arg,
+				     lbasename (objfile_name (objfile)));
 	  }
 	CATCH (except, RETURN_MASK_ERROR)
 	  {
@@ -24132,6 +24766,19 @@ caching, which can slow down startup."),
 			    &set_dwarf_cmdlist,
 			    &show_dwarf_cmdlist);
 
+  add_setshow_zuinteger_unlimited_cmd ("psymtab-threads", class_obscure,
+				       &dwarf_psymtab_threads, _("\
+Set the number of threads used to read DWARF partial symbols."), _("\
+Show the number of threads used to read DWARF partial symbols."), _("\
+While building partial symbol tables, worker threads read the DIEs of\n\
+upcoming compilation units in parallel.  Zero disables the worker\n\
+threads.  \"unlimited\" uses one thread less than the number of\n\
+processors."),
+				       NULL,
+				       show_dwarf_psymtab_threads,
+				       &set_dwarf_cmdlist,
+				       &show_dwarf_cmdlist);
+
   add_setshow_boolean_cmd ("always-disassemble", class_obscure,
 			   &dwarf_always_disassemble, _("\
 Set whether `info address' always disassembles DWARF expressions."), _("\
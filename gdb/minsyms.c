@@ -51,6 +51,7 @@
 #include "language.h"
 #include "cli/cli-utils.h"
 #include "symbol.h"
+#include <algorithm>
 
 /* See minsyms.h.  */
 
@@ -547,9 +548,7 @@ lookup_minimal_symbol_by_pc_section_1 (CORE_ADDR pc_in,
 				       struct obj_section *section,
 				       int want_trampoline)
 {
-  int lo;
   int hi;
-  int newobj;
   struct objfile *objfile;
   struct minimal_symbol *msymbol;
   struct minimal_symbol *best_symbol = NULL;
@@ -586,10 +585,11 @@ lookup_minimal_symbol_by_pc_section_1 (CORE_ADDR pc_in,
       if (objfile->per_bfd->minimal_symbol_count > 0)
 	{
 	  int best_zero_sized = -1;
+	  const CORE_ADDR *addrs = objfile->per_bfd->msymbol_addrs;
+	  const unsigned long *sizes = objfile->per_bfd->msymbol_sizes;
+	  int count = objfile->per_bfd->minimal_symbol_count;
 
           msymbol = objfile->per_bfd->msymbols;
-	  lo = 0;
-	  hi = objfile->per_bfd->minimal_symbol_count - 1;
 
 	  /* This code assumes that the minimal symbols are sorted by
 	     ascending address values.  If the pc value is greater than or
@@ -598,43 +598,14 @@ lookup_minimal_symbol_by_pc_section_1 (CORE_ADDR pc_in,
 	     "best" symbol.  This includes the last real symbol, for cases
 	     where the pc value is larger than any address in this vector.
 
-	     By iterating until the address associated with the current
-	     hi index (the endpoint of the test interval) is less than
-	     or equal to the desired pc value, we accomplish two things:
-	     (1) the case where the pc value is larger than any minimal
-	     symbol address is trivially solved, (2) the address associated
-	     with the hi index is always the one we want when the interation
-	     terminates.  In essence, we are iterating the test interval
-	     down until the pc value is pushed out of it from the high end.
+	     The search only looks at the compact array of addresses.
+	     If we have multiple symbols at the same address, we want
+	     hi to point to the last one.  That way we can find the
+	     right symbol if it has an index greater than hi.  */
 
-	     Warning: this code is trickier than it would appear at first.  */
-
-	  if (frob_address (objfile, &pc)
-	      && pc >= MSYMBOL_VALUE_RAW_ADDRESS (&msymbol[lo]))
+	  if (frob_address (objfile, &pc) && pc >= addrs[0])
 	    {
-	      while (MSYMBOL_VALUE_RAW_ADDRESS (&msymbol[hi]) > pc)
-		{
-		  /* pc is still strictly less than highest address.  */
-		  /* Note "new" will always be >= lo.  */
-		  newobj = (lo + hi) / 2;
-		  if ((MSYMBOL_VALUE_RAW_ADDRESS (&msymbol[newobj]) >= pc)
-		      || (lo == newobj))
-		    {
-		      hi = newobj;
-		    }
-		  else
-		    {
-		      lo = newobj;
-		    }
-		}
-
-	      /* If we have multiple symbols at the same address, we want
-	         hi to point to the last one.  That way we can find the
-	         right symbol if it has an index greater than hi.  */
-	      while (hi < objfile->per_bfd->minimal_symbol_count - 1
-		     && (MSYMBOL_VALUE_RAW_ADDRESS (&msymbol[hi])
-			 == MSYMBOL_VALUE_RAW_ADDRESS (&msymbol[hi + 1])))
-		hi++;
+	      hi = std::upper_bound (addrs, addrs + count, pc) - addrs - 1;
 
 	      /* Skip various undesirable symbols.  */
 	      while (hi >= 0)
@@ -679,10 +650,8 @@ lookup_minimal_symbol_by_pc_section_1 (CORE_ADDR pc_in,
 		  if (hi > 0
 		      && MSYMBOL_TYPE (&msymbol[hi]) == other_type
 		      && MSYMBOL_TYPE (&msymbol[hi - 1]) == want_type
-		      && (MSYMBOL_SIZE (&msymbol[hi])
-			  == MSYMBOL_SIZE (&msymbol[hi - 1]))
-		      && (MSYMBOL_VALUE_RAW_ADDRESS (&msymbol[hi])
-			  == MSYMBOL_VALUE_RAW_ADDRESS (&msymbol[hi - 1]))
+		      && sizes[hi] == sizes[hi - 1]
+		      && addrs[hi] == addrs[hi - 1]
 		      && (MSYMBOL_OBJ_SECTION (objfile, &msymbol[hi])
 			  == MSYMBOL_OBJ_SECTION (objfile, &msymbol[hi - 1])))
 		    {
@@ -696,7 +665,7 @@ lookup_minimal_symbol_by_pc_section_1 (CORE_ADDR pc_in,
 		     symbol isn't an object or function (e.g. a
 		     label), or it may just mean that the size was not
 		     specified.  */
-		  if (MSYMBOL_SIZE (&msymbol[hi]) == 0)
+		  if (sizes[hi] == 0)
 		    {
 		      if (best_zero_sized == -1)
 			best_zero_sized = hi;
@@ -710,11 +679,9 @@ lookup_minimal_symbol_by_pc_section_1 (CORE_ADDR pc_in,
 		     the nocancel variants of system calls are inside
 		     the cancellable variants, but both have sizes.  */
 		  if (hi > 0
-		      && MSYMBOL_SIZE (&msymbol[hi]) != 0
-		      && pc >= (MSYMBOL_VALUE_RAW_ADDRESS (&msymbol[hi])
-				+ MSYMBOL_SIZE (&msymbol[hi]))
-		      && pc < (MSYMBOL_VALUE_RAW_ADDRESS (&msymbol[hi - 1])
-			       + MSYMBOL_SIZE (&msymbol[hi - 1])))
+		      && sizes[hi] != 0
+		      && pc >= addrs[hi] + sizes[hi]
+		      && pc < addrs[hi - 1] + sizes[hi - 1])
 		    {
 		      hi--;
 		      continue;
@@ -731,7 +698,7 @@ lookup_minimal_symbol_by_pc_section_1 (CORE_ADDR pc_in,
 		 address).  Also, if we ran off the end, be sure
 		 to back up.  */
 	      if (best_zero_sized != -1
-		  && (hi < 0 || MSYMBOL_SIZE (&msymbol[hi]) == 0))
+		  && (hi < 0 || sizes[hi] == 0))
 		hi = best_zero_sized;
 
 	      /* If the minimal symbol has a non-zero size, and this
@@ -742,9 +709,8 @@ lookup_minimal_symbol_by_pc_section_1 (CORE_ADDR pc_in,
 		 specified sizes, they do not overlap.  */
 
 	      if (hi >= 0
-		  && MSYMBOL_SIZE (&msymbol[hi]) != 0
-		  && pc >= (MSYMBOL_VALUE_RAW_ADDRESS (&msymbol[hi])
-			    + MSYMBOL_SIZE (&msymbol[hi])))
+		  && sizes[hi] != 0
+		  && pc >= addrs[hi] + sizes[hi])
 		{
 		  if (best_zero_sized != -1)
 		    hi = best_zero_sized;
@@ -759,8 +725,7 @@ lookup_minimal_symbol_by_pc_section_1 (CORE_ADDR pc_in,
 
 	      if (hi >= 0
 		  && ((best_symbol == NULL) ||
-		      (MSYMBOL_VALUE_RAW_ADDRESS (best_symbol) <
-		       MSYMBOL_VALUE_RAW_ADDRESS (&msymbol[hi]))))
+		      (MSYMBOL_VALUE_RAW_ADDRESS (best_symbol) < addrs[hi])))
 		{
 		  best_symbol = &msymbol[hi];
 		  best_objfile = objfile;
@@ -1192,6 +1157,29 @@ build_minimal_symbol_hash_tables (struct objfile *objfile)
     }
 }
 
+/* Build the arrays of addresses and sizes that
+   lookup_minimal_symbol_by_pc_section searches, from the minimal
+   symbols of OBJFILE.  */
+
+static void
+build_minimal_symbol_pc_index (struct objfile *objfile)
+{
+  struct objfile_per_bfd_storage *per_bfd = objfile->per_bfd;
+  int count = per_bfd->minimal_symbol_count;
+  int i;
+
+  per_bfd->msymbol_addrs = XOBNEWVEC (&per_bfd->storage_obstack,
+				      CORE_ADDR, count);
+  per_bfd->msymbol_sizes = XOBNEWVEC (&per_bfd->storage_obstack,
+				      unsigned long, count);
+  for (i = 0; i < count; i++)
+    {
+      per_bfd->msymbol_addrs[i]
+	= MSYMBOL_VALUE_RAW_ADDRESS (&per_bfd->msymbols[i]);
+      per_bfd->msymbol_sizes[i] = MSYMBOL_SIZE (&per_bfd->msymbols[i]);
+    }
+}
+
 /* Add the minimal symbols in the existing bunches to the objfile's official
    minimal symbol table.  In most cases there is no minimal symbol table yet
    for this objfile, and the existing bunches are used to create one.  Once
@@ -1305,6 +1293,7 @@ minimal_symbol_reader::install ()
 	 yet.  (And if the msymbol obstack gets moved, all the internal
 	 pointers to other msymbols need to be adjusted.)  */
       build_minimal_symbol_hash_tables (m_objfile);
+      build_minimal_symbol_pc_index (m_objfile);
     }
 }
 
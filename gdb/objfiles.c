@@ -52,6 +52,7 @@
 #include "solist.h"
 #include "gdb_bfd.h"
 #include "btrace.h"
+#include "dwarf-index-cache.h"
 
 #include <vector>
 
@@ -834,6 +835,11 @@ objfile_relocate1 (struct objfile *objfile,
   if (!something_changed)
     return 0;
 
+  /* An index of this objfile may still be being written to the index
+     cache in the background, from the address map and section offsets
+     changed below.  */
+  index_cache_wait (objfile);
+
   /* OK, get all the symtabs.  */
   {
     struct compunit_symtab *cust;
@@ -240,6 +240,15 @@ struct objfile_per_bfd_storage
   minimal_symbol *msymbols = NULL;
   int minimal_symbol_count = 0;
 
+  /* The raw addresses and the sizes of the minimal symbols in
+     MSYMBOLS, in the same order (that is, sorted by address).  They
+     are kept apart from the minimal symbols themselves so that
+     looking up a minimal symbol by address only touches a few cache
+     lines.  See lookup_minimal_symbol_by_pc_section.  */
+
+  CORE_ADDR *msymbol_addrs = NULL;
+  unsigned long *msymbol_sizes = NULL;
+
   /* The number of minimal symbols read, before any minimal symbol
      de-duplication is applied.  Note in particular that this has only
      a passing relationship with the actual size of the table above;
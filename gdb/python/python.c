@@ -34,6 +34,7 @@
 #include "extension-priv.h"
 #include "cli/cli-utils.h"
 #include <ctype.h>
+#include <algorithm>
 #include "location.h"
 #include "ser-event.h"
 
@@ -778,6 +779,147 @@ gdbpy_find_pc_line (PyObject *self, PyObject *args)
   return result;
 }
 
+/* The result of symbolizing one PC with gdb.symbolize_pcs.  */
+
+struct pc_symbolization
+{
+  /* The name of the function containing the PC, or NULL.  */
+  const char *function;
+
+  /* The name of the source file containing the PC, or NULL.  */
+  const char *filename;
+
+  /* The line number of the PC, or 0 if it is not known.  */
+  int line;
+};
+
+/* Implementation of gdb.symbolize_pcs.  The PCs are looked up in
+   ascending order, so that consecutive PCs that fall in the same
+   function or the same line table entry reuse the previous lookup
+   instead of searching the symbol tables again.  */
+
+static PyObject *
+gdbpy_symbolize_pcs (PyObject *self, PyObject *args)
+{
+  PyObject *pcs_obj;
+
+  if (!PyArg_ParseTuple (args, "O", &pcs_obj))
+    return NULL;
+
+  gdbpy_ref<> iter (PyObject_GetIter (pcs_obj));
+  if (iter == NULL)
+    return NULL;
+
+  std::vector<CORE_ADDR> pcs;
+  while (true)
+    {
+      gdbpy_ref<> item (PyIter_Next (iter.get ()));
+      CORE_ADDR pc;
+
+      if (item == NULL)
+	{
+	  if (PyErr_Occurred ())
+	    return NULL;
+	  break;
+	}
+
+      if (get_addr_from_python (item.get (), &pc) < 0)
+	return NULL;
+      pcs.push_back (pc);
+    }
+
+  std::vector<size_t> order (pcs.size ());
+  for (size_t i = 0; i < order.size (); ++i)
+    order[i] = i;
+  std::stable_sort (order.begin (), order.end (),
+		    [&] (size_t a, size_t b) { return pcs[a] < pcs[b]; });
+
+  std::vector<pc_symbolization> results (pcs.size ());
+
+  TRY
+    {
+      const char *function = NULL;
+      CORE_ADDR func_low = 0, func_high = 0;
+      struct symtab_and_line sal;
+
+      for (size_t i : order)
+	{
+	  CORE_ADDR pc = pcs[i];
+
+	  if (pc < func_low || pc >= func_high)
+	    {
+	      if (!find_pc_partial_function (pc, &function,
+					     &func_low, &func_high))
+		{
+		  function = NULL;
+		  func_low = func_high = 0;
+		}
+	    }
+
+	  if (pc < sal.pc || pc >= sal.end)
+	    sal = find_pc_line (pc, 0);
+
+	  results[i].function = function;
+	  if (sal.symtab != NULL)
+	    {
+	      results[i].filename = symtab_to_filename_for_display (sal.symtab);
+	      results[i].line = sal.line;
+	    }
+	  else
+	    {
+	      results[i].filename = NULL;
+	      results[i].line = 0;
+	    }
+	}
+    }
+  CATCH (except, RETURN_MASK_ALL)
+    {
+      GDB_PY_HANDLE_EXCEPTION (except);
+    }
+  END_CATCH
+
+  gdbpy_ref<> list (PyList_New (results.size ()));
+  if (list == NULL)
+    return NULL;
+
+  /* Most PCs share their function and file with their neighbors, so
+     reuse the Python string made for the previous one when the name
+     is the same.  */
+  const char *last_function = NULL, *last_filename = NULL;
+  gdbpy_ref<> function_obj, filename_obj;
+
+  for (size_t i = 0; i < results.size (); ++i)
+    {
+      const pc_symbolization &r = results[i];
+
+      if (r.function != NULL && r.function != last_function)
+	{
+	  function_obj.reset (host_string_to_python_string (r.function));
+	  if (function_obj == NULL)
+	    return NULL;
+	  last_function = r.function;
+	}
+      if (r.filename != NULL && r.filename != last_filename)
+	{
+	  filename_obj.reset (host_string_to_python_string (r.filename));
+	  if (filename_obj == NULL)
+	    return NULL;
+	  last_filename = r.filename;
+	}
+
+      PyObject *tuple
+	= Py_BuildValue ("(OOi)",
+			 r.function != NULL ? function_obj.get () : Py_None,
+			 r.filename != NULL ? filename_obj.get () : Py_None,
+			 r.line);
+      if (tuple == NULL)
+	return NULL;
+      PyList_SET_ITEM (list.get (), i, tuple);
+    }
+
+  return list.release ();
+}
+
 /* Implementation of gdb.invalidate_cached_frames.  */
 
 static PyObject *
@@ -1902,6 +2044,10 @@ Parse String as an expression, evaluate it, and return the result as a Value."
   { "find_pc_line", gdbpy_find_pc_line, METH_VARARGS,
     "find_pc_line (pc) -> Symtab_and_line.\n\
 Return the gdb.Symtab_and_line object corresponding to the pc value." },
+  { "symbolize_pcs", gdbpy_symbolize_pcs, METH_VARARGS,
+    "symbolize_pcs (pcs) -> List.\n\
+Return a list of (function, filename, line) tuples, one for each pc\n\
+value in the iterable PCS, in the same order." },
 
   { "post_event", gdbpy_post_event, METH_VARARGS,
     "Post an event into gdb's event loop." },
@@ -37,6 +37,11 @@
 #include "gdbcmd.h"
 #include "source.h"
 #include "readline/readline.h"
+#include "minsyms.h"
+#include "value.h"
+#include <algorithm>
+#include <chrono>
+#include <random>
 
 #include "psymtab.h"
 
@@ -972,6 +977,59 @@ maintenance_expand_symtabs (char *args, int from_tty)
 }
 
 
+/* Look up the address of every text minimal symbol by PC, REPEAT
+   times, and report how many lookups per second were done.  */
+
+static void
+maintenance_time_minsym_lookups (char *args, int from_tty)
+{
+  struct objfile *objfile;
+  struct minimal_symbol *msymbol;
+  std::vector<CORE_ADDR> pcs;
+  LONGEST repeat = 1;
+  ULONGEST found = 0;
+
+  if (args != NULL && *args != '\0')
+    {
+      repeat = parse_and_eval_long (args);
+      if (repeat <= 0)
+	error (_("The repeat count must be positive."));
+    }
+
+  /* Look up an address in the middle of each function, in a random
+     but reproducible order, like the PCs of a large backtrace.  */
+  ALL_MSYMBOLS (objfile, msymbol)
+    {
+      if (msymbol_is_text (msymbol))
+	pcs.push_back (MSYMBOL_VALUE_ADDRESS (objfile, msymbol)
+		       + MSYMBOL_SIZE (msymbol) / 2);
+    }
+
+  if (pcs.empty ())
+    error (_("No text minimal symbols to look up."));
+
+  std::shuffle (pcs.begin (), pcs.end (), std::minstd_rand ());
+
+  std::chrono::steady_clock::time_point start
+    = std::chrono::steady_clock::now ();
+
+  for (LONGEST i = 0; i < repeat; ++i)
+    for (CORE_ADDR pc : pcs)
+      if (lookup_minimal_symbol_by_pc (pc).minsym != NULL)
+	++found;
+
+  std::chrono::duration<double> elapsed
+    = std::chrono::steady_clock::now () - start;
+  ULONGEST lookups = repeat * pcs.size ();
+
+  printf_filtered (_("%s lookups (%s found) in %.3f seconds"),
+		   pulongest (lookups), pulongest (found), elapsed.count ());
+  if (elapsed.count () > 0)
+    printf_filtered (_(", %.0f lookups per second"),
+		     lookups / elapsed.count ());
+  printf_filtered (".\n");
+}
+
 /* Return the nexting depth of a block within other blocks in its symtab.  */
 
 static int
@@ -1125,4 +1183,13 @@ Check consistency of currently expanded symtabs."),
 	   _("Expand symbol tables.\n\
 With an argument REGEXP, only expand the symbol tables with matching names."),
 	   &maintenancelist);
+
+  add_cmd ("time-minsym-lookups", class_maintenance,
+	   maintenance_time_minsym_lookups, _("\
+Measure the speed of minimal symbol lookups by address.\n\
+Usage: mt time-minsym-lookups [REPEAT]\n\
+Look up an address inside each text minimal symbol of every object\n\
+file, REPEAT times (default 1), and print the number of lookups per\n\
+second."),
+	   &maintenancelist);
 }
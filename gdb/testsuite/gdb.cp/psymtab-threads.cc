@@ -0,0 +1,51 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2017 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+namespace ns
+{
+  typedef unsigned int ns_uint;
+
+  enum color { red, green, blue };
+
+  struct S
+  {
+    int f ();
+    static ns_uint s;
+  };
+
+  int S::f () { return s; }
+
+  ns_uint S::s = 1;
+
+  template<typename T> T twice (T x) { return x + x; }
+}
+
+typedef ns::color color_t;
+
+enum plain_enum { one, two };
+
+extern int other (int);
+
+int
+main ()
+{
+  ns::S s;
+  color_t c = ns::green;
+  plain_enum e = two;
+
+  return s.f () + other (ns::twice (1)) + c + e;
+}
@@ -26,6 +26,7 @@
 #include <cstring>
 #include <climits>
 #include <vector>
+#include <algorithm>
 #include "libiberty.h"
 #include "filenames.h"
 
@@ -769,13 +770,14 @@ Archive::read_symbols(off_t off)
 
 bool
 Archive::add_symbols(Symbol_table* symtab, Layout* layout,
-		     Input_objects* input_objects, Mapfile* mapfile)
+		     Input_objects* input_objects, Mapfile* mapfile,
+		     Workqueue* workqueue)
 {
   ++Archive::total_archives;
 
   if (this->input_file_->options().whole_archive())
     return this->include_all_members(symtab, layout, input_objects,
-				     mapfile);
+				     mapfile, workqueue);
 
   Archive::total_members += this->num_members_;
 
@@ -893,10 +895,13 @@ Archive::defines_symbol(Symbol* sym) const
 }
 
 // Include all the archive members in the link.  This is for --whole-archive.
+// If we are running several threads, all but the first member are
+// read using include_members_in_parallel.
 
 bool
 Archive::include_all_members(Symbol_table* symtab, Layout* layout,
-                             Input_objects* input_objects, Mapfile* mapfile)
+                             Input_objects* input_objects, Mapfile* mapfile,
+			     Workqueue* workqueue)
 {
   // Don't include the same archive twice.  This can happen if
   // --whole-archive is nested inside --start-group (PR gold/12163).
@@ -922,15 +927,35 @@ Archive::include_all_members(Symbol_table* symtab, Layout* layout,
     }
   else
     {
+      // Members of a thin archive are separate files which may be
+      // opened on demand, and plugins may claim any member, so we
+      // only read the members of an ordinary archive in parallel.
+      bool parallel = (workqueue != NULL
+		       && workqueue->thread_count() > 1
+		       && !this->is_thin_archive_
+		       && !parameters->options().has_plugins());
+      std::vector<off_t> offsets;
       for (Archive::const_iterator p = this->begin();
            p != this->end();
            ++p)
         {
+	  // We include members one at a time until we have included
+	  // one, so that an incompatible first member still makes us
+	  // look for another archive.
+	  if (parallel && this->included_member_)
+	    {
+	      offsets.push_back(p->off);
+	      continue;
+	    }
           if (!this->include_member(symtab, layout, input_objects, p->off,
 				    mapfile, NULL, "--whole-archive"))
 	    return false;
           ++Archive::total_members;
         }
+
+      if (!offsets.empty())
+	this->include_members_in_parallel(symtab, layout, input_objects,
+					  mapfile, workqueue, offsets);
     }
 
   input_objects->archive_stop(this);
@@ -938,6 +963,172 @@ Archive::include_all_members(Symbol_table* symtab, Layout* layout,
   return true;
 }
 
+// The members of an archive to read on several threads.  Each item
+// reads the symbols of one member.  Errors found while reading a
+// member are saved with the member, so that they can be printed in
+// archive order.
+
+class Archive_read_members_work : public Parallel_work
+{
+ public:
+  // A member to read.
+  struct Member
+  {
+    Member(Object* o, Read_symbols_data* s, bool r)
+      : obj(o), sd(s), needs_read(r), messages()
+    { }
+
+    // The object, or NULL if there was an error.
+    Object* obj;
+    // The symbols.
+    Read_symbols_data* sd;
+    // Whether we need to read the symbols, rather than using the
+    // ones read by --preread-archive-symbols.
+    bool needs_read;
+    // The errors reported while reading the member.
+    std::vector<std::string> messages;
+  };
+
+  Archive_read_members_work(const std::string& name)
+    : Parallel_work(name), read_lock_(), members_()
+  { }
+
+  // A lock for reading the archive while several threads are
+  // running.
+  Lock*
+  read_lock()
+  { return &this->read_lock_; }
+
+  // Add a member which we must read.  OBJ may be NULL if there was
+  // an error.
+  void
+  add_member(Object* obj)
+  {
+    Read_symbols_data* sd = obj == NULL ? NULL : new Read_symbols_data;
+    this->members_.push_back(Member(obj, sd, true));
+  }
+
+  // Add a member which has already been read.
+  void
+  add_read_member(const Archive_member& member)
+  { this->members_.push_back(Member(member.obj_, member.sd_, false)); }
+
+  // The number of members.
+  unsigned int
+  member_count() const
+  { return this->members_.size(); }
+
+  // Return member I.
+  Member&
+  member(unsigned int i)
+  { return this->members_[i]; }
+
+ protected:
+  void
+  do_item(unsigned int i)
+  {
+    Member& member(this->members_[i]);
+    if (member.obj != NULL && member.needs_read)
+      {
+	member.obj->set_error_messages(&member.messages);
+	member.obj->read_symbols(member.sd);
+	member.obj->parse_sections(member.sd);
+	member.obj->set_error_messages(NULL);
+      }
+  }
+
+ private:
+  // Lock passed to File_read::set_read_lock.
+  Lock read_lock_;
+  // The members to read.
+  std::vector<Member> members_;
+};
+
+// The number of members read at once by include_members_in_parallel.
+// This bounds the number of Read_symbols_data structures we keep.
+static const size_t parallel_archive_members_batch = 256;
+
+// Include the members at OFFSETS in the link.  We read the section
+// headers and symbols of a batch of members on several threads, then
+// add them to the link one at a time in archive order, so that
+// symbol resolution and error messages do not depend on the number
+// of threads.  Errors in the member headers are found when we set up
+// the batch, on this thread, and so are printed before the errors
+// found while reading the batch.  As in include_member, a member
+// which was already read by --preread-archive-symbols is not read
+// again.
+
+void
+Archive::include_members_in_parallel(Symbol_table* symtab, Layout* layout,
+				     Input_objects* input_objects,
+				     Mapfile* mapfile, Workqueue* workqueue,
+				     const std::vector<off_t>& offsets)
+{
+  File_read& file(this->input_file_->file());
+  unsigned int helpers = workqueue->thread_count() - 1;
+  for (size_t start = 0; start < offsets.size();
+       start += parallel_archive_members_batch)
+    {
+      size_t end = std::min(offsets.size(),
+			    start + parallel_archive_members_batch);
+      Archive_read_members_work* work =
+	new Archive_read_members_work(this->name());
+      for (size_t i = start; i < end; ++i)
+	{
+	  std::map<off_t, Archive_member>::const_iterator p =
+	    this->members_.find(offsets[i]);
+	  if (p != this->members_.end())
+	    work->add_read_member(p->second);
+	  else
+	    work->add_member(this->get_elf_object_for_member(offsets[i],
+							     NULL));
+	}
+
+      file.set_read_lock(work->read_lock());
+      work->run(workqueue, work->member_count(), helpers);
+      file.set_read_lock(NULL);
+
+      for (unsigned int i = 0; i < work->member_count(); ++i)
+	{
+	  ++Archive::total_members_loaded;
+	  ++Archive::total_members;
+
+	  Archive_read_members_work::Member& member(work->member(i));
+	  for (std::vector<std::string>::const_iterator p =
+		 member.messages.begin();
+	       p != member.messages.end();
+	       ++p)
+	    gold_error("%s", p->c_str());
+
+	  Object* obj = member.obj;
+	  Read_symbols_data* sd = member.sd;
+	  if (obj == NULL)
+	    continue;
+
+	  if (mapfile != NULL)
+	    mapfile->report_include_archive_member(obj->name(), NULL,
+						   "--whole-archive");
+	  if (!input_objects->add_object(obj))
+	    {
+	      delete sd;
+	      if (member.needs_read)
+		delete obj;
+	      continue;
+	    }
+
+	  if (member.needs_read && layout->incremental_inputs() != NULL)
+	    layout->incremental_inputs()->report_object(obj, 0, this, NULL);
+
+	  obj->layout(symtab, layout, sd);
+	  obj->add_symbols(symtab, sd, layout);
+	  delete sd;
+	  this->included_member_ = true;
+	}
+
+      work->release();
+    }
+}
+
 // Return the number of members in the archive.  This is only used for
 // reports.
 
@@ -1132,7 +1323,7 @@ Add_archive_symbols::run(Workqueue* workqueue)
 
   bool added = this->archive_->add_symbols(this->symtab_, this->layout_,
 					   this->input_objects_,
-					   this->mapfile_);
+					   this->mapfile_, workqueue);
   this->archive_->unlock_nested_archives();
 
   this->archive_->release();
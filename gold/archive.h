@@ -243,9 +243,10 @@ class Archive : public Library_base
   unlock_nested_archives();
 
   // Select members from the archive as needed and add them to the
-  // link.
+  // link.  WORKQUEUE is used to read members on several threads.
   bool
-  add_symbols(Symbol_table*, Layout*, Input_objects*, Mapfile*);
+  add_symbols(Symbol_table*, Layout*, Input_objects*, Mapfile*,
+	      Workqueue*);
 
   // Return whether the archive defines the symbol.
   bool
@@ -333,7 +334,15 @@ class Archive : public Library_base
 
   // Include all the archive members in the link.
   bool
-  include_all_members(Symbol_table*, Layout*, Input_objects*, Mapfile*);
+  include_all_members(Symbol_table*, Layout*, Input_objects*, Mapfile*,
+		      Workqueue*);
+
+  // Include the archive members at OFFSETS in the link, reading them
+  // on several threads.
+  void
+  include_members_in_parallel(Symbol_table*, Layout*, Input_objects*,
+			      Mapfile*, Workqueue*,
+			      const std::vector<off_t>& offsets);
 
   // Include an archive member in the link.
   bool
@@ -21,14 +21,220 @@
 // MA 02110-1301, USA.
 
 #include "gold.h"
+#include <algorithm>
+#include <vector>
 #include <zlib.h>
 #include "parameters.h"
 #include "options.h"
+#include "workqueue.h"
 #include "compressed_output.h"
 
 namespace gold
 {
 
+// Data larger than this is compressed in chunks of this size, which
+// may be compressed on several threads.  Each chunk is a raw deflate
+// stream which uses the end of the previous chunk as its dictionary.
+// All but the last chunk end with a sync flush, which leaves them on
+// a byte boundary, so the chunks concatenate into a single zlib
+// stream.  The chunks do not depend on the number of threads, so
+// neither does the output.
+
+static const unsigned long zlib_chunk_size = 1024 * 1024;
+
+// The size of the deflate window, and so of the dictionary.
+
+static const unsigned long zlib_window_size = 32 * 1024;
+
+// Compress data in chunks.  Each item is one chunk.
+
+class Zlib_compress_work : public Parallel_work
+{
+ public:
+  Zlib_compress_work(const unsigned char* data, unsigned long size,
+		     int level)
+    : Parallel_work("zlib"), data_(data), size_(size), level_(level),
+      chunks_((size + zlib_chunk_size - 1) / zlib_chunk_size)
+  { }
+
+  ~Zlib_compress_work()
+  {
+    for (std::vector<Chunk>::iterator p = this->chunks_.begin();
+	 p != this->chunks_.end();
+	 ++p)
+      delete[] p->data;
+  }
+
+  // The number of chunks.
+  unsigned int
+  chunk_count() const
+  { return this->chunks_.size(); }
+
+  // Put the compressed chunks together into a zlib stream, as
+  // described for zlib_compress.
+  bool
+  get_result(int header_size, unsigned char** compressed_data,
+	     unsigned long* compressed_size) const;
+
+ protected:
+  void
+  do_item(unsigned int i);
+
+ private:
+  // One compressed chunk.
+  struct Chunk
+  {
+    Chunk()
+      : data(NULL), size(0), adler(0), ok(false)
+    { }
+
+    // The compressed data, allocated with new.
+    unsigned char* data;
+    // The size of the compressed data.
+    unsigned long size;
+    // The Adler-32 checksum of the uncompressed data.
+    uLong adler;
+    // Whether the chunk was compressed successfully.
+    bool ok;
+  };
+
+  // The data to compress.
+  const unsigned char* data_;
+  // The size of the data.
+  unsigned long size_;
+  // The compression level.
+  int level_;
+  // The chunks.
+  std::vector<Chunk> chunks_;
+};
+
+// Compress chunk I.
+
+void
+Zlib_compress_work::do_item(unsigned int i)
+{
+  Chunk& chunk(this->chunks_[i]);
+  unsigned long start = i * zlib_chunk_size;
+  unsigned long len = std::min(zlib_chunk_size, this->size_ - start);
+  bool last = start + len == this->size_;
+  const Bytef* in = reinterpret_cast<const Bytef*>(this->data_ + start);
+
+  chunk.adler = adler32(adler32(0, NULL, 0), in, len);
+
+  z_stream strm;
+  strm.zalloc = NULL;
+  strm.zfree = NULL;
+  strm.opaque = NULL;
+  if (deflateInit2(&strm, this->level_, Z_DEFLATED, -15, 8,
+		   Z_DEFAULT_STRATEGY) != Z_OK)
+    return;
+
+  bool ok = true;
+  if (start > 0)
+    {
+      unsigned long dict_size = std::min(start, zlib_window_size);
+      ok = deflateSetDictionary(&strm, in - dict_size, dict_size) == Z_OK;
+    }
+
+  if (ok)
+    {
+      // Leave room for the sync flush marker.
+      unsigned long bound = deflateBound(&strm, len) + 16;
+      chunk.data = new unsigned char[bound];
+      strm.next_in = const_cast<Bytef*>(in);
+      strm.avail_in = len;
+      strm.next_out = chunk.data;
+      strm.avail_out = bound;
+      int rc = deflate(&strm, last ? Z_FINISH : Z_SYNC_FLUSH);
+      if (last)
+	ok = rc == Z_STREAM_END;
+      else
+	ok = rc == Z_OK && strm.avail_in == 0 && strm.avail_out > 0;
+      chunk.size = bound - strm.avail_out;
+    }
+
+  deflateEnd(&strm);
+  chunk.ok = ok;
+}
+
+// Put the chunks together.
+
+bool
+Zlib_compress_work::get_result(int header_size,
+			       unsigned char** compressed_data,
+			       unsigned long* compressed_size) const
+{
+  // The zlib header, computed the way deflate does.
+  unsigned int level_flags;
+  if (this->level_ < 2)
+    level_flags = 0;
+  else if (this->level_ < 6)
+    level_flags = 1;
+  else if (this->level_ == 6)
+    level_flags = 2;
+  else
+    level_flags = 3;
+  unsigned int header = (Z_DEFLATED + (7 << 4)) << 8 | level_flags << 6;
+  header += 31 - header % 31;
+
+  unsigned long size = 2 + 4;
+  uLong adler = adler32(0, NULL, 0);
+  unsigned long start = 0;
+  for (std::vector<Chunk>::const_iterator p = this->chunks_.begin();
+       p != this->chunks_.end();
+       ++p)
+    {
+      if (!p->ok)
+	return false;
+      size += p->size;
+      unsigned long len = std::min(zlib_chunk_size, this->size_ - start);
+      adler = adler32_combine(adler, p->adler, len);
+      start += len;
+    }
+
+  unsigned char* out = new unsigned char[header_size + size];
+  unsigned char* pout = out + header_size;
+  elfcpp::Swap_unaligned<16, true>::writeval(pout, header);
+  pout += 2;
+  for (std::vector<Chunk>::const_iterator p = this->chunks_.begin();
+       p != this->chunks_.end();
+       ++p)
+    {
+      memcpy(pout, p->data, p->size);
+      pout += p->size;
+    }
+  elfcpp::Swap_unaligned<32, true>::writeval(pout, adler);
+
+  *compressed_data = out;
+  *compressed_size = header_size + size;
+  return true;
+}
+
+// Compress UNCOMPRESSED_DATA in chunks, using WORKQUEUE, if not NULL,
+// to compress them on several threads.  The arguments are as for
+// zlib_compress.
+
+static bool
+zlib_compress_in_chunks(int header_size,
+			const unsigned char* uncompressed_data,
+			unsigned long uncompressed_size,
+			int compress_level,
+			unsigned char** compressed_data,
+			unsigned long* compressed_size,
+			Workqueue* workqueue)
+{
+  Zlib_compress_work* work = new Zlib_compress_work(uncompressed_data,
+						    uncompressed_size,
+						    compress_level);
+  unsigned int helpers = 0;
+  if (workqueue != NULL)
+    helpers = workqueue->thread_count() - 1;
+  work->run(workqueue, work->chunk_count(), helpers);
+  bool ok = work->get_result(header_size, compressed_data, compressed_size);
+  work->release();
+  return ok;
+}
+
 // Compress UNCOMPRESSED_DATA of size UNCOMPRESSED_SIZE.  Returns true
 // if it successfully compressed, false if it failed for any reason
 // (including not having zlib support in the library).  If it returns
@@ -36,24 +242,33 @@ namespace gold
 // sets *COMPRESSED_DATA and *COMPRESSED_SIZE to appropriate values.
 // It also writes a header before COMPRESSED_DATA: 4 bytes saying
 // "ZLIB", and 8 bytes indicating the uncompressed size, in big-endian
-// order.
+// order.  Large data is compressed in chunks, on several threads if
+// WORKQUEUE is not NULL.
 
 static bool
 zlib_compress(int header_size,
               const unsigned char* uncompressed_data,
               unsigned long uncompressed_size,
               unsigned char** compressed_data,
-              unsigned long* compressed_size)
+              unsigned long* compressed_size,
+              Workqueue* workqueue)
 {
-  *compressed_size = uncompressed_size + uncompressed_size / 1000 + 128;
-  *compressed_data = new unsigned char[*compressed_size + header_size];
-
   int compress_level;
   if (parameters->options().optimize() >= 1)
     compress_level = 9;
   else
     compress_level = 1;
 
+  if (uncompressed_size > zlib_chunk_size
+      && zlib_compress_in_chunks(header_size, uncompressed_data,
+				 uncompressed_size, compress_level,
+				 compressed_data, compressed_size,
+				 workqueue))
+    return true;
+
+  *compressed_size = uncompressed_size + uncompressed_size / 1000 + 128;
+  *compressed_data = new unsigned char[*compressed_size + header_size];
+
   int rc = compress2(reinterpret_cast<Bytef*>(*compressed_data) + header_size,
                      compressed_size,
                      reinterpret_cast<const Bytef*>(uncompressed_data),
@@ -251,7 +466,7 @@ Output_compressed_section::set_final_data_size()
   if (compress != none)
     success = zlib_compress(compression_header_size, uncompressed_data,
 			    uncompressed_size, &this->data_,
-			    &compressed_size);
+			    &compressed_size, this->workqueue_);
   if (success)
     {
       elfcpp::Elf_Xword flags = this->flags();
@@ -36,6 +36,7 @@ namespace gold
 {
 
 class General_options;
+class Workqueue;
 
 // Read the compression header of a compressed debug section and return
 // the uncompressed size.
@@ -60,9 +61,15 @@ class Output_compressed_section : public Output_section
 			    const char* name, elfcpp::Elf_Word flags,
 			    elfcpp::Elf_Xword type)
     : Output_section(name, flags, type),
-      options_(options)
+      options_(options), workqueue_(NULL), data_(NULL)
   { this->set_requires_postprocessing(); }
 
+  // Set the workqueue which may be used to compress the contents on
+  // several threads.
+  void
+  set_workqueue(Workqueue* workqueue)
+  { this->workqueue_ = workqueue; }
+
  protected:
   // Set the final data size.
   void
@@ -75,6 +82,8 @@ class Output_compressed_section : public Output_section
  private:
   // The options--this includes the compression type.
   const General_options* options_;
+  // The workqueue, or NULL.
+  Workqueue* workqueue_;
   // The compressed data.
   unsigned char* data_;
   // The new section name if we do compress.
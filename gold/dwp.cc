@@ -432,7 +432,7 @@ class Sized_relobj_dwo : public Sized_relobj<size, big_endian>
 
   // Relocate the input sections and write out the local symbols.
   void
-  do_relocate(const Symbol_table*, const Layout*, Output_file*)
+  do_relocate(const Symbol_table*, const Layout*, Output_file*, Workqueue*)
   { gold_unreachable(); }
 
  private:
@@ -29,6 +29,7 @@
 #include "dwarf.h"
 #include "symtab.h"
 #include "reloc.h"
+#include "workqueue.h"
 #include "ehframe.h"
 
 namespace gold
@@ -84,10 +85,99 @@ Eh_frame_hdr::Eh_frame_hdr(Output_section* eh_frame_section,
     eh_frame_section_(eh_frame_section),
     eh_frame_data_(eh_frame_data),
     fde_offsets_(),
+    workqueue_(NULL),
     any_unrecognized_eh_frame_sections_(false)
 {
 }
 
+// The minimum number of FDEs to sort in one piece of work when
+// sorting the table on several threads.
+
+static const size_t fde_sort_chunk_size = 16384;
+
+// Sort the FDE table on several threads.  The table is split into
+// runs of at least fde_sort_chunk_size FDEs.  The runs are sorted, and
+// then pairs of sorted runs are merged until one run remains.  Since
+// the comparison is a total order, the result is the same as sorting
+// the table in one piece.
+
+template<typename Iterator, typename Compare>
+class Fde_sort_work : public Parallel_work
+{
+ public:
+  // Sort the runs of [BOUNDS[I], BOUNDS[I + 1]) if WIDTH is zero.
+  // Otherwise merge the sorted runs of WIDTH runs starting at
+  // BOUNDS[2 * I * WIDTH] with the following WIDTH runs.
+  Fde_sort_work(const std::vector<Iterator>& bounds, unsigned int width,
+		Compare compare)
+    : Parallel_work("sort eh_frame_hdr"), bounds_(bounds), width_(width),
+      compare_(compare)
+  { }
+
+  // Sort [BEGIN, END) using WORKQUEUE.
+  static void
+  sort(Workqueue* workqueue, Iterator begin, Iterator end, Compare compare)
+  {
+    unsigned int helpers = 0;
+    if (workqueue != NULL)
+      helpers = workqueue->thread_count() - 1;
+    size_t count = end - begin;
+    size_t runs = std::min(static_cast<size_t>(helpers + 1),
+			   count / fde_sort_chunk_size);
+    if (runs < 2)
+      {
+	std::sort(begin, end, compare);
+	return;
+      }
+
+    std::vector<Iterator> bounds;
+    for (size_t i = 0; i < runs; ++i)
+      bounds.push_back(begin + (count * i) / runs);
+    bounds.push_back(end);
+
+    run_work(workqueue, bounds, 0, runs, helpers, compare);
+    for (unsigned int width = 1; width < runs; width *= 2)
+      run_work(workqueue, bounds, width, (runs + 2 * width - 1) / (2 * width),
+	       helpers, compare);
+  }
+
+ protected:
+  void
+  do_item(unsigned int i)
+  {
+    unsigned int runs = this->bounds_.size() - 1;
+    if (this->width_ == 0)
+      {
+	std::sort(this->bounds_[i], this->bounds_[i + 1], this->compare_);
+	return;
+      }
+
+    unsigned int first = 2 * i * this->width_;
+    unsigned int middle = first + this->width_;
+    if (middle >= runs)
+      return;
+    unsigned int last = std::min(middle + this->width_, runs);
+    std::inplace_merge(this->bounds_[first], this->bounds_[middle],
+		       this->bounds_[last], this->compare_);
+  }
+
+ private:
+  // Do ITEMS items of one pass.
+  static void
+  run_work(Workqueue* workqueue, const std::vector<Iterator>& bounds,
+	   unsigned int width, unsigned int items, unsigned int helpers,
+	   Compare compare)
+  {
+    Fde_sort_work* work = new Fde_sort_work(bounds, width, compare);
+    work->run(workqueue, items, std::min(helpers, items - 1));
+    work->release();
+  }
+
+  std::vector<Iterator> bounds_;
+  unsigned int width_;
+  Compare compare_;
+};
+
 // Set the size of the exception frame header.
 
 void
@@ -188,8 +278,11 @@ Eh_frame_hdr::do_sized_write(Output_file* of)
       this->get_fde_addresses<size, big_endian>(of, &this->fde_offsets_,
 						&fde_addresses);
 
-      std::sort(fde_addresses.begin(), fde_addresses.end(),
-		Fde_address_compare<size>());
+      Fde_sort_work<typename Fde_addresses<size>::iterator,
+		    Fde_address_compare<size> >::sort(this->workqueue_,
+						      fde_addresses.begin(),
+						      fde_addresses.end(),
+						      Fde_address_compare<size>());
 
       typename elfcpp::Elf_types<size>::Elf_Addr output_address;
       output_address = this->address();
@@ -588,7 +681,8 @@ Eh_frame::skip_leb128(const unsigned char** pp, const unsigned char* pend)
 // SHT_REL or SHT_RELA.  We try to parse the input exception frame
 // data into our data structures.  If we can't do it, we return false
 // to mean that the section should be handled as a normal input
-// section.
+// section.  If the section was already parsed when the object's
+// symbols were read, we only merge the result here.
 
 template<int size, bool big_endian>
 Eh_frame::Eh_frame_section_disposition
@@ -601,14 +695,52 @@ Eh_frame::add_ehframe_input_section(
     unsigned int shndx,
     unsigned int reloc_shndx,
     unsigned int reloc_type)
+{
+  Parsed_eh_frame_section* parsed = object->release_parsed_eh_frame(shndx);
+  if (parsed != NULL)
+    {
+      Eh_frame_section_disposition disp =
+	this->add_parsed_ehframe_section(object, symbols, symbols_size,
+					 parsed);
+      delete parsed;
+      return disp;
+    }
+
+  Parsed_eh_frame_section local_parsed(shndx);
+  parse_ehframe_input_section(object, symbols, symbols_size, symbol_names,
+			      symbol_names_size, reloc_shndx, reloc_type,
+			      &local_parsed);
+  return this->add_parsed_ehframe_section(object, symbols, symbols_size,
+					  &local_parsed);
+}
+
+// Parse the input section in OBJECT whose index is recorded in
+// PARSED.  This only looks at OBJECT, so it may run on several threads
+// at once.  We set the disposition of PARSED to say whether the
+// section can be optimized.
+
+template<int size, bool big_endian>
+void
+Eh_frame::parse_ehframe_input_section(
+    Sized_relobj_file<size, big_endian>* object,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    const unsigned char* symbol_names,
+    section_size_type symbol_names_size,
+    unsigned int reloc_shndx,
+    unsigned int reloc_type,
+    Parsed_eh_frame_section* parsed)
 {
   // Get the section contents.
   section_size_type contents_len;
-  const unsigned char* pcontents = object->section_contents(shndx,
+  const unsigned char* pcontents = object->section_contents(parsed->shndx(),
 							    &contents_len,
 							    false);
   if (contents_len == 0)
-    return EH_EMPTY_SECTION;
+    {
+      parsed->disposition_ = EH_EMPTY_SECTION;
+      return;
+    }
 
   // If this is the marker section for the end of the data, then
   // return false to force it to be handled as an ordinary input
@@ -616,57 +748,35 @@ Eh_frame::add_ehframe_input_section(
   // of unrecognized .eh_frame sections.
   if (contents_len == 4
       && elfcpp::Swap<32, big_endian>::readval(pcontents) == 0)
-    return EH_END_MARKER_SECTION;
-
-  New_cies new_cies;
-  if (!this->do_add_ehframe_input_section(object, symbols, symbols_size,
-					  symbol_names, symbol_names_size,
-					  shndx, reloc_shndx,
-					  reloc_type, pcontents,
-					  contents_len, &new_cies))
-    {
-      if (this->eh_frame_hdr_ != NULL)
-	this->eh_frame_hdr_->found_unrecognized_eh_frame_section();
-
-      for (New_cies::iterator p = new_cies.begin();
-	   p != new_cies.end();
-	   ++p)
-	delete p->first;
-
-      return EH_UNRECOGNIZED_SECTION;
-    }
-
-  // Now that we know we are using this section, record any new CIEs
-  // that we found.
-  for (New_cies::const_iterator p = new_cies.begin();
-       p != new_cies.end();
-       ++p)
     {
-      if (p->second)
-	this->cie_offsets_.insert(p->first);
-      else
-	this->unmergeable_cie_offsets_.push_back(p->first);
+      parsed->disposition_ = EH_END_MARKER_SECTION;
+      return;
     }
 
-  return EH_OPTIMIZABLE_SECTION;
+  if (do_parse_ehframe_input_section(object, symbols, symbols_size,
+				     symbol_names, symbol_names_size,
+				     reloc_shndx, reloc_type, pcontents,
+				     contents_len, parsed))
+    parsed->disposition_ = EH_OPTIMIZABLE_SECTION;
+  else
+    parsed->disposition_ = EH_UNRECOGNIZED_SECTION;
 }
 
-// The bulk of the implementation of add_ehframe_input_section.
+// The bulk of the implementation of parse_ehframe_input_section.
 
 template<int size, bool big_endian>
 bool
-Eh_frame::do_add_ehframe_input_section(
+Eh_frame::do_parse_ehframe_input_section(
     Sized_relobj_file<size, big_endian>* object,
     const unsigned char* symbols,
     section_size_type symbols_size,
     const unsigned char* symbol_names,
     section_size_type symbol_names_size,
-    unsigned int shndx,
     unsigned int reloc_shndx,
     unsigned int reloc_type,
     const unsigned char* pcontents,
     section_size_type contents_len,
-    New_cies* new_cies)
+    Parsed_eh_frame_section* parsed)
 {
   Track_relocs<size, big_endian> relocs;
 
@@ -718,17 +828,16 @@ Eh_frame::do_add_ehframe_input_section(
       if (id == 0)
 	{
 	  // CIE.
-	  if (!this->read_cie(object, shndx, symbols, symbols_size,
-			      symbol_names, symbol_names_size,
-			      pcontents, p, pentend, &relocs, &cies,
-			      new_cies))
+	  if (!read_cie(object, symbols, symbols_size, symbol_names,
+			symbol_names_size, pcontents, p, pentend, &relocs,
+			&cies, parsed))
 	    return false;
 	}
       else
 	{
 	  // FDE.
-	  if (!this->read_fde(object, shndx, symbols, symbols_size,
-			      pcontents, id, p, pentend, &relocs, &cies))
+	  if (!read_fde(object, symbols_size, pcontents, id, p, pentend,
+			&relocs, &cies, parsed))
 	    return false;
 	}
 
@@ -743,7 +852,6 @@ Eh_frame::do_add_ehframe_input_section(
 template<int size, bool big_endian>
 bool
 Eh_frame::read_cie(Sized_relobj_file<size, big_endian>* object,
-		   unsigned int shndx,
 		   const unsigned char* symbols,
 		   section_size_type symbols_size,
 		   const unsigned char* symbol_names,
@@ -753,7 +861,7 @@ Eh_frame::read_cie(Sized_relobj_file<size, big_endian>* object,
 		   const unsigned char* pcieend,
 		   Track_relocs<size, big_endian>* relocs,
 		   Offsets_to_cie* cies,
-		   New_cies* new_cies)
+		   Parsed_eh_frame_section* parsed)
 {
   bool mergeable = true;
 
@@ -946,48 +1054,38 @@ Eh_frame::read_cie(Sized_relobj_file<size, big_endian>* object,
   if (relocs->advance(pcieend - pcontents) > 0)
     return false;
 
-  Cie cie(object, shndx, (pcie - 8) - pcontents, fde_encoding, 
+  Cie cie(object, parsed->shndx(), (pcie - 8) - pcontents, fde_encoding,
 	  personality_name, pcie, pcieend - pcie);
-  Cie* cie_pointer = NULL;
+
+  // See if we already saw this CIE in this input section.  Whether
+  // we saw it in an earlier input section is decided when the
+  // section is merged.
+  Parsed_eh_frame_section::Cies* new_cies = &parsed->cies_;
+  unsigned int cie_index = new_cies->size();
   if (mergeable)
     {
-      Cie_offsets::iterator find_cie = this->cie_offsets_.find(&cie);
-      if (find_cie != this->cie_offsets_.end())
-	cie_pointer = *find_cie;
-      else
+      for (unsigned int i = 0; i < new_cies->size(); ++i)
 	{
-	  // See if we already saw this CIE in this object file.
-	  for (New_cies::const_iterator pc = new_cies->begin();
-	       pc != new_cies->end();
-	       ++pc)
+	  if (*(*new_cies)[i].first == cie)
 	    {
-	      if (*(pc->first) == cie)
-		{
-		  cie_pointer = pc->first;
-		  break;
-		}
+	      cie_index = i;
+	      break;
 	    }
 	}
     }
 
-  if (cie_pointer == NULL)
+  Parsed_eh_frame_section::Entry entry(Parsed_eh_frame_section::ENTRY_CIE,
+				       (pcie - 8) - pcontents,
+				       pcieend - (pcie - 8), cie_index);
+  if (cie_index == new_cies->size())
     {
-      cie_pointer = new Cie(cie);
-      new_cies->push_back(std::make_pair(cie_pointer, mergeable));
-    }
-  else
-    {
-      // We are deleting this CIE.  Record that in our mapping from
-      // input sections to the output section.  At this point we don't
-      // know for sure that we are doing a special mapping for this
-      // input section, but that's OK--if we don't do a special
-      // mapping, nobody will ever ask for the mapping we add here.
-      object->add_merge_mapping(this, shndx, (pcie - 8) - pcontents,
-                                pcieend - (pcie - 8), -1);
+      new_cies->push_back(std::make_pair(new Cie(cie), mergeable));
+      entry.is_first = true;
     }
+  parsed->entries_.push_back(entry);
 
   // Record this CIE plus the offset in the input section.
-  cies->insert(std::make_pair(pcie - pcontents, cie_pointer));
+  cies->insert(std::make_pair(pcie - pcontents, cie_index));
 
   return true;
 }
@@ -997,15 +1095,14 @@ Eh_frame::read_cie(Sized_relobj_file<size, big_endian>* object,
 template<int size, bool big_endian>
 bool
 Eh_frame::read_fde(Sized_relobj_file<size, big_endian>* object,
-		   unsigned int shndx,
-		   const unsigned char* symbols,
 		   section_size_type symbols_size,
 		   const unsigned char* pcontents,
 		   unsigned int offset,
 		   const unsigned char* pfde,
 		   const unsigned char* pfdeend,
 		   Track_relocs<size, big_endian>* relocs,
-		   Offsets_to_cie* cies)
+		   const Offsets_to_cie* cies,
+		   Parsed_eh_frame_section* parsed)
 {
   // OFFSET is the distance between the 4 bytes before PFDE to the
   // start of the CIE.  The offset we recorded for the CIE is 8 bytes
@@ -1014,7 +1111,12 @@ Eh_frame::read_fde(Sized_relobj_file<size, big_endian>* object,
   Offsets_to_cie::const_iterator pcie = cies->find(cie_offset);
   if (pcie == cies->end())
     return false;
-  Cie* cie = pcie->second;
+  unsigned int cie_index = pcie->second;
+  const Cie* cie = parsed->cies_[cie_index].first;
+
+  Parsed_eh_frame_section::Entry entry(Parsed_eh_frame_section::ENTRY_FDE,
+				       (pfde - 8) - pcontents,
+				       pfdeend - (pfde - 8), cie_index);
 
   int pc_size = 0;
   switch (cie->fde_encoding() & 7)
@@ -1070,8 +1172,8 @@ Eh_frame::read_fde(Sized_relobj_file<size, big_endian>* object,
 	{
 	  // This FDE applies to a discarded function.  We
 	  // can discard this FDE.
-	  object->add_merge_mapping(this, shndx, (pfde - 8) - pcontents,
-				    pfdeend - (pfde - 8), -1);
+	  entry.kind = Parsed_eh_frame_section::ENTRY_DISCARDED_FDE;
+	  parsed->entries_.push_back(entry);
 	  return true;
 	}
 
@@ -1089,20 +1191,12 @@ Eh_frame::read_fde(Sized_relobj_file<size, big_endian>* object,
   // pointer to a PC relative offset when generating a shared library.
   relocs->advance(pfdeend - pcontents);
 
-  // Find the section index for code that this FDE describes.
-  // If we have discarded the section, we can also discard the FDE.
-  unsigned int fde_shndx;
+  // The FDE can be discarded if we discard the section with the code
+  // that it describes, but we don't know that yet.
   const int sym_size = elfcpp::Elf_sizes<size>::sym_size;
   if (symndx >= symbols_size / sym_size)
     return false;
-  elfcpp::Sym<size, big_endian> sym(symbols + symndx * sym_size);
-  bool is_ordinary;
-  fde_shndx = object->adjust_sym_shndx(symndx, sym.get_st_shndx(),
-				       &is_ordinary);
-  bool is_discarded = (is_ordinary
-		       && fde_shndx != elfcpp::SHN_UNDEF
-		       && fde_shndx < object->shnum()
-		       && !object->is_section_included(fde_shndx));
+  entry.symndx = symndx;
 
   // Fetch the address range field from the FDE. The offset and size
   // of the field depends on the PC encoding given in the CIE, but
@@ -1125,19 +1219,135 @@ Eh_frame::read_fde(Sized_relobj_file<size, big_endian>* object,
       gold_unreachable();
     }
 
-  if (is_discarded || address_range == 0)
+  entry.address_range = address_range;
+  entry.fde = new Fde(object, parsed->shndx(), (pfde - 8) - pcontents,
+		      pfde, pfdeend - pfde);
+  parsed->entries_.push_back(entry);
+
+  return true;
+}
+
+// Merge the input section PARSED from OBJECT, which has been parsed by
+// parse_ehframe_input_section, with the sections added before it.
+// SYMBOLS and SYMBOLS_SIZE are as for add_ehframe_input_section.
+// This returns the disposition of the section.
+
+template<int size, bool big_endian>
+Eh_frame::Eh_frame_section_disposition
+Eh_frame::add_parsed_ehframe_section(
+    Sized_relobj_file<size, big_endian>* object,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    Parsed_eh_frame_section* parsed)
+{
+  if (parsed->disposition_ == EH_UNRECOGNIZED_SECTION
+      && this->eh_frame_hdr_ != NULL)
+    this->eh_frame_hdr_->found_unrecognized_eh_frame_section();
+  if (parsed->disposition_ != EH_OPTIMIZABLE_SECTION)
+    return parsed->disposition_;
+
+  const unsigned int shndx = parsed->shndx();
+  Parsed_eh_frame_section::Cies* new_cies = &parsed->cies_;
+
+  // Find the CIEs which we already saw in an earlier input section.
+  std::vector<Cie*> cie_pointers(new_cies->size());
+  std::vector<bool> cie_is_new(new_cies->size());
+  for (unsigned int i = 0; i < new_cies->size(); ++i)
     {
-      // This FDE applies to a discarded function.  We
-      // can discard this FDE.
-      object->add_merge_mapping(this, shndx, (pfde - 8) - pcontents,
-                                pfdeend - (pfde - 8), -1);
-      return true;
+      Cie* cie = (*new_cies)[i].first;
+      Cie_offsets::iterator find_cie = this->cie_offsets_.end();
+      if ((*new_cies)[i].second)
+	find_cie = this->cie_offsets_.find(cie);
+      cie_is_new[i] = find_cie == this->cie_offsets_.end();
+      cie_pointers[i] = cie_is_new[i] ? cie : *find_cie;
     }
 
-  cie->add_fde(new Fde(object, shndx, (pfde - 8) - pcontents,
-		       pfde, pfdeend - pfde));
+  const int sym_size = elfcpp::Elf_sizes<size>::sym_size;
+  for (std::vector<Parsed_eh_frame_section::Entry>::iterator p =
+	 parsed->entries_.begin();
+       p != parsed->entries_.end();
+       ++p)
+    {
+      bool is_discarded;
+      switch (p->kind)
+	{
+	case Parsed_eh_frame_section::ENTRY_CIE:
+	  // We are deleting a CIE which is a copy of one we already
+	  // have.  Record that in our mapping from input sections to
+	  // the output section.  At this point we don't know for sure
+	  // that we are doing a special mapping for this input
+	  // section, but that's OK--if we don't do a special mapping,
+	  // nobody will ever ask for the mapping we add here.
+	  is_discarded = !p->is_first || !cie_is_new[p->cie_index];
+	  break;
 
-  return true;
+	case Parsed_eh_frame_section::ENTRY_FDE:
+	  {
+	    // Find the section index for code that this FDE describes.
+	    // If we have discarded the section, we can also discard the
+	    // FDE.  If the address range is 0, this FDE corresponds to
+	    // a function that was discarded during optimization (too
+	    // late to discard the corresponding FDE).
+	    gold_assert(p->symndx < symbols_size / sym_size);
+	    elfcpp::Sym<size, big_endian> sym(symbols + p->symndx * sym_size);
+	    bool is_ordinary;
+	    unsigned int fde_shndx = object->adjust_sym_shndx(p->symndx,
+							      sym.get_st_shndx(),
+							      &is_ordinary);
+	    is_discarded = ((is_ordinary
+			     && fde_shndx != elfcpp::SHN_UNDEF
+			     && fde_shndx < object->shnum()
+			     && !object->is_section_included(fde_shndx))
+			    || p->address_range == 0);
+	    if (!is_discarded)
+	      {
+		cie_pointers[p->cie_index]->add_fde(p->fde);
+		p->fde = NULL;
+	      }
+	  }
+	  break;
+
+	case Parsed_eh_frame_section::ENTRY_DISCARDED_FDE:
+	  is_discarded = true;
+	  break;
+
+	default:
+	  gold_unreachable();
+	}
+
+      if (is_discarded)
+	object->add_merge_mapping(this, shndx, p->input_offset, p->length,
+				  -1);
+    }
+
+  // Now that we know we are using this section, record any new CIEs
+  // that we found.
+  for (unsigned int i = 0; i < new_cies->size(); ++i)
+    {
+      if (!cie_is_new[i])
+	continue;
+      if ((*new_cies)[i].second)
+	this->cie_offsets_.insert((*new_cies)[i].first);
+      else
+	this->unmergeable_cie_offsets_.push_back((*new_cies)[i].first);
+      (*new_cies)[i].first = NULL;
+    }
+
+  return EH_OPTIMIZABLE_SECTION;
+}
+
+// Class Parsed_eh_frame_section.
+
+// Delete the CIEs and FDEs which were not added to the Eh_frame data.
+
+Parsed_eh_frame_section::~Parsed_eh_frame_section()
+{
+  for (Cies::iterator p = this->cies_.begin(); p != this->cies_.end(); ++p)
+    delete p->first;
+  for (std::vector<Entry>::iterator p = this->entries_.begin();
+       p != this->entries_.end();
+       ++p)
+    delete p->fde;
 }
 
 // Add unwind information for a PLT.
@@ -1341,6 +1551,18 @@ Eh_frame::add_ehframe_input_section<32, false>(
     unsigned int shndx,
     unsigned int reloc_shndx,
     unsigned int reloc_type);
+
+template
+void
+Eh_frame::parse_ehframe_input_section<32, false>(
+    Sized_relobj_file<32, false>* object,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    const unsigned char* symbol_names,
+    section_size_type symbol_names_size,
+    unsigned int reloc_shndx,
+    unsigned int reloc_type,
+    Parsed_eh_frame_section* parsed);
 #endif
 
 #ifdef HAVE_TARGET_32_BIG
@@ -1355,6 +1577,18 @@ Eh_frame::add_ehframe_input_section<32, true>(
     unsigned int shndx,
     unsigned int reloc_shndx,
     unsigned int reloc_type);
+
+template
+void
+Eh_frame::parse_ehframe_input_section<32, true>(
+    Sized_relobj_file<32, true>* object,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    const unsigned char* symbol_names,
+    section_size_type symbol_names_size,
+    unsigned int reloc_shndx,
+    unsigned int reloc_type,
+    Parsed_eh_frame_section* parsed);
 #endif
 
 #ifdef HAVE_TARGET_64_LITTLE
@@ -1369,6 +1603,18 @@ Eh_frame::add_ehframe_input_section<64, false>(
     unsigned int shndx,
     unsigned int reloc_shndx,
     unsigned int reloc_type);
+
+template
+void
+Eh_frame::parse_ehframe_input_section<64, false>(
+    Sized_relobj_file<64, false>* object,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    const unsigned char* symbol_names,
+    section_size_type symbol_names_size,
+    unsigned int reloc_shndx,
+    unsigned int reloc_type,
+    Parsed_eh_frame_section* parsed);
 #endif
 
 #ifdef HAVE_TARGET_64_BIG
@@ -1383,6 +1629,18 @@ Eh_frame::add_ehframe_input_section<64, true>(
     unsigned int shndx,
     unsigned int reloc_shndx,
     unsigned int reloc_type);
+
+template
+void
+Eh_frame::parse_ehframe_input_section<64, true>(
+    Sized_relobj_file<64, true>* object,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    const unsigned char* symbol_names,
+    section_size_type symbol_names_size,
+    unsigned int reloc_shndx,
+    unsigned int reloc_type,
+    Parsed_eh_frame_section* parsed);
 #endif
 
 } // End namespace gold.
@@ -37,6 +37,8 @@ template<int size, bool big_endian>
 class Track_relocs;
 
 class Eh_frame;
+class Parsed_eh_frame_section;
+class Workqueue;
 
 // This class manages the .eh_frame_hdr section, which holds the data
 // for the PT_GNU_EH_FRAME segment.  gcc's unwind support code uses
@@ -55,6 +57,12 @@ class Eh_frame_hdr : public Output_section_data
   found_unrecognized_eh_frame_section()
   { this->any_unrecognized_eh_frame_sections_ = true; }
 
+  // Set the workqueue which may be used to sort the FDE table on
+  // several threads.
+  void
+  set_workqueue(Workqueue* workqueue)
+  { this->workqueue_ = workqueue; }
+
   // Record an FDE.
   void
   record_fde(section_offset_type fde_offset, unsigned char fde_encoding)
@@ -124,14 +132,20 @@ class Eh_frame_hdr : public Output_section_data
     Fde_address_list fde_addresses_;
   };
 
-  // Compare Fde_address objects.
+  // Compare Fde_address objects.  FDEs with the same PC are ordered
+  // by the address of the FDE, so that the table does not depend on
+  // how the sort is split across threads.
   template<int size>
   struct Fde_address_compare
   {
     bool
     operator()(const typename Fde_addresses<size>::Fde_address& f1,
 	       const typename Fde_addresses<size>::Fde_address& f2) const
-    { return f1.first < f2.first; }
+    {
+      if (f1.first != f2.first)
+	return f1.first < f2.first;
+      return f1.second < f2.second;
+    }
   };
 
   // Return the PC to which an FDE refers.
@@ -154,6 +168,8 @@ class Eh_frame_hdr : public Output_section_data
   const Eh_frame* eh_frame_data_;
   // Data from the FDEs in the .eh_frame sections.
   Fde_offsets fde_offsets_;
+  // The workqueue to use to sort the FDE table, or NULL.
+  Workqueue* workqueue_;
   // Whether we found any .eh_frame sections which we could not
   // process.
   bool any_unrecognized_eh_frame_sections_;
@@ -402,6 +418,22 @@ class Eh_frame : public Output_section_data
 			    unsigned int shndx, unsigned int reloc_shndx,
 			    unsigned int reloc_type);
 
+  // Parse the input section SHNDX in OBJECT into PARSED, without
+  // looking at any other input section.  The arguments are as for
+  // add_ehframe_input_section.  This may be called from several
+  // threads at once for different objects, before the Eh_frame
+  // output data has been created.
+  template<int size, bool big_endian>
+  static void
+  parse_ehframe_input_section(Sized_relobj_file<size, big_endian>* object,
+			      const unsigned char* symbols,
+			      section_size_type symbols_size,
+			      const unsigned char* symbol_names,
+			      section_size_type symbol_names_size,
+			      unsigned int reloc_shndx,
+			      unsigned int reloc_type,
+			      Parsed_eh_frame_section* parsed);
+
   // Add a CIE and an FDE for a PLT section, to permit unwinding
   // through a PLT.  The FDE data should start with 8 bytes of zero,
   // which will be replaced by a 4 byte PC relative reference to the
@@ -457,38 +489,33 @@ class Eh_frame : public Output_section_data
   // A list of unmergeable CIEs.
   typedef std::vector<Cie*> Unmergeable_cie_offsets;
 
-  // A mapping from offsets to CIEs.  This is used while reading an
-  // input section.
-  typedef std::map<uint64_t, Cie*> Offsets_to_cie;
-
-  // A list of CIEs, and a bool indicating whether the CIE is
-  // mergeable.
-  typedef std::vector<std::pair<Cie*, bool> > New_cies;
+  // A mapping from offsets to the index of a CIE in the
+  // Parsed_eh_frame_section.  This is used while reading an input
+  // section.
+  typedef std::map<uint64_t, unsigned int> Offsets_to_cie;
 
   // Skip an LEB128.
   static bool
   skip_leb128(const unsigned char**, const unsigned char*);
 
-  // The implementation of add_ehframe_input_section.
+  // The implementation of parse_ehframe_input_section.
   template<int size, bool big_endian>
-  bool
-  do_add_ehframe_input_section(Sized_relobj_file<size, big_endian>* object,
-			       const unsigned char* symbols,
-			       section_size_type symbols_size,
-			       const unsigned char* symbol_names,
-			       section_size_type symbol_names_size,
-			       unsigned int shndx,
-			       unsigned int reloc_shndx,
-			       unsigned int reloc_type,
-			       const unsigned char* pcontents,
-			       section_size_type contents_len,
-			       New_cies*);
+  static bool
+  do_parse_ehframe_input_section(Sized_relobj_file<size, big_endian>* object,
+				 const unsigned char* symbols,
+				 section_size_type symbols_size,
+				 const unsigned char* symbol_names,
+				 section_size_type symbol_names_size,
+				 unsigned int reloc_shndx,
+				 unsigned int reloc_type,
+				 const unsigned char* pcontents,
+				 section_size_type contents_len,
+				 Parsed_eh_frame_section* parsed);
 
   // Read a CIE.
   template<int size, bool big_endian>
-  bool
+  static bool
   read_cie(Sized_relobj_file<size, big_endian>* object,
-	   unsigned int shndx,
 	   const unsigned char* symbols,
 	   section_size_type symbols_size,
 	   const unsigned char* symbol_names,
@@ -498,21 +525,29 @@ class Eh_frame : public Output_section_data
 	   const unsigned char* pcieend,
 	   Track_relocs<size, big_endian>* relocs,
 	   Offsets_to_cie* cies,
-	   New_cies* new_cies);
+	   Parsed_eh_frame_section* parsed);
 
   // Read an FDE.
   template<int size, bool big_endian>
-  bool
+  static bool
   read_fde(Sized_relobj_file<size, big_endian>* object,
-	   unsigned int shndx,
-	   const unsigned char* symbols,
 	   section_size_type symbols_size,
 	   const unsigned char* pcontents,
 	   unsigned int offset,
 	   const unsigned char* pfde,
 	   const unsigned char* pfdeend,
 	   Track_relocs<size, big_endian>* relocs,
-	   Offsets_to_cie* cies);
+	   const Offsets_to_cie* cies,
+	   Parsed_eh_frame_section* parsed);
+
+  // Merge the parsed input section PARSED from OBJECT with the CIEs
+  // and FDEs of the sections added before it.
+  template<int size, bool big_endian>
+  Eh_frame_section_disposition
+  add_parsed_ehframe_section(Sized_relobj_file<size, big_endian>* object,
+			     const unsigned char* symbols,
+			     section_size_type symbols_size,
+			     Parsed_eh_frame_section* parsed);
 
   // Template version of write function.
   template<int size, bool big_endian>
@@ -534,6 +569,86 @@ class Eh_frame : public Output_section_data
   section_size_type final_data_size_;
 };
 
+// An input .eh_frame section which has been parsed but not yet merged
+// into the Eh_frame output data.  Parsing only depends on the object
+// itself, so when using threads it is done while the object's symbols
+// are read.  Merging the CIEs with those of other objects and
+// discarding the FDEs for discarded sections is done during layout,
+// in the usual object order, so the output does not depend on the
+// order in which the objects were parsed.
+
+class Parsed_eh_frame_section
+{
+ public:
+  Parsed_eh_frame_section(unsigned int shndx)
+    : shndx_(shndx), disposition_(Eh_frame::EH_UNRECOGNIZED_SECTION),
+      cies_(), entries_()
+  { }
+
+  ~Parsed_eh_frame_section();
+
+  // The input section index.
+  unsigned int
+  shndx() const
+  { return this->shndx_; }
+
+ private:
+  friend class Eh_frame;
+
+  // The kind of an entry in the section.
+  enum Entry_kind
+  {
+    // A CIE.
+    ENTRY_CIE,
+    // An FDE.
+    ENTRY_FDE,
+    // An FDE for a function which was discarded when the input
+    // object was created, which is always discarded.
+    ENTRY_DISCARDED_FDE
+  };
+
+  // One CIE or FDE in the section, in the order in which they appear.
+  struct Entry
+  {
+    Entry(Entry_kind k, section_offset_type offset, section_size_type len,
+	  unsigned int cie)
+      : kind(k), input_offset(offset), length(len), cie_index(cie),
+	is_first(false), symndx(0), address_range(0), fde(NULL)
+    { }
+
+    Entry_kind kind;
+    // The offset of the entry within the input section, including the
+    // length field, and the length of the entry.
+    section_offset_type input_offset;
+    section_size_type length;
+    // The index in cies_ of the CIE, or of the CIE used by the FDE.
+    unsigned int cie_index;
+    // For a CIE, whether this is the first copy of the CIE in the
+    // section.
+    bool is_first;
+    // For an FDE, the index of the symbol for the code it describes,
+    // and the size of that code.
+    unsigned int symndx;
+    uint64_t address_range;
+    // For an FDE, the FDE.  This is set to NULL when the FDE is added
+    // to a CIE.
+    Fde* fde;
+  };
+
+  // The unique CIEs in the section, and whether they are mergeable.
+  // A CIE is set to NULL when it is added to the Eh_frame data.
+  typedef std::vector<std::pair<Cie*, bool> > Cies;
+
+  // The input section index.
+  unsigned int shndx_;
+  // What to do with the section.
+  Eh_frame::Eh_frame_section_disposition disposition_;
+  // The unique CIEs.
+  Cies cies_;
+  // The entries.
+  std::vector<Entry> entries_;
+};
+
 } // End namespace gold.
 
 #endif // !defined(GOLD_EHFRAME_H)
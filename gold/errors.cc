@@ -27,6 +27,7 @@
 
 #include "gold-threads.h"
 #include "parameters.h"
+#include "options.h"
 #include "object.h"
 #include "symtab.h"
 #include "errors.h"
@@ -84,12 +85,21 @@ Errors::fatal(const char* format, va_list args)
   gold_exit(GOLD_ERR);
 }
 
-// Report a fallback error.
+// Report a fallback error.  With --incremental, gold_exit will
+// restart the link with --incremental-full, so this only explains
+// why the incremental update was not possible.
 
 void
 Errors::fallback(const char* format, va_list args)
 {
-  fprintf(stderr, _("%s: fatal error: "), this->program_name_);
+  if (parameters->options_valid()
+      && (parameters->options().incremental_mode()
+	  == General_options::INCREMENTAL_AUTO))
+    fprintf(stderr, _("%s: the link might take longer: "
+		      "cannot perform incremental link: "),
+	    this->program_name_);
+  else
+    fprintf(stderr, _("%s: fatal error: "), this->program_name_);
   vfprintf(stderr, format, args);
   fputc('\n', stderr);
   gold_exit(GOLD_FALLBACK);
@@ -25,6 +25,7 @@
 #include <cstring>
 #include <cerrno>
 #include <climits>
+#include <algorithm>
 #include <fcntl.h>
 #include <unistd.h>
 
@@ -124,6 +125,9 @@ static Initialize_lock file_counts_initialize_lock(&file_counts_lock);
 unsigned long long File_read::total_mapped_bytes;
 unsigned long long File_read::current_mapped_bytes;
 unsigned long long File_read::maximum_mapped_bytes;
+unsigned long long File_read::total_prefetch_bytes;
+unsigned long long File_read::total_prefetch_hit_bytes;
+unsigned long long File_read::total_prefetch_hits;
 
 // Class File_read::View.
 
@@ -267,9 +271,15 @@ File_read::release()
       File_read::current_mapped_bytes += this->mapped_bytes_;
       if (File_read::current_mapped_bytes > File_read::maximum_mapped_bytes)
 	File_read::maximum_mapped_bytes = File_read::current_mapped_bytes;
+      File_read::total_prefetch_bytes += this->prefetch_bytes_;
+      File_read::total_prefetch_hit_bytes += this->prefetch_hit_bytes_;
+      File_read::total_prefetch_hits += this->prefetch_hits_;
     }
 
   this->mapped_bytes_ = 0;
+  this->prefetch_bytes_ = 0;
+  this->prefetch_hit_bytes_ = 0;
+  this->prefetch_hits_ = 0;
 
   // Only clear views if there is only one attached object.  Otherwise
   // we waste time trying to clear cached archive views.  Similarly
@@ -425,6 +435,8 @@ File_read::do_read(off_t start, section_size_type size, void* p)
 void
 File_read::read(off_t start, section_size_type size, void* p)
 {
+  Hold_optional_lock hl(this->read_lock_);
+  this->note_prefetch_use(start, size);
   const File_read::View* pv = this->find_view(start, size, -1U, NULL);
   if (pv != NULL)
     {
@@ -542,6 +554,8 @@ File_read::find_or_make_view(off_t offset, off_t start,
 		   static_cast<long long>(size),
 		   static_cast<long long>(start));
 
+  this->note_prefetch_use(offset + start, size);
+
   unsigned int byteshift;
   if (offset == 0)
     byteshift = 0;
@@ -615,6 +629,7 @@ const unsigned char*
 File_read::get_view(off_t offset, off_t start, section_size_type size,
 		    bool aligned, bool cache)
 {
+  Hold_optional_lock hl(this->read_lock_);
   File_read::View* pv = this->find_or_make_view(offset, start, size,
 						aligned, cache);
   return pv->data() + (offset + start - pv->start() + pv->byteshift());
@@ -624,6 +639,7 @@ File_view*
 File_read::get_lasting_view(off_t offset, off_t start, section_size_type size,
 			    bool aligned, bool cache)
 {
+  Hold_optional_lock hl(this->read_lock_);
   File_read::View* pv = this->find_or_make_view(offset, start, size,
 						aligned, cache);
   pv->lock();
@@ -733,6 +749,7 @@ File_read::read_multiple(off_t base, const Read_multiple& rm)
 	this->read(base + i_off, i_entry.size, i_entry.buffer);
       else
 	{
+	  this->note_prefetch_use(base + i_off, end_off - i_off);
 	  File_read::View* view = this->find_view(base + i_off,
 						  end_off - i_off,
 						  -1U, NULL);
@@ -762,6 +779,90 @@ File_read::read_multiple(off_t base, const Read_multiple& rm)
     }
 }
 
+// Ask the system to read ahead the pieces of the file in PL.  We
+// merge pieces which are less than a page apart, to keep down the
+// number of system calls.  We remember each piece so that --stats
+// can report how many of them we went on to read.
+
+void
+File_read::prefetch(off_t base, const Prefetch_list& pl)
+{
+#ifdef HAVE_POSIX_FADVISE
+  // There is nothing to do for a file whose contents are in memory.
+  if (this->descriptor_ < 0 || pl.empty())
+    return;
+
+  Prefetch_list sorted(pl);
+  std::sort(sorted.begin(), sorted.end(), Prefetch_entry_compare());
+
+  this->reopen_descriptor();
+
+  off_t run_start = -1;
+  off_t run_end = -1;
+  for (Prefetch_list::const_iterator p = sorted.begin();
+       p != sorted.end();
+       ++p)
+    {
+      if (p->size == 0)
+	continue;
+      off_t start = base + p->file_offset;
+      off_t end = start + p->size;
+      if (end > this->size_)
+	continue;
+
+      std::pair<Prefetch_ranges::iterator, bool> ins =
+	this->prefetch_ranges_.insert(std::make_pair(start, end));
+      if (ins.second)
+	this->prefetch_bytes_ += p->size;
+
+      if (run_start >= 0 && start - run_end < File_read::page_size)
+	{
+	  if (end > run_end)
+	    run_end = end;
+	  continue;
+	}
+      if (run_start >= 0)
+	::posix_fadvise(this->descriptor_, run_start, run_end - run_start,
+			POSIX_FADV_WILLNEED);
+      run_start = start;
+      run_end = end;
+    }
+  if (run_start >= 0)
+    ::posix_fadvise(this->descriptor_, run_start, run_end - run_start,
+		    POSIX_FADV_WILLNEED);
+#else
+  (void) base;
+  (void) pl;
+#endif
+}
+
+// Record that we are reading SIZE bytes at START.  Each prefetched
+// piece which overlaps is counted as a hit and forgotten.  The caller
+// must hold read_lock_ if it is set.
+
+void
+File_read::note_prefetch_use(off_t start, section_size_type size)
+{
+  if (this->prefetch_ranges_.empty())
+    return;
+
+  off_t end = start + size;
+  Prefetch_ranges::iterator p = this->prefetch_ranges_.upper_bound(start);
+  if (p != this->prefetch_ranges_.begin())
+    {
+      Prefetch_ranges::iterator prev = p;
+      --prev;
+      if (prev->second > start)
+	p = prev;
+    }
+  while (p != this->prefetch_ranges_.end() && p->first < end)
+    {
+      this->prefetch_hit_bytes_ += p->second - p->first;
+      ++this->prefetch_hits_;
+      this->prefetch_ranges_.erase(p++);
+    }
+}
+
 // Mark all views as no longer cached.
 
 void
@@ -856,6 +957,14 @@ File_read::print_stats()
 	  program_name, File_read::total_mapped_bytes);
   fprintf(stderr, _("%s: maximum bytes mapped for read at one time: %llu\n"),
 	  program_name, File_read::maximum_mapped_bytes);
+  fprintf(stderr, _("%s: total bytes prefetched: %llu\n"),
+	  program_name, File_read::total_prefetch_bytes);
+  fprintf(stderr, _("%s: prefetched pieces read: %llu; bytes: %llu\n"),
+	  program_name, File_read::total_prefetch_hits,
+	  File_read::total_prefetch_hit_bytes);
+  fprintf(stderr, _("%s: prefetched bytes never read: %llu\n"),
+	  program_name,
+	  File_read::total_prefetch_bytes - File_read::total_prefetch_hit_bytes);
 }
 
 // Class File_view.
@@ -62,6 +62,7 @@ class Position_dependent_options;
 class Input_file_argument;
 class Dirsearch;
 class File_view;
+class Lock;
 
 // File_read manages a file descriptor and mappings for a file we are
 // reading.
@@ -72,7 +73,9 @@ class File_read
   File_read()
     : name_(), descriptor_(-1), is_descriptor_opened_(false), object_count_(0),
       size_(0), token_(false), views_(), saved_views_(), mapped_bytes_(0),
-      released_(true), whole_file_view_(NULL)
+      prefetch_ranges_(), prefetch_bytes_(0), prefetch_hit_bytes_(0),
+      prefetch_hits_(0),
+      released_(true), whole_file_view_(NULL), read_lock_(NULL)
   { }
 
   ~File_read();
@@ -168,6 +171,13 @@ class File_read
   get_lasting_view(off_t offset, off_t start, section_size_type size,
 		   bool aligned, bool cache);
 
+  // Set a lock to hold in get_view, read and get_lasting_view.  This
+  // is used while more than one thread is reading a locked file.  It
+  // is normally NULL.
+  void
+  set_read_lock(Lock* lock)
+  { this->read_lock_ = lock; }
+
   // Mark all views as no longer cached.
   void
   clear_view_cache_marks();
@@ -203,6 +213,36 @@ class File_read
   void
   read_multiple(off_t base, const Read_multiple&);
 
+  // A struct used to prefetch several pieces of data.
+  struct Prefetch_entry
+  {
+    // The file offset of the data to prefetch.
+    off_t file_offset;
+    // The amount of data to prefetch.
+    section_size_type size;
+
+    Prefetch_entry(off_t o, section_size_type s)
+      : file_offset(o), size(s)
+    { }
+  };
+
+  typedef std::vector<Prefetch_entry> Prefetch_list;
+
+  // Sort Prefetch_entry structures by file offset.
+  struct Prefetch_entry_compare
+  {
+    bool
+    operator()(const Prefetch_entry& e1, const Prefetch_entry& e2) const
+    { return e1.file_offset < e2.file_offset; }
+  };
+
+  // Ask the system to start reading the pieces of the file in the
+  // list, since we will read them soon.  BASE is a base offset to be
+  // added to all the offsets in the list.  This is used for
+  // --prefetch-inputs.
+  void
+  prefetch(off_t base, const Prefetch_list&);
+
   // Dump statistical information to stderr.
   static void
   print_stats();
@@ -247,6 +287,15 @@ class File_read
   // --stats.
   static unsigned long long maximum_mapped_bytes;
 
+  // Total bytes prefetched during the link if --stats.
+  static unsigned long long total_prefetch_bytes;
+
+  // Total bytes prefetched and then read during the link if --stats.
+  static unsigned long long total_prefetch_hit_bytes;
+
+  // Number of prefetched pieces which were then read if --stats.
+  static unsigned long long total_prefetch_hits;
+
   // A view into the file.
   class View
   {
@@ -358,6 +407,10 @@ class File_read
   // The type of a mapping from page start and byte shift to views.
   typedef std::map<std::pair<off_t, unsigned int>, View*> Views;
 
+  // The type of a mapping from the start of a prefetched piece of the
+  // file to its end.
+  typedef std::map<off_t, off_t> Prefetch_ranges;
+
   // A simple list of Views.
   typedef std::list<View*> Saved_views;
 
@@ -392,6 +445,11 @@ class File_read
   void
   clear_views(Clear_views_mode);
 
+  // Record that we are reading SIZE bytes at START, for the prefetch
+  // statistics.
+  void
+  note_prefetch_use(off_t start, section_size_type size);
+
   // The size of a file page for buffering data.
   static const off_t page_size = 8192;
 
@@ -434,6 +492,15 @@ class File_read
   // while the file is locked.  When we unlock the file, we transfer
   // the total to total_mapped_bytes, and reset this to zero.
   size_t mapped_bytes_;
+  // Prefetched pieces of the file which we have not read yet.
+  Prefetch_ranges prefetch_ranges_;
+  // The number of bytes prefetched, the number of those bytes which
+  // we then read, and the number of prefetched pieces which we then
+  // read.  Like mapped_bytes_, these are transferred to the totals
+  // when we unlock the file.
+  size_t prefetch_bytes_;
+  size_t prefetch_hit_bytes_;
+  size_t prefetch_hits_;
   // Whether the file was released.
   bool released_;
   // A view containing the whole file.  May be NULL if we mmap only
@@ -442,6 +509,8 @@ class File_read
   // - The contents was specified in the constructor.  Used only for
   //   testing purposes).
   View* whole_file_view_;
+  // Lock to hold while finding views, or NULL.  See set_read_lock.
+  Lock* read_lock_;
 };
 
 // A view of file data that persists even when the file is unlocked.
@@ -28,6 +28,7 @@
 #include "object.h"
 #include "output.h"
 #include "demangle.h"
+#include "workqueue.h"
 
 namespace gold
 {
@@ -171,6 +172,267 @@ mapped_index_string_hash(const unsigned char* str)
   return r;
 }
 
+class Gdb_index_info_reader;
+
+// The information for the .gdb_index section gathered from the debug
+// info of one input object.  This is filled in by a Gdb_index_scan_task,
+// and then added to the Gdb_index by Gdb_index::add_objects.  The CU
+// and TU indexes are local to the object; negative indexes refer to
+// TUs, as in the Gdb_index.
+
+class Gdb_index_object
+{
+ public:
+  // A .debug_info or .debug_types section to scan.
+  struct Debug_info_section
+  {
+    Debug_info_section(bool is_type, unsigned int sec, unsigned int rsec,
+		       unsigned int rtype)
+      : is_type_unit(is_type), shndx(sec), reloc_shndx(rsec),
+	reloc_type(rtype)
+    { }
+
+    bool is_type_unit;
+    unsigned int shndx;
+    unsigned int reloc_shndx;
+    unsigned int reloc_type;
+  };
+
+  // An entry in the compilation unit list.
+  struct Comp_unit
+  {
+    Comp_unit(off_t off, off_t len)
+      : cu_offset(off), cu_length(len)
+    { }
+    off_t cu_offset;
+    off_t cu_length;
+  };
+
+  // An entry in the type unit list.
+  struct Type_unit
+  {
+    Type_unit(off_t off, off_t toff, uint64_t sig)
+      : tu_offset(off), type_offset(toff), type_signature(sig)
+    { }
+    off_t tu_offset;
+    off_t type_offset;
+    uint64_t type_signature;
+  };
+
+  // A symbol to add to the index.  The name is stored in the
+  // symbol_names_ buffer.
+  struct Symbol
+  {
+    Symbol(size_t off, unsigned int hash, int index, uint8_t f)
+      : name_offset(off), hashval(hash), cu_index(index), flags(f)
+    { }
+    size_t name_offset;
+    unsigned int hashval;
+    int cu_index;
+    uint8_t flags;
+  };
+
+  typedef std::vector<std::pair<int, Dwarf_range_list*> > Range_lists;
+
+  Gdb_index_object(Relobj* object, bool has_symbols)
+    : object_(object), has_symbols_(has_symbols), sections_(),
+      comp_units_(), type_units_(), ranges_(), symbols_(), symbol_names_(),
+      cu_pubname_map_(), cu_pubtype_map_(), pubnames_table_(NULL),
+      pubtypes_table_(NULL), stmt_list_offset_(-1), cu_count_(0),
+      cu_nopubnames_count_(0), tu_count_(0), tu_nopubnames_count_(0)
+  { }
+
+  ~Gdb_index_object()
+  {
+    delete this->pubnames_table_;
+    delete this->pubtypes_table_;
+  }
+
+  // The input object.
+  Relobj*
+  object() const
+  { return this->object_; }
+
+  // Record a section to scan.
+  void
+  add_section(bool is_type_unit, unsigned int shndx,
+	      unsigned int reloc_shndx, unsigned int reloc_type)
+  {
+    this->sections_.push_back(Debug_info_section(is_type_unit, shndx,
+						 reloc_shndx, reloc_type));
+  }
+
+  // Scan the sections.  The object must be locked.
+  void
+  scan();
+
+  // Add a compilation unit, and return its index.
+  int
+  add_comp_unit(off_t cu_offset, off_t cu_length)
+  {
+    this->comp_units_.push_back(Comp_unit(cu_offset, cu_length));
+    return this->comp_units_.size() - 1;
+  }
+
+  // Add a type unit, and return its index.
+  int
+  add_type_unit(off_t tu_offset, off_t type_offset, uint64_t signature)
+  {
+    this->type_units_.push_back(Type_unit(tu_offset, type_offset, signature));
+    return this->type_units_.size() - 1;
+  }
+
+  // Add an address range.
+  void
+  add_address_range_list(int cu_index, Dwarf_range_list* ranges)
+  { this->ranges_.push_back(std::make_pair(cu_index, ranges)); }
+
+  // Add a symbol.  FLAGS are the gdb_index version 7 flags to be stored in
+  // the high-byte of the cu_index field.
+  void
+  add_symbol(int cu_index, const char* sym_name, uint8_t flags)
+  {
+    unsigned int hash = mapped_index_string_hash(
+	reinterpret_cast<const unsigned char*>(sym_name));
+    this->symbols_.push_back(Symbol(this->symbol_names_.size(), hash,
+				    cu_index, flags));
+    this->symbol_names_.append(sym_name, strlen(sym_name) + 1);
+  }
+
+  // Return the offset into the pubnames table for the cu at the given
+  // offset.
+  off_t
+  find_pubname_offset(off_t cu_offset);
+
+  // Return the offset into the pubtypes table for the cu at the
+  // given offset.
+  off_t
+  find_pubtype_offset(off_t cu_offset);
+
+  // Return TRUE if we have already processed the pubnames and types
+  // set of the CUs and TUS associated with the statement list at
+  // OFFSET.
+  bool
+  pubnames_read(off_t offset) const
+  { return this->stmt_list_offset_ == offset; }
+
+  // Record that we have already read the pubnames associated with
+  // OFFSET.
+  void
+  set_pubnames_read(off_t offset)
+  { this->stmt_list_offset_ = offset; }
+
+  // Return a pointer to the given table.
+  Dwarf_pubnames_table*
+  pubnames_table()
+  { return this->pubnames_table_; }
+
+  Dwarf_pubnames_table*
+  pubtypes_table()
+  { return this->pubtypes_table_; }
+
+  // Statistics.
+  void
+  count_cu()
+  { ++this->cu_count_; }
+
+  void
+  count_cu_nopubnames()
+  { ++this->cu_nopubnames_count_; }
+
+  void
+  count_tu()
+  { ++this->tu_count_; }
+
+  void
+  count_tu_nopubnames()
+  { ++this->tu_nopubnames_count_; }
+
+  // Accessors used when adding the information to the Gdb_index.
+  const std::vector<Comp_unit>&
+  comp_units() const
+  { return this->comp_units_; }
+
+  const std::vector<Type_unit>&
+  type_units() const
+  { return this->type_units_; }
+
+  const Range_lists&
+  ranges() const
+  { return this->ranges_; }
+
+  const std::vector<Symbol>&
+  symbols() const
+  { return this->symbols_; }
+
+  const char*
+  symbol_name(const Symbol& sym) const
+  { return this->symbol_names_.data() + sym.name_offset; }
+
+  unsigned int
+  cu_count() const
+  { return this->cu_count_; }
+
+  unsigned int
+  cu_nopubnames_count() const
+  { return this->cu_nopubnames_count_; }
+
+  unsigned int
+  tu_count() const
+  { return this->tu_count_; }
+
+  unsigned int
+  tu_nopubnames_count() const
+  { return this->tu_nopubnames_count_; }
+
+ private:
+  typedef Unordered_map<off_t, off_t> Pubname_offset_map;
+
+  // Create a map from dies to pubnames.
+  Dwarf_pubnames_table*
+  map_pubtable_to_dies(unsigned int attr,
+                       Gdb_index_info_reader* dwinfo,
+                       const unsigned char* symbols,
+                       off_t symbols_size);
+
+  // Wrapper for map_pubtable_to_dies
+  void
+  map_pubnames_and_types_to_dies(Gdb_index_info_reader* dwinfo,
+                                 const unsigned char* symbols,
+                                 off_t symbols_size);
+
+  // The input object.
+  Relobj* object_;
+  // Whether to use the symbol table of the object.
+  bool has_symbols_;
+  // The sections to scan.
+  std::vector<Debug_info_section> sections_;
+  // The list of DWARF compilation units.
+  std::vector<Comp_unit> comp_units_;
+  // The list of DWARF type units.
+  std::vector<Type_unit> type_units_;
+  // The list of address ranges, with their CU indexes.
+  Range_lists ranges_;
+  // The symbols, in the order they were found.
+  std::vector<Symbol> symbols_;
+  // The null terminated names of the symbols.
+  std::string symbol_names_;
+  // Maps from CU offsets to the pubnames and pubtypes tables.
+  Pubname_offset_map cu_pubname_map_;
+  Pubname_offset_map cu_pubtype_map_;
+  // Tables to store the pubnames section of the object.
+  Dwarf_pubnames_table* pubnames_table_;
+  Dwarf_pubnames_table* pubtypes_table_;
+  // Stmt list offset of the CUs and TUs associated with the last read
+  // pubnames and pubtypes sections.
+  off_t stmt_list_offset_;
+  // Statistics.
+  unsigned int cu_count_;
+  unsigned int cu_nopubnames_count_;
+  unsigned int tu_count_;
+  unsigned int tu_nopubnames_count_;
+};
+
 // A specialization of Dwarf_info_reader, for building the .gdb_index.
 
 class Gdb_index_info_reader : public Dwarf_info_reader
@@ -183,15 +445,19 @@ class Gdb_index_info_reader : public Dwarf_info_reader
 			unsigned int shndx,
 			unsigned int reloc_shndx,
 			unsigned int reloc_type,
-			Gdb_index* gdb_index)
+			Gdb_index_object* info)
     : Dwarf_info_reader(is_type_unit, object, symbols, symbols_size, shndx,
 			reloc_shndx, reloc_type),
-      gdb_index_(gdb_index), cu_index_(0), cu_language_(0)
+      info_(info), cu_index_(0), cu_language_(0)
   { }
 
   ~Gdb_index_info_reader()
   { this->clear_declarations(); }
 
+  // Add the statistics gathered from INFO.
+  static void
+  add_stats(const Gdb_index_object* info);
+
   // Print usage statistics.
   static void
   print_stats();
@@ -285,8 +551,8 @@ class Gdb_index_info_reader : public Dwarf_info_reader
   void
   clear_declarations();
 
-  // The Gdb_index section.
-  Gdb_index* gdb_index_;
+  // Where to store the information for the object.
+  Gdb_index_object* info_;
   // The current CU index (negative for a TU).
   int cu_index_;
   // The language of the current CU or TU.
@@ -321,8 +587,8 @@ void
 Gdb_index_info_reader::visit_compilation_unit(off_t cu_offset, off_t cu_length,
 					      Dwarf_die* root_die)
 {
-  ++Gdb_index_info_reader::dwarf_cu_count;
-  this->cu_index_ = this->gdb_index_->add_comp_unit(cu_offset, cu_length);
+  this->info_->count_cu();
+  this->cu_index_ = this->info_->add_comp_unit(cu_offset, cu_length);
   this->visit_top_die(root_die);
 }
 
@@ -333,10 +599,10 @@ Gdb_index_info_reader::visit_type_unit(off_t tu_offset, off_t,
 				       off_t type_offset, uint64_t signature,
 				       Dwarf_die* root_die)
 {
-  ++Gdb_index_info_reader::dwarf_tu_count;
+  this->info_->count_tu();
   // Use a negative index to flag this as a TU instead of a CU.
-  this->cu_index_ = -1 - this->gdb_index_->add_type_unit(tu_offset, type_offset,
-							 signature);
+  this->cu_index_ = -1 - this->info_->add_type_unit(tu_offset, type_offset,
+						    signature);
   this->visit_top_die(root_die);
 }
 
@@ -381,9 +647,9 @@ Gdb_index_info_reader::visit_top_die(Dwarf_die* die)
 		return;
 	      }
 	    if (die->tag() == elfcpp::DW_TAG_compile_unit)
-	      ++Gdb_index_info_reader::dwarf_cu_nopubnames_count;
+	      this->info_->count_cu_nopubnames();
 	    else
-	      ++Gdb_index_info_reader::dwarf_tu_nopubnames_count;
+	      this->info_->count_tu_nopubnames();
 	    this->visit_children(die, NULL);
 	  }
 	break;
@@ -437,8 +703,7 @@ Gdb_index_info_reader::visit_die(Dwarf_die* die, Dwarf_die* context)
 	    // If the DIE is not a declaration, add it to the index.
 	    std::string full_name = this->get_qualified_name(die, context);
 	    if (!full_name.empty())
-	      this->gdb_index_->add_symbol(this->cu_index_,
-                                           full_name.c_str(), 0);
+	      this->info_->add_symbol(this->cu_index_, full_name.c_str(), 0);
 	  }
 	break;
       case elfcpp::DW_TAG_typedef:
@@ -477,8 +742,8 @@ Gdb_index_info_reader::visit_die(Dwarf_die* die, Dwarf_die* context)
 	      if (full_name.empty())
 		full_name = this->get_qualified_name(die, context);
 	      if (!full_name.empty())
-		this->gdb_index_->add_symbol(this->cu_index_,
-					     full_name.c_str(), 0);
+		this->info_->add_symbol(this->cu_index_,
+					full_name.c_str(), 0);
 	    }
 
 	  // We're interested in the children only for namespaces and
@@ -825,8 +1090,7 @@ Gdb_index_info_reader::record_cu_ranges(Dwarf_die* die)
     {
       Dwarf_range_list* ranges = this->read_range_list(shndx, ranges_offset);
       if (ranges != NULL)
-	this->gdb_index_->add_address_range_list(this->object(),
-						 this->cu_index_, ranges);
+	this->info_->add_address_range_list(this->cu_index_, ranges);
       return;
     }
 
@@ -851,8 +1115,7 @@ Gdb_index_info_reader::record_cu_ranges(Dwarf_die* die)
         {
 	  Dwarf_range_list* ranges = new Dwarf_range_list();
 	  ranges->add(shndx, low_pc, high_pc);
-	  this->gdb_index_->add_address_range_list(this->object(),
-						   this->cu_index_, ranges);
+	  this->info_->add_address_range_list(this->cu_index_, ranges);
         }
     }
 }
@@ -877,7 +1140,7 @@ Gdb_index_info_reader::read_pubtable(Dwarf_pubnames_table* table, off_t offset)
       if (name == NULL)
         break;
 
-      this->gdb_index_->add_symbol(this->cu_index_, name, flag_byte);
+      this->info_->add_symbol(this->cu_index_, name, flag_byte);
     }
   return true;
 }
@@ -916,8 +1179,7 @@ Gdb_index_info_reader::read_pubnames_and_pubtypes(Dwarf_die* die)
           // have read. If it does, then no need to read the pubnames.
           // If it doesn't, then the caller will have to parse the
           // dies manually to find the names.
-          return this->gdb_index_->pubnames_read(this->object(),
-                                                 stmt_list_off);
+          return this->info_->pubnames_read(stmt_list_off);
         }
       else
         {
@@ -928,10 +1190,10 @@ Gdb_index_info_reader::read_pubnames_and_pubtypes(Dwarf_die* die)
 
   // We found the attribute, so we can check if the corresponding
   // pubnames have been read.
-  if (this->gdb_index_->pubnames_read(this->object(), stmt_list_off))
+  if (this->info_->pubnames_read(stmt_list_off))
     return true;
 
-  this->gdb_index_->set_pubnames_read(this->object(), stmt_list_off);
+  this->info_->set_pubnames_read(stmt_list_off);
 
   // We have an attribute, and the pubnames haven't been read, so read
   // them.
@@ -939,12 +1201,12 @@ Gdb_index_info_reader::read_pubnames_and_pubtypes(Dwarf_die* die)
   // In some of the cases, we could rely on the previous value of
   // offset here, but sorting out which cases complicates the logic
   // enough that it isn't worth it. So just look up the offset again.
-  offset = this->gdb_index_->find_pubname_offset(this->cu_offset());
-  names = this->read_pubtable(this->gdb_index_->pubnames_table(), offset);
+  offset = this->info_->find_pubname_offset(this->cu_offset());
+  names = this->read_pubtable(this->info_->pubnames_table(), offset);
 
   bool types = false;
-  offset = this->gdb_index_->find_pubtype_offset(this->cu_offset());
-  types = this->read_pubtable(this->gdb_index_->pubtypes_table(), offset);
+  offset = this->info_->find_pubtype_offset(this->cu_offset());
+  types = this->read_pubtable(this->info_->pubtypes_table(), offset);
   return names || types;
 }
 
@@ -964,6 +1226,19 @@ Gdb_index_info_reader::clear_declarations()
   this->declarations_.clear();
 }
 
+// Add the statistics gathered from INFO.
+
+void
+Gdb_index_info_reader::add_stats(const Gdb_index_object* info)
+{
+  Gdb_index_info_reader::dwarf_cu_count += info->cu_count();
+  Gdb_index_info_reader::dwarf_cu_nopubnames_count
+    += info->cu_nopubnames_count();
+  Gdb_index_info_reader::dwarf_tu_count += info->tu_count();
+  Gdb_index_info_reader::dwarf_tu_nopubnames_count
+    += info->tu_nopubnames_count();
+}
+
 // Print usage statistics.
 void
 Gdb_index_info_reader::print_stats()
@@ -978,41 +1253,7 @@ Gdb_index_info_reader::print_stats()
           program_name, Gdb_index_info_reader::dwarf_tu_nopubnames_count);
 }
 
-// Class Gdb_index.
-
-// Construct the .gdb_index section.
-
-Gdb_index::Gdb_index(Output_section* gdb_index_section)
-  : Output_section_data(4),
-    pubnames_table_(NULL),
-    pubtypes_table_(NULL),
-    gdb_index_section_(gdb_index_section),
-    comp_units_(),
-    type_units_(),
-    ranges_(),
-    cu_vector_list_(),
-    cu_vector_offsets_(NULL),
-    stringpool_(),
-    tu_offset_(0),
-    addr_offset_(0),
-    symtab_offset_(0),
-    cu_pool_offset_(0),
-    stringpool_offset_(0),
-    pubnames_object_(NULL),
-    stmt_list_offset_(-1)
-{
-  this->gdb_symtab_ = new Gdb_hashtab<Gdb_symbol>();
-}
-
-Gdb_index::~Gdb_index()
-{
-  // Free the memory used by the symbol table.
-  delete this->gdb_symtab_;
-  // Free the memory used by the CU vectors.
-  for (unsigned int i = 0; i < this->cu_vector_list_.size(); ++i)
-    delete this->cu_vector_list_[i];
-}
-
+// Class Gdb_index_object.
 
 // Scan the pubnames and pubtypes sections and build a map of the
 // various cus and tus they refer to, so we can process the entries
@@ -1020,11 +1261,10 @@ Gdb_index::~Gdb_index()
 // Return the just-read table so it can be cached.
 
 Dwarf_pubnames_table*
-Gdb_index::map_pubtable_to_dies(unsigned int attr,
-                                Gdb_index_info_reader* dwinfo,
-                                Relobj* object,
-                                const unsigned char* symbols,
-                                off_t symbols_size)
+Gdb_index_object::map_pubtable_to_dies(unsigned int attr,
+				       Gdb_index_info_reader* dwinfo,
+				       const unsigned char* symbols,
+				       off_t symbols_size)
 {
   uint64_t section_offset = 0;
   Dwarf_pubnames_table* table;
@@ -1042,7 +1282,7 @@ Gdb_index::map_pubtable_to_dies(unsigned int attr,
     }
 
   map->clear();
-  if (!table->read_section(object, symbols, symbols_size))
+  if (!table->read_section(this->object_, symbols, symbols_size))
     return NULL;
 
   while (table->read_header(section_offset))
@@ -1057,30 +1297,28 @@ Gdb_index::map_pubtable_to_dies(unsigned int attr,
 // Wrapper for map_pubtable_to_dies
 
 void
-Gdb_index::map_pubnames_and_types_to_dies(Gdb_index_info_reader* dwinfo,
-                                          Relobj* object,
-                                          const unsigned char* symbols,
-                                          off_t symbols_size)
+Gdb_index_object::map_pubnames_and_types_to_dies(
+    Gdb_index_info_reader* dwinfo,
+    const unsigned char* symbols,
+    off_t symbols_size)
 {
-  // This is a new object, so reset the relevant variables.
-  this->pubnames_object_ = object;
   this->stmt_list_offset_ = -1;
 
   delete this->pubnames_table_;
   this->pubnames_table_
       = this->map_pubtable_to_dies(elfcpp::DW_AT_GNU_pubnames, dwinfo,
-                                   object, symbols, symbols_size);
+                                   symbols, symbols_size);
   delete this->pubtypes_table_;
   this->pubtypes_table_
       = this->map_pubtable_to_dies(elfcpp::DW_AT_GNU_pubtypes, dwinfo,
-                                   object, symbols, symbols_size);
+                                   symbols, symbols_size);
 }
 
 // Given a cu_offset, find the associated section of the pubnames
 // table.
 
 off_t
-Gdb_index::find_pubname_offset(off_t cu_offset)
+Gdb_index_object::find_pubname_offset(off_t cu_offset)
 {
   Pubname_offset_map::iterator it = this->cu_pubname_map_.find(cu_offset);
   if (it != this->cu_pubname_map_.end())
@@ -1092,7 +1330,7 @@ Gdb_index::find_pubname_offset(off_t cu_offset)
 // table.
 
 off_t
-Gdb_index::find_pubtype_offset(off_t cu_offset)
+Gdb_index_object::find_pubtype_offset(off_t cu_offset)
 {
   Pubname_offset_map::iterator it = this->cu_pubtype_map_.find(cu_offset);
   if (it != this->cu_pubtype_map_.end())
@@ -1100,36 +1338,206 @@ Gdb_index::find_pubtype_offset(off_t cu_offset)
   return -1;
 }
 
-// Scan a .debug_info or .debug_types input section.
+// Scan the .debug_info and .debug_types sections of the object.  The
+// symbol table is read again here, since the copy read with the
+// symbols has been released by the time this runs.
 
 void
-Gdb_index::scan_debug_info(bool is_type_unit,
-			   Relobj* object,
-			   const unsigned char* symbols,
-			   off_t symbols_size,
-			   unsigned int shndx,
-			   unsigned int reloc_shndx,
-			   unsigned int reloc_type)
+Gdb_index_object::scan()
 {
-  Gdb_index_info_reader dwinfo(is_type_unit, object,
-			       symbols, symbols_size,
-			       shndx, reloc_shndx,
-			       reloc_type, this);
-  if (object != this->pubnames_object_)
-    map_pubnames_and_types_to_dies(&dwinfo, object, symbols, symbols_size);
-  dwinfo.parse();
+  const unsigned char* symbols = NULL;
+  section_size_type symbols_size = 0;
+  if (this->has_symbols_)
+    {
+      for (unsigned int i = 1; i < this->object_->shnum(); ++i)
+	{
+	  if (this->object_->section_type(i) == elfcpp::SHT_SYMTAB)
+	    {
+	      symbols = this->object_->section_contents(i, &symbols_size,
+							false);
+	      break;
+	    }
+	}
+    }
+
+  for (std::vector<Debug_info_section>::const_iterator p =
+	 this->sections_.begin();
+       p != this->sections_.end();
+       ++p)
+    {
+      Gdb_index_info_reader dwinfo(p->is_type_unit, this->object_,
+				   symbols, symbols_size,
+				   p->shndx, p->reloc_shndx,
+				   p->reloc_type, this);
+      if (p == this->sections_.begin())
+	this->map_pubnames_and_types_to_dies(&dwinfo, symbols, symbols_size);
+      dwinfo.parse();
+    }
+}
+
+// A task to scan the debug info of one input object.
+
+class Gdb_index_scan_task : public Task
+{
+ public:
+  Gdb_index_scan_task(Gdb_index_object* info, Task_token* blocker)
+    : info_(info), blocker_(blocker)
+  { }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable()
+  {
+    if (this->info_->object()->is_locked())
+      return this->info_->object()->token();
+    return NULL;
+  }
+
+  void
+  locks(Task_locker* tl)
+  {
+    Task_token* token = this->info_->object()->token();
+    if (token != NULL)
+      tl->add(this, token);
+    tl->add(this, this->blocker_);
+  }
+
+  void
+  run(Workqueue*)
+  {
+    this->info_->scan();
+    this->info_->object()->release();
+  }
+
+  std::string
+  get_name() const
+  { return "Gdb_index_scan_task " + this->info_->object()->name(); }
+
+ private:
+  Gdb_index_object* info_;
+  Task_token* blocker_;
+};
+
+// Class Gdb_index.
+
+// Construct the .gdb_index section.
+
+Gdb_index::Gdb_index(Output_section* gdb_index_section)
+  : Output_section_data(4),
+    objects_(),
+    gdb_index_section_(gdb_index_section),
+    comp_units_(),
+    type_units_(),
+    ranges_(),
+    cu_vector_list_(),
+    cu_vector_offsets_(NULL),
+    stringpool_(),
+    tu_offset_(0),
+    addr_offset_(0),
+    symtab_offset_(0),
+    cu_pool_offset_(0),
+    stringpool_offset_(0)
+{
+  this->gdb_symtab_ = new Gdb_hashtab<Gdb_symbol>();
+}
+
+Gdb_index::~Gdb_index()
+{
+  // Free the memory used by the symbol table.
+  delete this->gdb_symtab_;
+  // Free the memory used by the CU vectors.
+  for (unsigned int i = 0; i < this->cu_vector_list_.size(); ++i)
+    delete this->cu_vector_list_[i];
+  for (unsigned int i = 0; i < this->objects_.size(); ++i)
+    delete this->objects_[i];
+}
+
+// Record a .debug_info or .debug_types input section to be scanned.
+// The sections of an object are recorded one after another, so we
+// only need to look at the last object.
+
+void
+Gdb_index::add_debug_info_section(bool is_type_unit,
+				  Relobj* object,
+				  bool has_symbols,
+				  unsigned int shndx,
+				  unsigned int reloc_shndx,
+				  unsigned int reloc_type)
+{
+  if (this->objects_.empty() || this->objects_.back()->object() != object)
+    this->objects_.push_back(new Gdb_index_object(object, has_symbols));
+  this->objects_.back()->add_section(is_type_unit, shndx, reloc_shndx,
+				     reloc_type);
+}
+
+// Queue a task to scan the debug info of each object.
+
+void
+Gdb_index::queue_scan_tasks(Workqueue* workqueue, Task_token* blocker)
+{
+  for (unsigned int i = 0; i < this->objects_.size(); ++i)
+    {
+      blocker->add_blocker();
+      workqueue->queue(new Gdb_index_scan_task(this->objects_[i], blocker));
+    }
+}
+
+// Add the information gathered from the input objects.  This is done
+// in input order, so that the CU indexes and the symbol table are the
+// same as if the objects had been scanned one after another.
+
+void
+Gdb_index::add_objects()
+{
+  for (unsigned int i = 0; i < this->objects_.size(); ++i)
+    {
+      Gdb_index_object* info = this->objects_[i];
+      int cu_base = this->comp_units_.size();
+      int tu_base = this->type_units_.size();
+
+      const std::vector<Gdb_index_object::Comp_unit>& cus(info->comp_units());
+      for (unsigned int j = 0; j < cus.size(); ++j)
+	this->add_comp_unit(cus[j].cu_offset, cus[j].cu_length);
+
+      const std::vector<Gdb_index_object::Type_unit>& tus(info->type_units());
+      for (unsigned int j = 0; j < tus.size(); ++j)
+	this->add_type_unit(tus[j].tu_offset, tus[j].type_offset,
+			    tus[j].type_signature);
+
+      const Gdb_index_object::Range_lists& ranges(info->ranges());
+      for (unsigned int j = 0; j < ranges.size(); ++j)
+	{
+	  int cu_index = ranges[j].first;
+	  cu_index = cu_index >= 0 ? cu_base + cu_index : cu_index - tu_base;
+	  this->add_address_range_list(info->object(), cu_index,
+				       ranges[j].second);
+	}
+
+      const std::vector<Gdb_index_object::Symbol>& syms(info->symbols());
+      for (unsigned int j = 0; j < syms.size(); ++j)
+	{
+	  int cu_index = syms[j].cu_index;
+	  cu_index = cu_index >= 0 ? cu_base + cu_index : cu_index - tu_base;
+	  this->add_symbol(cu_index, info->symbol_name(syms[j]),
+			   syms[j].hashval, syms[j].flags);
+	}
+
+      Gdb_index_info_reader::add_stats(info);
+      delete info;
+    }
+  this->objects_.clear();
 }
 
 // Add a symbol.
 
 void
-Gdb_index::add_symbol(int cu_index, const char* sym_name, uint8_t flags)
+Gdb_index::add_symbol(int cu_index, const char* sym_name,
+		      unsigned int hashval, uint8_t flags)
 {
-  unsigned int hash = mapped_index_string_hash(
-      reinterpret_cast<const unsigned char*>(sym_name));
   Gdb_symbol* sym = new Gdb_symbol();
   this->stringpool_.add(sym_name, true, &sym->name_key);
-  sym->hashval = hash;
+  sym->hashval = hashval;
   sym->cu_vector_index = 0;
 
   Gdb_symbol* found = this->gdb_symtab_->add(sym);
@@ -1156,32 +1564,14 @@ Gdb_index::add_symbol(int cu_index, const char* sym_name, uint8_t flags)
     cu_vec->push_back(std::make_pair(cu_index, flags));
 }
 
-// Return TRUE if we have already processed the pubnames associated
-// with the statement list at the given OFFSET.
-
-bool
-Gdb_index::pubnames_read(const Relobj* object, off_t offset)
-{
-  bool ret = (this->pubnames_object_ == object
-	      && this->stmt_list_offset_ == offset);
-  return ret;
-}
-
-// Record that we have processed the pubnames associated with the
-// statement list for OBJECT at the given OFFSET.
-
-void
-Gdb_index::set_pubnames_read(const Relobj* object, off_t offset)
-{
-  this->pubnames_object_ = object;
-  this->stmt_list_offset_ = offset;
-}
-
 // Set the size of the .gdb_index section.
 
 void
 Gdb_index::set_final_data_size()
 {
+  // Add the information from the input objects.
+  this->add_objects();
+
   // Finalize the string pool.
   this->stringpool_.set_string_offsets();
 
@@ -22,6 +22,7 @@
 
 #include "gold.h"
 
+#include <cerrno>
 #include <cstdlib>
 #include <cstdio>
 #include <cstring>
@@ -59,6 +60,48 @@ process_incremental_input(Incremental_binary*, unsigned int, Input_objects*,
 			  Symbol_table*, Layout*, Dirsearch*, Mapfile*,
 			  Task_token*, Task_token*);
 
+// The command line, for restarting an incremental link.
+
+static int restart_argc;
+static char** restart_argv;
+
+void
+set_incremental_restart_argv(int argc, char** argv)
+{
+  restart_argc = argc;
+  restart_argv = argv;
+}
+
+// With --incremental, if an incremental update turns out to be
+// impossible after we have started it, run the link again with
+// --incremental-full.  This only returns if the restart fails.
+
+static void
+restart_incremental_full()
+{
+  if (restart_argv == NULL
+      || parameters == NULL
+      || !parameters->options_valid()
+      || (parameters->options().incremental_mode()
+	  != General_options::INCREMENTAL_AUTO)
+      || !parameters->incremental_update())
+    return;
+
+  char** argv = new char*[restart_argc + 2];
+  for (int i = 0; i < restart_argc; ++i)
+    argv[i] = restart_argv[i];
+  argv[restart_argc] = const_cast<char*>("--incremental-full");
+  argv[restart_argc + 1] = NULL;
+
+  gold_info(_("linking with --incremental-full"));
+  fflush(stdout);
+  fflush(stderr);
+  execvp(argv[0], argv);
+
+  gold_warning(_("cannot restart link: %s"), strerror(errno));
+  delete[] argv;
+}
+
 void
 gold_exit(Exit_status status)
 {
@@ -68,6 +111,8 @@ gold_exit(Exit_status status)
     parameters->options().plugins()->cleanup();
   if (status != GOLD_OK && parameters != NULL && parameters->options_valid())
     unlink_if_ordinary(parameters->options().output_file_name());
+  if (status == GOLD_FALLBACK)
+    restart_incremental_full();
   exit(status);
 }
 
@@ -530,7 +575,8 @@ queue_middle_tasks(const General_options& options,
   // be folding sections that will be garbage.
   if (parameters->options().icf_enabled())
     {
-      symtab->icf()->find_identical_sections(input_objects, symtab);
+      symtab->icf()->find_identical_sections(input_objects, symtab,
+                                             workqueue);
     }
 
   // Call Object::layout for the second time to determine the
@@ -771,6 +817,10 @@ queue_middle_tasks(const General_options& options,
 	}
     }
 
+  // Scan the debug info for the .gdb_index section, on several
+  // threads.  This must be done before the section size is set.
+  layout->queue_gdb_index_tasks(workqueue, this_blocker);
+
   // When all those tasks are complete, we can start laying out the
   // output file.
   workqueue->queue(new Task_function(new Layout_task_runner(options,
@@ -880,7 +930,8 @@ queue_final_tasks(const General_options& options,
     }
 
   // Create tasks for tree-style build ID computation, if necessary.
-  if (strcmp(options.build_id(), "tree") == 0)
+  if (strcmp(options.build_id(), "tree") == 0
+      || strcmp(options.build_id(), "fast") == 0)
     {
       // Queue a task to compute the build id.  This will be blocked by
       // FINAL_BLOCKER, and will in turn schedule the task to close
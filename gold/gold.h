@@ -81,6 +81,11 @@ extern const char* program_name;
 extern void
 gold_exit(Exit_status status) ATTRIBUTE_NORETURN;
 
+// Record the command line, so that gold_exit can restart an
+// incremental link with --incremental-full if an update fails.
+extern void
+set_incremental_restart_argv(int argc, char** argv);
+
 // This function is called to emit an error message and then
 // immediately exit with failure.
 extern void
@@ -494,6 +494,17 @@ class Target_i386 : public Sized_target<32, false>
   do_can_check_for_function_pointers() const
   { return true; }
 
+  // Applying relocations does not change any target state.
+  bool
+  do_can_relocate_sections_in_parallel() const
+  { return true; }
+
+  // Local symbols are only needed after relocation by GOT and PLT
+  // entries and dynamic relocations, which the object records.
+  bool
+  do_can_free_local_values() const
+  { return true; }
+
   // Return the base for a DW_EH_PE_datarel encoding.
   uint64_t
   do_ehframe_datarel_base() const;
@@ -137,6 +137,12 @@
 //
 // Performance : Less than 20 % link-time overhead on industry strength
 // applications.  Up to 6 %  text size reductions.
+//
+// When using threads, the section contents are hashed on several
+// threads, and so are the contents after the first iteration.  The
+// first iteration reads the input files, and builds the contents on
+// one thread.  The groups are always formed on one thread, in section
+// order, so the result does not depend on the number of threads.
 
 #include "gold.h"
 #include "object.h"
@@ -147,10 +153,117 @@
 #include "demangle.h"
 #include "elfcpp.h"
 #include "int_encoding.h"
+#include "workqueue.h"
+#include "timer.h"
 
 namespace gold
 {
 
+// Hash LEN bytes at P.  This is a fast non-cryptographic hash.
+// Sections with the same hash are compared byte by byte, so
+// collisions only cost time.
+
+static uint64_t
+icf_hash(const unsigned char* p, size_t len)
+{
+  const uint64_t mul = 0x9e3779b97f4a7c15ULL;
+  uint64_t h = len * mul;
+  while (len >= 8)
+    {
+      uint64_t w;
+      memcpy(&w, p, 8);
+      h = (h ^ w) * mul;
+      h ^= h >> 29;
+      p += 8;
+      len -= 8;
+    }
+  uint64_t w = 0;
+  memcpy(&w, p, len);
+  h = (h ^ w) * mul;
+  h ^= h >> 32;
+  return h;
+}
+
+static uint64_t
+icf_hash(const std::string& s)
+{
+  return icf_hash(reinterpret_cast<const unsigned char*>(s.data()),
+		  s.length());
+}
+
+// The number of sections in one item of an Icf_section_work.
+
+static const unsigned int icf_sections_per_item = 256;
+
+// Work on the candidate sections, on several threads.  Each item is a
+// block of sections.  The child class does one section at a time, and
+// must only write to the entries of its own sections.
+
+class Icf_section_work : public Parallel_work
+{
+ public:
+  Icf_section_work(const char* name, unsigned int section_count)
+    : Parallel_work(name), section_count_(section_count)
+  { }
+
+  // Do all the sections, using WORKQUEUE if it is not NULL.
+  static void
+  run_work(Icf_section_work* work, Workqueue* workqueue)
+  {
+    unsigned int items = ((work->section_count_ + icf_sections_per_item - 1)
+			  / icf_sections_per_item);
+    unsigned int helpers = 0;
+    if (workqueue != NULL)
+      helpers = workqueue->thread_count() - 1;
+    work->run(workqueue, items, helpers);
+    work->release();
+  }
+
+ protected:
+  // Do section I.
+  virtual void
+  do_section(unsigned int i) = 0;
+
+  void
+  do_item(unsigned int item)
+  {
+    unsigned int start = item * icf_sections_per_item;
+    unsigned int end = std::min(start + icf_sections_per_item,
+				this->section_count_);
+    for (unsigned int i = start; i < end; ++i)
+      this->do_section(i);
+  }
+
+ private:
+  unsigned int section_count_;
+};
+
+// Hash strings, skipping the sections which are known to be unique.
+
+class Icf_hash_work : public Icf_section_work
+{
+ public:
+  Icf_hash_work(const std::vector<std::string>& contents,
+		const std::vector<bool>& is_secn_or_group_unique,
+		std::vector<uint64_t>* hashes)
+    : Icf_section_work("icf hash", contents.size()), contents_(contents),
+      is_secn_or_group_unique_(is_secn_or_group_unique), hashes_(hashes)
+  { }
+
+ protected:
+  void
+  do_section(unsigned int i)
+  {
+    if (!this->is_secn_or_group_unique_[i])
+      (*this->hashes_)[i] = icf_hash(this->contents_[i]);
+  }
+
+ private:
+  const std::vector<std::string>& contents_;
+  const std::vector<bool>& is_secn_or_group_unique_;
+  std::vector<uint64_t>* hashes_;
+};
+
 // This function determines if a section or a group of identical
 // sections has unique contents.  Such unique sections or groups can be
 // declared final and need not be processed any further.
@@ -162,22 +275,32 @@ namespace gold
 //                    that cannot be folded.   SECTION_CONTENTS are NULL
 //                    implies that this function is being called for the
 //                    first time before the first iteration of icf.
+// WORKQUEUE : If not NULL, used to hash SECTION_CONTENTS on several
+//             threads.
 
 static void
 preprocess_for_unique_sections(const std::vector<Section_id>& id_section,
                                std::vector<bool>* is_secn_or_group_unique,
-                               std::vector<std::string>* section_contents)
+                               std::vector<std::string>* section_contents,
+                               Workqueue* workqueue)
 {
-  Unordered_map<uint32_t, unsigned int> uniq_map;
-  std::pair<Unordered_map<uint32_t, unsigned int>::iterator, bool>
+  Unordered_map<uint64_t, unsigned int> uniq_map;
+  std::pair<Unordered_map<uint64_t, unsigned int>::iterator, bool>
     uniq_map_insert;
 
+  std::vector<uint64_t> hashes(id_section.size());
+  if (section_contents != NULL)
+    Icf_section_work::run_work(new Icf_hash_work(*section_contents,
+						 *is_secn_or_group_unique,
+						 &hashes),
+			       workqueue);
+
   for (unsigned int i = 0; i < id_section.size(); i++)
     {
       if ((*is_secn_or_group_unique)[i])
         continue;
 
-      uint32_t cksum;
+      uint64_t cksum;
       Section_id secn = id_section[i];
       section_size_type plen;
       if (section_contents == NULL)
@@ -191,15 +314,10 @@ preprocess_for_unique_sections(const std::vector<Section_id>& id_section,
           contents = secn.first->section_contents(secn.second,
                                                   &plen,
                                                   false);
-          cksum = xcrc32(contents, plen, 0xffffffff);
+          cksum = icf_hash(contents, plen);
         }
       else
-        {
-          const unsigned char* contents_array = reinterpret_cast
-            <const unsigned char*>((*section_contents)[i].c_str());
-          cksum = xcrc32(contents_array, (*section_contents)[i].length(),
-                         0xffffffff);
-        }
+        cksum = hashes[i];
       uniq_map_insert = uniq_map.insert(std::make_pair(cksum, i));
       if (uniq_map_insert.second)
         {
@@ -256,7 +374,9 @@ get_rel_addend(const unsigned char* reloc_addend_ptr,
 // text and relocs.  Relocs are differentiated as those pointing to
 // sections that could be folded and those that cannot.  Only relocs
 // pointing to sections that could be folded are recomputed on
-// subsequent invocations of this function.
+// subsequent invocations of this function.  Only the first
+// invocation reads the input file, and the caller must have locked
+// the object.  Later invocations may run on several threads at once.
 // Parameters  :
 // FIRST_ITERATION    : true if it is the first invocation.
 // SECN               : Section for which contents are desired.
@@ -266,6 +386,8 @@ get_rel_addend(const unsigned char* reloc_addend_ptr,
 // KEPT_SECTION_ID    : Vector which maps folded sections to kept sections.
 // SECTION_CONTENTS   : Store the section's text and relocs to non-ICF
 //                      sections.
+// TRACKED_SECTIONS   : If not NULL, store the unique section numbers of
+//                      the ICF sections that the relocs point to.
 
 static std::string
 get_section_contents(bool first_iteration,
@@ -274,14 +396,9 @@ get_section_contents(bool first_iteration,
                      unsigned int* num_tracked_relocs,
                      Symbol_table* symtab,
                      const std::vector<unsigned int>& kept_section_id,
-                     std::vector<std::string>* section_contents)
+                     std::vector<std::string>* section_contents,
+                     std::vector<unsigned int>* tracked_sections)
 {
-  // Lock the object so we can read from it.  This is only called
-  // single-threaded from queue_middle_tasks, so it is OK to lock.
-  // Unfortunately we have no way to pass in a Task token.
-  const Task* dummy_task = reinterpret_cast<const Task*>(-1);
-  Task_lock_obj<Object> tl(dummy_task, secn.first);
-
   section_size_type plen;
   const unsigned char* contents = NULL;
   if (first_iteration)
@@ -408,6 +525,8 @@ get_section_contents(bool first_iteration,
 
               char kept_section_str[10];
               unsigned int secn_id = section_id_map_it->second;
+              if (tracked_sections != NULL)
+                tracked_sections->push_back(secn_id);
               snprintf(kept_section_str, sizeof(kept_section_str), "%u",
                        kept_section_id[secn_id]);
               if (first_iteration)
@@ -560,6 +679,46 @@ get_section_contents(bool first_iteration,
   return buffer;
 }
 
+// Get the contents of the kept sections after the first iteration, on
+// several threads.
+
+class Icf_contents_work : public Icf_section_work
+{
+ public:
+  Icf_contents_work(Symbol_table* symtab,
+		    const std::vector<unsigned int>& kept_section_id,
+		    const std::vector<Section_id>& id_section,
+		    const std::vector<bool>& is_secn_or_group_unique,
+		    std::vector<std::string>* section_contents,
+		    std::vector<std::string>* full_section_contents)
+    : Icf_section_work("icf contents", id_section.size()), symtab_(symtab),
+      kept_section_id_(kept_section_id), id_section_(id_section),
+      is_secn_or_group_unique_(is_secn_or_group_unique),
+      section_contents_(section_contents),
+      full_section_contents_(full_section_contents)
+  { }
+
+ protected:
+  void
+  do_section(unsigned int i)
+  {
+    if (this->is_secn_or_group_unique_[i] || this->kept_section_id_[i] != i)
+      return;
+    (*this->full_section_contents_)[i] =
+      get_section_contents(false, this->id_section_[i], i, NULL,
+			   this->symtab_, this->kept_section_id_,
+			   this->section_contents_, NULL);
+  }
+
+ private:
+  Symbol_table* symtab_;
+  const std::vector<unsigned int>& kept_section_id_;
+  const std::vector<Section_id>& id_section_;
+  const std::vector<bool>& is_secn_or_group_unique_;
+  std::vector<std::string>* section_contents_;
+  std::vector<std::string>* full_section_contents_;
+};
+
 // This function computes a checksum on each section to detect and form
 // groups of identical sections.  The first iteration does this for all 
 // sections.
@@ -567,12 +726,18 @@ get_section_contents(bool first_iteration,
 // determine if larger groups of identical sections could be formed.  The
 // first section in each group is the kept section for that group.
 //
-// CRC32 is the checksumming algorithm and can have collisions.  That is,
+// The checksum is icf_hash, and can have collisions.  That is,
 // two sections with different contents can have the same checksum. Hence,
 // a multimap is used to maintain more than one group of checksum
 // identical sections.  A section is added to a group only after its
 // contents are explicitly compared with the kept section of the group.
 //
+// The contents of the sections are computed before the groups are
+// formed, possibly on several threads.  When a section is folded, the
+// contents of the sections with relocs to it change; those sections
+// are recomputed when they are reached, so that the groups are the
+// same as if each section were computed in turn.
+//
 // Parameters  :
 // ITERATION_NUM           : Invocation instance of this function.
 // NUM_TRACKED_RELOCS : Vector reference to store the number of relocs
@@ -583,78 +748,126 @@ get_section_contents(bool first_iteration,
 //                            sections is already known to be unique.
 // SECTION_CONTENTS   : Store the section's text and relocs to non-ICF
 //                      sections.
+// TRACKED_SECTIONS   : Store the ICF sections that each section's relocs
+//                      point to.
+// WORKQUEUE          : If not NULL, used to do the work on several
+//                      threads.
 
 static bool
 match_sections(unsigned int iteration_num,
                Symbol_table* symtab,
                std::vector<unsigned int>* num_tracked_relocs,
+               std::vector<std::vector<unsigned int> >* tracked_sections,
                std::vector<unsigned int>* kept_section_id,
                const std::vector<Section_id>& id_section,
 	       const std::vector<uint64_t>& section_addraligns,
                std::vector<bool>* is_secn_or_group_unique,
-               std::vector<std::string>* section_contents)
+               std::vector<std::string>* section_contents,
+               Workqueue* workqueue)
 {
-  Unordered_multimap<uint32_t, unsigned int> section_cksum;
-  std::pair<Unordered_multimap<uint32_t, unsigned int>::iterator,
-            Unordered_multimap<uint32_t, unsigned int>::iterator> key_range;
+  Unordered_multimap<uint64_t, unsigned int> section_cksum;
+  std::pair<Unordered_multimap<uint64_t, unsigned int>::iterator,
+            Unordered_multimap<uint64_t, unsigned int>::iterator> key_range;
   bool converged = true;
 
   if (iteration_num == 1)
     preprocess_for_unique_sections(id_section,
                                    is_secn_or_group_unique,
-                                   NULL);
+                                   NULL, workqueue);
   else
     preprocess_for_unique_sections(id_section,
                                    is_secn_or_group_unique,
-                                   section_contents);
+                                   section_contents, workqueue);
 
-  std::vector<std::string> full_section_contents;
+  // Get the contents of each section which may be folded.  The first
+  // iteration reads the input files, so it runs on this thread.
+  std::vector<std::string> full_section_contents(id_section.size());
+  if (iteration_num == 1)
+    {
+      for (unsigned int i = 0; i < id_section.size(); i++)
+	{
+	  if ((*is_secn_or_group_unique)[i])
+	    continue;
+
+	  Section_id secn = id_section[i];
+
+	  // Lock the object so we can read from it.  This is only
+	  // called single-threaded from queue_middle_tasks, so it is
+	  // OK to lock.  Unfortunately we have no way to pass in a
+	  // Task token.
+	  const Task* dummy_task = reinterpret_cast<const Task*>(-1);
+	  Task_lock_obj<Object> tl(dummy_task, secn.first);
+
+	  unsigned int num_relocs = 0;
+	  full_section_contents[i] =
+	    get_section_contents(true, secn, i, &num_relocs, symtab,
+				 (*kept_section_id), section_contents,
+				 &(*tracked_sections)[i]);
+	  (*num_tracked_relocs)[i] = num_relocs;
+	}
+    }
+  else
+    Icf_section_work::run_work(new Icf_contents_work(symtab,
+						     *kept_section_id,
+						     id_section,
+						     *is_secn_or_group_unique,
+						     section_contents,
+						     &full_section_contents),
+			       workqueue);
+
+  std::vector<uint64_t> hashes(id_section.size());
+  Icf_section_work::run_work(new Icf_hash_work(full_section_contents,
+					       *is_secn_or_group_unique,
+					       &hashes),
+			     workqueue);
+
+  // The sections whose kept section changed during this iteration.
+  std::vector<bool> is_secn_changed(id_section.size(), false);
+  bool any_secn_changed = false;
 
   for (unsigned int i = 0; i < id_section.size(); i++)
     {
-      full_section_contents.push_back("");
       if ((*is_secn_or_group_unique)[i])
         continue;
 
-      Section_id secn = id_section[i];
-      std::string this_secn_contents;
-      uint32_t cksum;
-      if (iteration_num == 1)
-        {
-          unsigned int num_relocs = 0;
-          this_secn_contents = get_section_contents(true, secn, i, &num_relocs,
-                                                    symtab, (*kept_section_id),
-                                                    section_contents);
-          (*num_tracked_relocs)[i] = num_relocs;
-        }
-      else
-        {
-          if ((*kept_section_id)[i] != i)
-            {
-              // This section is already folded into something.
-              continue;
-            }
-          this_secn_contents = get_section_contents(false, secn, i, NULL,
-                                                    symtab, (*kept_section_id),
-                                                    section_contents);
-        }
+      if (iteration_num > 1 && (*kept_section_id)[i] != i)
+	{
+	  // This section is already folded into something.
+	  continue;
+	}
 
-      const unsigned char* this_secn_contents_array =
-            reinterpret_cast<const unsigned char*>(this_secn_contents.c_str());
-      cksum = xcrc32(this_secn_contents_array, this_secn_contents.length(),
-                     0xffffffff);
+      // If a section that this one points to was folded above, the
+      // contents computed earlier are stale.
+      if (any_secn_changed)
+	{
+	  const std::vector<unsigned int>& tracked((*tracked_sections)[i]);
+	  for (size_t j = 0; j < tracked.size(); ++j)
+	    {
+	      if (is_secn_changed[tracked[j]])
+		{
+		  full_section_contents[i] =
+		    get_section_contents(false, id_section[i], i, NULL,
+					 symtab, (*kept_section_id),
+					 section_contents, NULL);
+		  hashes[i] = icf_hash(full_section_contents[i]);
+		  break;
+		}
+	    }
+	}
+
+      const std::string& this_secn_contents(full_section_contents[i]);
+      uint64_t cksum = hashes[i];
       size_t count = section_cksum.count(cksum);
 
       if (count == 0)
         {
           // Start a group with this cksum.
           section_cksum.insert(std::make_pair(cksum, i));
-          full_section_contents[i] = this_secn_contents;
         }
       else
         {
           key_range = section_cksum.equal_range(cksum);
-          Unordered_multimap<uint32_t, unsigned int>::iterator it;
+          Unordered_multimap<uint64_t, unsigned int>::iterator it;
           // Search all the groups with this cksum for a match.
           for (it = key_range.first; it != key_range.second; ++it)
             {
@@ -676,15 +889,18 @@ match_sections(unsigned int iteration_num,
 	      if (align_i <= align_kept)
 		{
 		  (*kept_section_id)[i] = kept_section;
+		  is_secn_changed[i] = true;
 		}
 	      else
 		{
 		  (*kept_section_id)[kept_section] = i;
+		  is_secn_changed[kept_section] = true;
 		  it->second = i;
 		  full_section_contents[kept_section].swap(
 		      full_section_contents[i]);
 		}
 
+              any_secn_changed = true;
               converged = false;
               break;
             }
@@ -692,7 +908,6 @@ match_sections(unsigned int iteration_num,
             {
               // Create a new group for this cksum.
               section_cksum.insert(std::make_pair(cksum, i));
-              full_section_contents[i] = this_secn_contents;
             }
         }
       // If there are no relocs to foldable sections do not process
@@ -748,11 +963,14 @@ is_function_ctor_or_dtor(const std::string& section_name)
 
 void
 Icf::find_identical_sections(const Input_objects* input_objects,
-                             Symbol_table* symtab)
+                             Symbol_table* symtab,
+                             Workqueue* workqueue)
 {
   unsigned int section_num = 0;
   std::vector<unsigned int> num_tracked_relocs;
+  std::vector<std::vector<unsigned int> > tracked_sections;
   std::vector<uint64_t> section_addraligns;
+  std::vector<uint64_t> section_sizes;
   std::vector<bool> is_secn_or_group_unique;
   std::vector<std::string> section_contents;
   const Target& target = parameters->target();
@@ -793,7 +1011,9 @@ Icf::find_identical_sections(const Input_objects* input_objects,
           this->section_id_[Section_id(*p, i)] = section_num;
           this->kept_section_id_.push_back(section_num);
           num_tracked_relocs.push_back(0);
+          tracked_sections.push_back(std::vector<unsigned int>());
 	  section_addraligns.push_back((*p)->section_addralign(i));
+	  section_sizes.push_back((*p)->section_size(i));
           is_secn_or_group_unique.push_back(false);
           section_contents.push_back("");
           section_num++;
@@ -809,13 +1029,26 @@ Icf::find_identical_sections(const Input_objects* input_objects,
 
   bool converged = false;
 
+  if (!parameters->options().threads())
+    workqueue = NULL;
+
   while (!converged && (num_iterations < max_iterations))
     {
       num_iterations++;
+
+      Timer timer;
+      if (parameters->options().stats())
+	timer.start();
+
       converged = match_sections(num_iterations, symtab,
-                                 &num_tracked_relocs, &this->kept_section_id_,
+                                 &num_tracked_relocs, &tracked_sections,
+                                 &this->kept_section_id_,
                                  this->id_section_, section_addraligns,
-                                 &is_secn_or_group_unique, &section_contents);
+                                 &is_secn_or_group_unique, &section_contents,
+                                 workqueue);
+
+      if (parameters->options().stats())
+	this->iteration_times_.push_back(timer.get_elapsed_time().wall);
     }
 
   if (parameters->options().print_icf_sections())
@@ -854,9 +1087,39 @@ Icf::find_identical_sections(const Input_objects* input_objects,
 
     }
 
+  if (parameters->options().stats())
+    {
+      for (unsigned int i = 0; i < this->kept_section_id_.size(); ++i)
+	{
+	  if (this->kept_section_id_[i] != i)
+	    {
+	      ++this->folded_sections_;
+	      this->folded_bytes_ += section_sizes[i];
+	    }
+	}
+    }
+
   this->icf_ready();
 }
 
+// Print statistics about ICF to stderr.  This is used for --stats.
+
+void
+Icf::print_stats() const
+{
+  fprintf(stderr, _("%s: ICF candidate sections: %zu\n"),
+	  program_name, this->id_section_.size());
+  for (unsigned int i = 0; i < this->iteration_times_.size(); ++i)
+    {
+      long wall = this->iteration_times_[i];
+      fprintf(stderr, _("%s: ICF iteration %u wall: %ld.%06ld\n"),
+	      program_name, i + 1, wall / 1000, (wall % 1000) * 1000);
+    }
+  fprintf(stderr, _("%s: ICF folded sections: %zu; folded bytes: %llu\n"),
+	  program_name, this->folded_sections_,
+	  static_cast<unsigned long long>(this->folded_bytes_));
+}
+
 // Unfolds the section denoted by OBJ and SHNDX if folded.
 
 void
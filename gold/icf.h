@@ -35,6 +35,7 @@ namespace gold
 class Object;
 class Input_objects;
 class Symbol_table;
+class Workqueue;
 
 class Icf
 {
@@ -68,7 +69,8 @@ class Icf
   : id_section_(), section_id_(), kept_section_id_(),
     fptr_section_id_(),
     icf_ready_(false),
-    reloc_info_list_()
+    reloc_info_list_(), iteration_times_(), folded_sections_(0),
+    folded_bytes_(0)
   { }
 
   // Returns the kept folded identical section corresponding to
@@ -77,10 +79,12 @@ class Icf
   get_folded_section(Relobj* dup_obj, unsigned int dup_shndx);
 
   // Forms groups of identical sections where the first member
-  // of each group is the kept section during folding.
+  // of each group is the kept section during folding.  WORKQUEUE
+  // is used to do some of the work on several threads.
   void
   find_identical_sections(const Input_objects* input_objects,
-                          Symbol_table* symtab);
+                          Symbol_table* symtab,
+                          Workqueue* workqueue);
 
   // This is set when ICF has been run and the groups of
   // identical sections have been formed.
@@ -142,6 +146,10 @@ class Icf
   section_to_int_map()
   { return this->section_id_; }
 
+  // Print statistics about ICF to stderr.
+  void
+  print_stats() const;
+
  private:
 
   // Maps integers to sections.
@@ -160,6 +168,12 @@ class Icf
   bool icf_ready_;
   // This list is populated by gc_process_relocs in gc.h.
   Reloc_info_list reloc_info_list_;
+  // For --stats, the wall time of each iteration in milliseconds.
+  std::vector<long> iteration_times_;
+  // For --stats, the number of sections folded.
+  size_t folded_sections_;
+  // For --stats, the total size of the sections folded.
+  uint64_t folded_bytes_;
 };
 
 // This function returns true if this section corresponds to a function that
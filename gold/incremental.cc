@@ -23,6 +23,7 @@
 #include "gold.h"
 
 #include <set>
+#include <cstring>
 #include <cstdarg>
 #include "libiberty.h"
 
@@ -171,6 +172,65 @@ Incremental_binary::error(const char* format, ...) const
   va_end(args);
 }
 
+// Print statistics about the incremental update to stderr.
+
+void
+Incremental_binary::print_stats() const
+{
+  fprintf(stderr, _("%s: incremental update: input files kept: %u of %u\n"),
+	  program_name, this->reused_input_count_,
+	  this->do_input_file_count());
+  fprintf(stderr, _("%s: incremental update: input sections kept: %u\n"),
+	  program_name, this->reused_section_count_);
+  fprintf(stderr, _("%s: incremental update: input section bytes kept: "
+		    "%lld\n"),
+	  program_name, static_cast<long long>(this->reused_section_bytes_));
+}
+
+// Explain which argument changed when the command line OLD_CMDLINE
+// of the previous link differs from NEW_CMDLINE.  The arguments are
+// separated by spaces, and quoted as by Incremental_inputs, so this
+// may split a quoted argument, but it is close enough to tell the
+// user what happened.
+
+static void
+explain_command_line_change(const char* old_cmdline,
+			    const std::string& new_cmdline)
+{
+  const char* po = old_cmdline;
+  const char* pn = new_cmdline.c_str();
+  unsigned int argno = 0;
+  while (1)
+    {
+      size_t lo = strcspn(po, " ");
+      size_t ln = strcspn(pn, " ");
+      if (lo != ln || strncmp(po, pn, lo) != 0)
+	{
+	  std::string old_arg(po, lo);
+	  std::string new_arg(pn, ln);
+	  if (lo == 0)
+	    explain_no_incremental(_("command line changed: "
+				     "argument %u %s added"),
+				   argno, new_arg.c_str());
+	  else if (ln == 0)
+	    explain_no_incremental(_("command line changed: "
+				     "argument %u %s removed"),
+				   argno, old_arg.c_str());
+	  else
+	    explain_no_incremental(_("command line changed: "
+				     "argument %u was %s, now %s"),
+				   argno, old_arg.c_str(), new_arg.c_str());
+	  return;
+	}
+      if (po[lo] == '\0' || pn[ln] == '\0')
+	break;
+      po += lo + 1;
+      pn += ln + 1;
+      ++argno;
+    }
+  explain_no_incremental(_("command line changed"));
+}
+
 // Return TRUE if a section of type SH_TYPE can be updated in place
 // during an incremental update.  We can update sections of type PROGBITS,
 // NOBITS, INIT_ARRAY, FINI_ARRAY, PREINIT_ARRAY, and NOTE.  All others
@@ -425,7 +485,8 @@ Sized_incremental_binary<size, big_endian>::do_check_inputs(
       gold_debug(DEBUG_INCREMENTAL,
 		 "new command line: %s",
 		 incremental_inputs->command_line().c_str());
-      explain_no_incremental(_("command line changed"));
+      explain_command_line_change(inputs.command_line(),
+				  incremental_inputs->command_line());
       return false;
     }
 
@@ -615,6 +676,7 @@ Sized_incremental_binary<size, big_endian>::do_reserve_layout(
       Output_section* os = this->section_map_[sect.output_shndx];
       gold_assert(os != NULL);
       os->reserve(sect.sh_offset, sect.sh_size);
+      this->add_reused_section(sect.sh_size);
     }
 }
 
@@ -2093,7 +2155,7 @@ Sized_relobj_incr<size, big_endian>::do_layout(
        ++p)
     {
       unsigned int i = *p;
-      layout->add_to_gdb_index(false, this, NULL, 0, i, 0, 0);
+      layout->add_to_gdb_index(false, this, false, i, 0, 0);
     }
   for (std::vector<unsigned int>::const_iterator p
 	   = debug_types_sections.begin();
@@ -2101,7 +2163,7 @@ Sized_relobj_incr<size, big_endian>::do_layout(
        ++p)
     {
       unsigned int i = *p;
-      layout->add_to_gdb_index(true, this, 0, 0, i, 0, 0);
+      layout->add_to_gdb_index(true, this, false, i, 0, 0);
     }
 }
 
@@ -2543,7 +2605,8 @@ template<int size, bool big_endian>
 void
 Sized_relobj_incr<size, big_endian>::do_relocate(const Symbol_table*,
 						 const Layout* layout,
-						 Output_file* of)
+						 Output_file* of,
+						 Workqueue*)
 {
   if (this->incr_reloc_count_ == 0)
     return;
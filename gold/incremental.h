@@ -1342,7 +1342,8 @@ class Incremental_binary
  public:
   Incremental_binary(Output_file* output, Target* /*target*/)
     : input_args_map_(), library_map_(), script_map_(),
-      output_(output)
+      reused_input_count_(0), reused_section_count_(0),
+      reused_section_bytes_(0), output_(output)
   { }
 
   virtual
@@ -1462,7 +1463,10 @@ class Incremental_binary
   // Mark regions of the input file that must be kept unchanged.
   void
   reserve_layout(unsigned int input_file_index)
-  { this->do_reserve_layout(input_file_index); }
+  {
+    ++this->reused_input_count_;
+    this->do_reserve_layout(input_file_index);
+  }
 
   // Process the GOT and PLT entries from the existing output file.
   void
@@ -1532,7 +1536,19 @@ class Incremental_binary
   output_file()
   { return this->output_; }
 
+  // Print statistics about the incremental update to stderr.
+  void
+  print_stats() const;
+
  protected:
+  // Record that an input section of SIZE bytes was kept unchanged.
+  void
+  add_reused_section(off_t size)
+  {
+    ++this->reused_section_count_;
+    this->reused_section_bytes_ += size;
+  }
+
   // Check the .gnu_incremental_inputs section to see whether an incremental
   // build is possible.
   virtual bool
@@ -1578,6 +1594,13 @@ class Incremental_binary
   std::vector<Script_info*> script_map_;
 
  private:
+  // For --stats, the number of input files whose contributions were
+  // kept from the base file.
+  unsigned int reused_input_count_;
+  // For --stats, the number of input sections kept from the base
+  // file, and their total size.
+  unsigned int reused_section_count_;
+  off_t reused_section_bytes_;
   // Edited output file object.
   Output_file* output_;
 };
@@ -2009,7 +2032,8 @@ class Sized_relobj_incr : public Sized_relobj<size, big_endian>
 
   // Relocate the input sections and write out the local symbols.
   void
-  do_relocate(const Symbol_table* symtab, const Layout*, Output_file* of);
+  do_relocate(const Symbol_table* symtab, const Layout*, Output_file* of,
+	      Workqueue*);
 
   // Set the offset of a section.
   void
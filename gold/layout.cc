@@ -239,18 +239,116 @@ Free_list::print_stats()
 	  program_name, Free_list::num_allocate_visits);
 }
 
-// A Hash_task computes the MD5 checksum of an array of char.
+// The 128-bit non-cryptographic hash used for --build-id=fast.  This
+// is MurmurHash3_x64_128 with a zero seed, which runs several times
+// faster than MD5 or SHA-1.  We read the input and write the result
+// as little-endian, so that the build ID does not depend on the host.
+// The interface is that of md5_buffer.
+
+static inline uint64_t
+fast_hash_rotl(uint64_t x, int r)
+{
+  return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t
+fast_hash_fmix(uint64_t k)
+{
+  k ^= k >> 33;
+  k *= 0xff51afd7ed558ccdULL;
+  k ^= k >> 33;
+  k *= 0xc4ceb9fe1a85ec53ULL;
+  k ^= k >> 33;
+  return k;
+}
+
+static void*
+fast_hash_buffer(const char* buffer, size_t len, void* resblock)
+{
+  const uint64_t c1 = 0x87c37b91114253d5ULL;
+  const uint64_t c2 = 0x4cf5ad432745937fULL;
+  const unsigned char* data = reinterpret_cast<const unsigned char*>(buffer);
+  const size_t nblocks = len / 16;
+  uint64_t h1 = 0;
+  uint64_t h2 = 0;
+
+  for (size_t i = 0; i < nblocks; ++i, data += 16)
+    {
+      uint64_t k1 = elfcpp::Swap_unaligned<64, false>::readval(data);
+      uint64_t k2 = elfcpp::Swap_unaligned<64, false>::readval(data + 8);
+
+      k1 *= c1;
+      k1 = fast_hash_rotl(k1, 31);
+      k1 *= c2;
+      h1 ^= k1;
+      h1 = fast_hash_rotl(h1, 27);
+      h1 += h2;
+      h1 = h1 * 5 + 0x52dce729;
+
+      k2 *= c2;
+      k2 = fast_hash_rotl(k2, 33);
+      k2 *= c1;
+      h2 ^= k2;
+      h2 = fast_hash_rotl(h2, 31);
+      h2 += h1;
+      h2 = h2 * 5 + 0x38495ab5;
+    }
+
+  // DATA now points at the last LEN % 16 bytes.
+  const size_t tail = len & 15;
+  if (tail > 8)
+    {
+      uint64_t k2 = 0;
+      for (size_t i = tail; i > 8; --i)
+	k2 ^= static_cast<uint64_t>(data[i - 1]) << ((i - 9) * 8);
+      k2 *= c2;
+      k2 = fast_hash_rotl(k2, 33);
+      k2 *= c1;
+      h2 ^= k2;
+    }
+  if (tail > 0)
+    {
+      uint64_t k1 = 0;
+      for (size_t i = std::min(tail, static_cast<size_t>(8)); i > 0; --i)
+	k1 ^= static_cast<uint64_t>(data[i - 1]) << ((i - 1) * 8);
+      k1 *= c1;
+      k1 = fast_hash_rotl(k1, 31);
+      k1 *= c2;
+      h1 ^= k1;
+    }
+
+  h1 ^= len;
+  h2 ^= len;
+  h1 += h2;
+  h2 += h1;
+  h1 = fast_hash_fmix(h1);
+  h2 = fast_hash_fmix(h2);
+  h1 += h2;
+  h2 += h1;
+
+  unsigned char* res = static_cast<unsigned char*>(resblock);
+  elfcpp::Swap_unaligned<64, false>::writeval(res, h1);
+  elfcpp::Swap_unaligned<64, false>::writeval(res + 8, h2);
+  return resblock;
+}
+
+// A Hash_task computes a 16 byte checksum of an array of char, using
+// MD5 for --build-id=tree and fast_hash_buffer for --build-id=fast.
 
 class Hash_task : public Task
 {
  public:
+  // The type of md5_buffer and fast_hash_buffer.
+  typedef void* (*Hash_function)(const char*, size_t, void*);
+
   Hash_task(Output_file* of,
 	    size_t offset,
 	    size_t size,
 	    unsigned char* dst,
+	    Hash_function hash_function,
 	    Task_token* final_blocker)
     : of_(of), offset_(offset), size_(size), dst_(dst),
-      final_blocker_(final_blocker)
+      hash_function_(hash_function), final_blocker_(final_blocker)
   { }
 
   void
@@ -258,7 +356,8 @@ class Hash_task : public Task
   {
     const unsigned char* iv =
 	this->of_->get_input_view(this->offset_, this->size_);
-    md5_buffer(reinterpret_cast<const char*>(iv), this->size_, this->dst_);
+    this->hash_function_(reinterpret_cast<const char*>(iv), this->size_,
+			 this->dst_);
     this->of_->free_input_view(this->offset_, this->size_, iv);
   }
 
@@ -280,6 +379,7 @@ class Hash_task : public Task
   const size_t offset_;
   const size_t size_;
   unsigned char* const dst_;
+  Hash_function const hash_function_;
   Task_token* const final_blocker_;
 };
 
@@ -372,6 +472,10 @@ Layout_task_runner::run(Workqueue* workqueue, const Task* task)
   this->symtab_->detect_odr_violations(task, this->options_.output_file_name());
 
   Layout* layout = this->layout_;
+
+  if (parameters->options().threads())
+    layout->merge_strings(workqueue);
+
   off_t file_size = layout->finalize(this->input_objects_,
 				     this->symtab_,
 				     this->target_,
@@ -447,10 +551,12 @@ Layout::Layout(int number_of_input_files, Script_options* script_options)
     eh_frame_data_(NULL),
     added_eh_frame_data_(false),
     eh_frame_hdr_section_(NULL),
+    eh_frame_hdr_data_(NULL),
     gdb_index_data_(NULL),
     build_id_note_(NULL),
     debug_abbrev_(NULL),
     debug_info_(NULL),
+    compressed_sections_(),
     group_signatures_(),
     output_file_size_(-1),
     have_added_input_section_(false),
@@ -1550,6 +1656,7 @@ Layout::make_eh_frame_section(const Relobj* object)
 		}
 
 	      this->eh_frame_data_->set_eh_frame_hdr(hdr_posd);
+	      this->eh_frame_hdr_data_ = hdr_posd;
 	    }
 	}
     }
@@ -1598,15 +1705,14 @@ Layout::remove_eh_frame_for_plt(Output_data* plt, const unsigned char* cie_data,
 					       fde_data, fde_length);
 }
 
-// Scan a .debug_info or .debug_types section, and add summary
-// information to the .gdb_index section.
+// Record a .debug_info or .debug_types section, to be scanned later
+// to add summary information to the .gdb_index section.
 
 template<int size, bool big_endian>
 void
 Layout::add_to_gdb_index(bool is_type_unit,
 			 Sized_relobj<size, big_endian>* object,
-			 const unsigned char* symbols,
-			 off_t symbols_size,
+			 bool has_symbols,
 			 unsigned int shndx,
 			 unsigned int reloc_shndx,
 			 unsigned int reloc_type)
@@ -1625,9 +1731,19 @@ Layout::add_to_gdb_index(bool is_type_unit,
       os->set_after_input_sections();
     }
 
-  this->gdb_index_data_->scan_debug_info(is_type_unit, object, symbols,
-					 symbols_size, shndx, reloc_shndx,
-					 reloc_type);
+  this->gdb_index_data_->add_debug_info_section(is_type_unit, object,
+						has_symbols, shndx,
+						reloc_shndx, reloc_type);
+}
+
+// Queue the tasks which scan the sections recorded by
+// add_to_gdb_index.
+
+void
+Layout::queue_gdb_index_tasks(Workqueue* workqueue, Task_token* blocker)
+{
+  if (this->gdb_index_data_ != NULL)
+    this->gdb_index_data_->queue_scan_tasks(workqueue, blocker);
 }
 
 // Add POSD to an output section using NAME, TYPE, and FLAGS.  Return
@@ -1674,8 +1790,13 @@ Layout::make_output_section(const char* name, elfcpp::Elf_Word type,
   if ((flags & elfcpp::SHF_ALLOC) == 0
       && strcmp(parameters->options().compress_debug_sections(), "none") != 0
       && is_compressible_debug_section(name))
-    os = new Output_compressed_section(&parameters->options(), name, type,
-				       flags);
+    {
+      Output_compressed_section* ocs =
+	new Output_compressed_section(&parameters->options(), name, type,
+				      flags);
+      this->compressed_sections_.push_back(ocs);
+      os = ocs;
+    }
   else if ((flags & elfcpp::SHF_ALLOC) == 0
 	   && parameters->options().strip_debug_non_line()
 	   && strcmp(".debug_abbrev", name) == 0)
@@ -2677,6 +2798,17 @@ Layout::read_layout_from_file()
     }
 }
 
+// Merge the strings of the merged string sections.
+
+void
+Layout::merge_strings(Workqueue* workqueue)
+{
+  for (Section_list::const_iterator p = this->section_list_.begin();
+       p != this->section_list_.end();
+       ++p)
+    (*p)->merge_strings(workqueue);
+}
+
 // Finalize the layout.  When this is called, we have created all the
 // output sections and all the output segments which are based on
 // input sections.  We have several things to do, and we have to do
@@ -3098,7 +3230,7 @@ Layout::create_build_id()
   // set DESC to the note descriptor contents.
   size_t descsz;
   std::string desc;
-  if (strcmp(style, "md5") == 0)
+  if (strcmp(style, "md5") == 0 || strcmp(style, "fast") == 0)
     descsz = 128 / 8;
   else if ((strcmp(style, "sha1") == 0) || (strcmp(style, "tree") == 0))
     descsz = 160 / 8;
@@ -5453,7 +5585,8 @@ Layout::write_data(const Symbol_table* symtab, Output_file* of) const
 // input sections are complete.
 
 void
-Layout::write_sections_after_input_sections(Output_file* of)
+Layout::write_sections_after_input_sections(Output_file* of,
+					    Workqueue* workqueue)
 {
   // Determine the final section offsets, and thus the final output
   // file size.  Note we finalize the .shstrab last, to allow the
@@ -5461,6 +5594,14 @@ Layout::write_sections_after_input_sections(Output_file* of)
   // writing.
   if (this->any_postprocessing_sections_)
     {
+      // The compressed sections are compressed when their final size
+      // is set, and may use other threads to do it.
+      for (std::vector<Output_compressed_section*>::const_iterator p =
+	     this->compressed_sections_.begin();
+	   p != this->compressed_sections_.end();
+	   ++p)
+	(*p)->set_workqueue(workqueue);
+
       off_t off = this->output_file_size_;
       off = this->set_section_offsets(off, POSTPROCESSING_SECTIONS_PASS);
 
@@ -5476,6 +5617,10 @@ Layout::write_sections_after_input_sections(Output_file* of)
 	}
     }
 
+  // The .eh_frame_hdr table may be sorted using other threads.
+  if (this->eh_frame_hdr_data_ != NULL)
+    this->eh_frame_hdr_data_->set_workqueue(workqueue);
+
   for (Section_list::const_iterator p = this->section_list_.begin();
        p != this->section_list_.end();
        ++p)
@@ -5513,6 +5658,9 @@ Layout::write_build_id(Output_file* of, unsigned char* array_of_hashes,
 	sha1_buffer(reinterpret_cast<const char*>(iv), output_file_size, ov);
       else if (strcmp(style, "md5") == 0)
 	md5_buffer(reinterpret_cast<const char*>(iv), output_file_size, ov);
+      else if (strcmp(style, "fast") == 0)
+	fast_hash_buffer(reinterpret_cast<const char*>(iv), output_file_size,
+			 ov);
       else
 	gold_unreachable();
 
@@ -5521,9 +5669,14 @@ Layout::write_build_id(Output_file* of, unsigned char* array_of_hashes,
   else
     {
       // Non-overlapping substrings of the output file have been hashed.
-      // Compute SHA-1 hash of the hashes.
-      sha1_buffer(reinterpret_cast<const char*>(array_of_hashes),
-		  size_of_hashes, ov);
+      // Compute the hash of the hashes: SHA-1 for --build-id=tree,
+      // the fast hash for --build-id=fast.
+      if (strcmp(parameters->options().build_id(), "fast") == 0)
+	fast_hash_buffer(reinterpret_cast<const char*>(array_of_hashes),
+			 size_of_hashes, ov);
+      else
+	sha1_buffer(reinterpret_cast<const char*>(array_of_hashes),
+		    size_of_hashes, ov);
       delete[] array_of_hashes;
     }
 
@@ -5718,14 +5871,16 @@ Write_after_input_sections_task::locks(Task_locker* tl)
 // Run the task.
 
 void
-Write_after_input_sections_task::run(Workqueue*)
+Write_after_input_sections_task::run(Workqueue* workqueue)
 {
-  this->layout_->write_sections_after_input_sections(this->of_);
+  this->layout_->write_sections_after_input_sections(this->of_, workqueue);
 }
 
 // Build IDs can be computed as a "flat" sha1 or md5 of a string of bytes,
 // or as a "tree" where each chunk of the string is hashed and then those
 // hashes are put into a (much smaller) string which is hashed with sha1.
+// The "fast" style is always computed as a tree, whatever the size of
+// the file, using fast_hash_buffer for both levels.
 // We compute a checksum over the entire file because that is simplest.
 
 void
@@ -5739,27 +5894,34 @@ Build_id_task_runner::run(Workqueue* workqueue, const Task*)
   unsigned char* array_of_hashes = NULL;
   size_t size_of_hashes = 0;
 
-  if (strcmp(this->options_->build_id(), "tree") == 0
+  const char* style = this->options_->build_id();
+  bool is_fast = strcmp(style, "fast") == 0;
+  if ((is_fast
+       || (strcmp(style, "tree") == 0
+	   && (filesize
+	       >= this->options_->build_id_min_file_size_for_treehash())))
       && this->options_->build_id_chunk_size_for_treehash() > 0
-      && filesize > 0
-      && (filesize >= this->options_->build_id_min_file_size_for_treehash()))
+      && filesize > 0)
     {
-      static const size_t MD5_OUTPUT_SIZE_IN_BYTES = 16;
+      static const size_t CHUNK_HASH_SIZE_IN_BYTES = 16;
       const size_t chunk_size =
 	  this->options_->build_id_chunk_size_for_treehash();
       const size_t num_hashes = ((filesize - 1) / chunk_size) + 1;
+      Hash_task::Hash_function hash_function =
+	is_fast ? fast_hash_buffer : md5_buffer;
       post_hash_tasks_blocker->add_blockers(num_hashes);
-      size_of_hashes = num_hashes * MD5_OUTPUT_SIZE_IN_BYTES;
+      size_of_hashes = num_hashes * CHUNK_HASH_SIZE_IN_BYTES;
       array_of_hashes = new unsigned char[size_of_hashes];
       unsigned char *dst = array_of_hashes;
       for (size_t i = 0, src_offset = 0; i < num_hashes;
-	   i++, dst += MD5_OUTPUT_SIZE_IN_BYTES, src_offset += chunk_size)
+	   i++, dst += CHUNK_HASH_SIZE_IN_BYTES, src_offset += chunk_size)
 	{
 	  size_t size = std::min(chunk_size, filesize - src_offset);
 	  workqueue->queue(new Hash_task(of,
 					 src_offset,
 					 size,
 					 dst,
+					 hash_function,
 					 post_hash_tasks_blocker));
 	}
     }
@@ -6026,8 +6188,7 @@ template
 void
 Layout::add_to_gdb_index(bool is_type_unit,
 			 Sized_relobj<32, false>* object,
-			 const unsigned char* symbols,
-			 off_t symbols_size,
+			 bool has_symbols,
 			 unsigned int shndx,
 			 unsigned int reloc_shndx,
 			 unsigned int reloc_type);
@@ -6038,8 +6199,7 @@ template
 void
 Layout::add_to_gdb_index(bool is_type_unit,
 			 Sized_relobj<32, true>* object,
-			 const unsigned char* symbols,
-			 off_t symbols_size,
+			 bool has_symbols,
 			 unsigned int shndx,
 			 unsigned int reloc_shndx,
 			 unsigned int reloc_type);
@@ -6050,8 +6210,7 @@ template
 void
 Layout::add_to_gdb_index(bool is_type_unit,
 			 Sized_relobj<64, false>* object,
-			 const unsigned char* symbols,
-			 off_t symbols_size,
+			 bool has_symbols,
 			 unsigned int shndx,
 			 unsigned int reloc_shndx,
 			 unsigned int reloc_type);
@@ -6062,8 +6221,7 @@ template
 void
 Layout::add_to_gdb_index(bool is_type_unit,
 			 Sized_relobj<64, true>* object,
-			 const unsigned char* symbols,
-			 off_t symbols_size,
+			 bool has_symbols,
 			 unsigned int shndx,
 			 unsigned int reloc_shndx,
 			 unsigned int reloc_type);
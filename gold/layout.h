@@ -57,7 +57,9 @@ class Output_data_dynamic;
 class Output_symtab_xindex;
 class Output_reduced_debug_abbrev_section;
 class Output_reduced_debug_info_section;
+class Output_compressed_section;
 class Eh_frame;
+class Eh_frame_hdr;
 class Gdb_index;
 class Target;
 struct Timespec;
@@ -660,18 +662,24 @@ class Layout
 			  size_t cie_length, const unsigned char* fde_data,
 			  size_t fde_length);
 
-  // Scan a .debug_info or .debug_types section, and add summary
-  // information to the .gdb_index section.
+  // Record a .debug_info or .debug_types section, to be scanned later
+  // to add summary information to the .gdb_index section.
+  // HAS_SYMBOLS is true if the relocations should be applied using
+  // the symbol table of OBJECT.
   template<int size, bool big_endian>
   void
   add_to_gdb_index(bool is_type_unit,
 		   Sized_relobj<size, big_endian>* object,
-		   const unsigned char* symbols,
-		   off_t symbols_size,
+		   bool has_symbols,
 		   unsigned int shndx,
 		   unsigned int reloc_shndx,
 		   unsigned int reloc_type);
 
+  // Queue the tasks which scan the sections recorded by
+  // add_to_gdb_index.  BLOCKER is blocked until they are done.
+  void
+  queue_gdb_index_tasks(Workqueue* workqueue, Task_token* blocker);
+
   // Handle a GNU stack note.  This is called once per input object
   // file.  SEEN_GNU_STACK is true if the object file has a
   // .note.GNU-stack section.  GNU_STACK_FLAGS is the section flags
@@ -799,6 +807,12 @@ class Layout
 			   unsigned int shndx, bool is_comdat,
 			   bool is_group_name, Kept_section** kept_section);
 
+  // Merge the strings of the merged string sections, using WORKQUEUE
+  // to merge them on several threads.  This is called after all the
+  // input sections have been added, before finalize.
+  void
+  merge_strings(Workqueue* workqueue);
+
   // Finalize the layout after all the input sections have been added.
   off_t
   finalize(const Input_objects*, Symbol_table*, Target*, const Task*);
@@ -858,9 +872,10 @@ class Layout
   write_data(const Symbol_table*, Output_file*) const;
 
   // Write out output sections which can not be written until all the
-  // input sections are complete.
+  // input sections are complete.  WORKQUEUE may be used to compress
+  // sections on several threads.
   void
-  write_sections_after_input_sections(Output_file* of);
+  write_sections_after_input_sections(Output_file* of, Workqueue* workqueue);
 
   // Return an output section named NAME, or NULL if there is none.
   Output_section*
@@ -1386,6 +1401,8 @@ class Layout
   bool added_eh_frame_data_;
   // The exception frame header output section if there is one.
   Output_section* eh_frame_hdr_section_;
+  // The exception frame header data if there is one.
+  Eh_frame_hdr* eh_frame_hdr_data_;
   // The data for the .gdb_index section.
   Gdb_index* gdb_index_data_;
   // The space for the build ID checksum if there is one.
@@ -1394,6 +1411,8 @@ class Layout
   Output_reduced_debug_abbrev_section* debug_abbrev_;
   // The output section containing the dwarf debug info tree
   Output_reduced_debug_info_section* debug_info_;
+  // The output sections whose contents are compressed.
+  std::vector<Output_compressed_section*> compressed_sections_;
   // A list of group sections and their signatures.
   Group_signatures group_signatures_;
   // The size of the output file.
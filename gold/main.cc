@@ -154,6 +154,9 @@ main(int argc, char** argv)
   // This is used by write_debug_script(), which wants the unedited argv.
   std::string args = collect_argv(argc, argv);
 
+  // This is used to restart a failed --incremental update.
+  set_incremental_restart_argv(argc, argv);
+
   Errors errors(program_name);
 
   // Initialize the global parameters, to let random code get to the
@@ -301,9 +304,15 @@ main(int argc, char** argv)
       fprintf(stderr, _("%s: output file size: %lld bytes\n"),
 	      program_name, static_cast<long long>(layout.output_file_size()));
       symtab.print_stats();
+      input_objects.print_stats();
+      if (symtab.icf() != NULL)
+	symtab.icf()->print_stats();
       layout.print_stats();
+      if (layout.incremental_base() != NULL)
+	layout.incremental_base()->print_stats();
       Gdb_index::print_stats();
       Free_list::print_stats();
+      workqueue.print_stats();
     }
 
   // Issue defined symbol report.
@@ -25,6 +25,7 @@
 #include <cstdlib>
 #include <algorithm>
 
+#include "workqueue.h"
 #include "merge.h"
 #include "compressed_output.h"
 
@@ -170,6 +171,25 @@ Object_merge_map::get_output_offset(unsigned int shndx,
   return true;
 }
 
+// Sort the mappings of all the input sections.
+
+void
+Object_merge_map::sort_mappings()
+{
+  for (Section_merge_maps::iterator p = this->section_merge_maps_.begin();
+       p != this->section_merge_maps_.end();
+       ++p)
+    {
+      Input_merge_map* map = p->second;
+      if (!map->sorted)
+	{
+	  std::sort(map->entries.begin(), map->entries.end(),
+		    Input_merge_compare());
+	  map->sorted = true;
+	}
+    }
+}
+
 // Return whether this is the merge map for section SHNDX.
 
 const Output_section_data*
@@ -431,6 +451,49 @@ Output_merge_data::do_print_merge_stats(const char* section_name)
 
 // Class Output_merge_string.
 
+// The number of shards the strings are split into when using
+// threads.
+
+static const unsigned int merge_string_shard_count = 32;
+
+template<typename Char_type>
+Output_merge_string<Char_type>::Output_merge_string(uint64_t addralign)
+  : Output_merge_base(sizeof(Char_type), addralign), stringpools_(),
+    merged_strings_lists_(), merge_later_(false),
+    unmerged_list_(0), input_count_(0), input_size_(0), merged_size_(0)
+{
+  // Only split the strings into shards when using threads.  When
+  // optimizing, the Stringpool merges strings which are suffixes of
+  // other strings, and splitting the strings into shards would stop
+  // that.
+  unsigned int shard_count = 1;
+  if (parameters->options_valid()
+      && parameters->options().threads()
+      && parameters->options().optimize() < 2)
+    shard_count = merge_string_shard_count;
+
+  this->stringpools_.resize(shard_count);
+  for (unsigned int i = 0; i < shard_count; ++i)
+    {
+      this->stringpools_[i] = new Stringpool_template<Char_type>(addralign);
+      this->stringpools_[i]->set_no_zero_null();
+    }
+
+  this->merge_later_ = shard_count > 1;
+}
+
+template<typename Char_type>
+Output_merge_string<Char_type>::~Output_merge_string()
+{
+  for (typename Merged_strings_lists::iterator p =
+	 this->merged_strings_lists_.begin();
+       p != this->merged_strings_lists_.end();
+       ++p)
+    delete *p;
+  for (unsigned int i = 0; i < this->stringpools_.size(); ++i)
+    delete this->stringpools_[i];
+}
+
 // Add an input section to a merged string section.
 
 template<typename Char_type>
@@ -444,6 +507,16 @@ Output_merge_string<Char_type>::do_add_input_section(Relobj* object,
 								     &sec_len,
 								     &is_new);
 
+  // If we merge the strings later, we need our own copy of the
+  // contents.
+  if (this->merge_later_ && !is_new)
+    {
+      unsigned char* copy = new unsigned char[sec_len];
+      memcpy(copy, pdata, sec_len);
+      pdata = copy;
+      is_new = true;
+    }
+
   const Char_type* p = reinterpret_cast<const Char_type*>(pdata);
   const Char_type* pend = p + sec_len / sizeof(Char_type);
   const Char_type* pend0 = pend;
@@ -472,6 +545,11 @@ Output_merge_string<Char_type>::do_add_input_section(Relobj* object,
       new Merged_strings_list(object, shndx);
   this->merged_strings_lists_.push_back(merged_strings_list);
   Merged_strings& merged_strings = merged_strings_list->merged_strings;
+  if (this->merge_later_)
+    {
+      merged_strings_list->contents = pdata;
+      is_new = false;
+    }
 
   // Count the number of non-null strings in the section and size the list.
   size_t count = 0;
@@ -507,8 +585,14 @@ Output_merge_string<Char_type>::do_add_input_section(Relobj* object,
 	      != init_align_modulo))
 	  has_misaligned_strings = true;
 
-      Stringpool::Key key;
-      this->stringpool_.add_with_length(p, len, true, &key);
+      // If we merge the strings later, the key is set then.
+      Stringpool::Key key = 0;
+      if (!this->merge_later_)
+	{
+	  unsigned int shard = this->shard(p, len);
+	  this->stringpools_[shard]->add_with_length(p, len, true, &key);
+	  key = this->make_key(shard, key);
+	}
 
       merged_strings.push_back(Merged_string(i, key));
       p += len + 1;
@@ -538,6 +622,149 @@ Output_merge_string<Char_type>::do_add_input_section(Relobj* object,
   return true;
 }
 
+// Each item of a Merge_strings_work calls a member function of an
+// Output_merge_string.
+
+template<typename Char_type>
+class Output_merge_string<Char_type>::Merge_strings_work
+  : public Parallel_work
+{
+ public:
+  typedef void (Output_merge_string<Char_type>::*Function)(unsigned int);
+
+  Merge_strings_work(Output_merge_string<Char_type>* pomb, Function function)
+    : Parallel_work("merge strings"), pomb_(pomb), function_(function)
+  { }
+
+ protected:
+  void
+  do_item(unsigned int i)
+  { (this->pomb_->*this->function_)(i); }
+
+ private:
+  Output_merge_string<Char_type>* pomb_;
+  Function function_;
+};
+
+template<typename Char_type>
+void
+Output_merge_string<Char_type>::run_merge_work(
+    Workqueue* workqueue,
+    unsigned int count,
+    void (Output_merge_string::*function)(unsigned int))
+{
+  unsigned int helpers = 0;
+  if (workqueue != NULL)
+    helpers = workqueue->thread_count() - 1;
+  Merge_strings_work* work = new Merge_strings_work(this, function);
+  work->run(workqueue, count, helpers);
+  work->release();
+}
+
+// Sort the strings of unmerged input section I by shard.  This only
+// looks at the one input section, so it may run at the same time as
+// the other input sections.
+
+template<typename Char_type>
+void
+Output_merge_string<Char_type>::find_shards(unsigned int i)
+{
+  Merged_strings_list* l = this->merged_strings_lists_[this->unmerged_list_
+						       + i];
+  const Merged_strings& merged_strings(l->merged_strings);
+  const unsigned char* contents = l->contents;
+  unsigned int shard_count = this->stringpools_.size();
+
+  // The last entry only records the end of the section.
+  unsigned int count = merged_strings.size() - 1;
+  std::vector<unsigned int> shards(count);
+  l->shard_starts.assign(shard_count + 1, 0);
+  for (unsigned int j = 0; j < count; ++j)
+    {
+      const Merged_string& ms(merged_strings[j]);
+      const Char_type* p =
+	reinterpret_cast<const Char_type*>(contents + ms.offset);
+      size_t len = ((merged_strings[j + 1].offset - ms.offset)
+		    / sizeof(Char_type) - 1);
+      shards[j] = this->shard(p, len);
+      ++l->shard_starts[shards[j] + 1];
+    }
+
+  for (unsigned int s = 0; s < shard_count; ++s)
+    l->shard_starts[s + 1] += l->shard_starts[s];
+
+  std::vector<unsigned int> next(l->shard_starts.begin(),
+				 l->shard_starts.end() - 1);
+  l->shard_order.resize(count);
+  for (unsigned int j = 0; j < count; ++j)
+    l->shard_order[next[shards[j]]++] = j;
+}
+
+// Add the strings of the unmerged input sections which belong in
+// SHARD to its Stringpool, in the order in which the input sections
+// were seen.  This only touches the strings of the one shard, so it
+// may run at the same time as the other shards.
+
+template<typename Char_type>
+void
+Output_merge_string<Char_type>::add_shard_strings(unsigned int shard)
+{
+  Stringpool_template<Char_type>* stringpool = this->stringpools_[shard];
+  for (unsigned int i = this->unmerged_list_;
+       i < this->merged_strings_lists_.size();
+       ++i)
+    {
+      Merged_strings_list* l = this->merged_strings_lists_[i];
+      Merged_strings& merged_strings(l->merged_strings);
+      for (unsigned int k = l->shard_starts[shard];
+	   k < l->shard_starts[shard + 1];
+	   ++k)
+	{
+	  unsigned int j = l->shard_order[k];
+	  Merged_string& ms(merged_strings[j]);
+	  const Char_type* p =
+	    reinterpret_cast<const Char_type*>(l->contents + ms.offset);
+	  size_t len = ((merged_strings[j + 1].offset - ms.offset)
+			/ sizeof(Char_type) - 1);
+	  Stringpool::Key key;
+	  stringpool->add_with_length(p, len, true, &key);
+	  ms.stringpool_key = this->make_key(shard, key);
+	}
+    }
+}
+
+// Add the strings of the input sections seen since the last call to
+// the Stringpools.  First each input section sorts its strings by
+// shard, and then each shard adds its strings from every input
+// section.  Both steps may use several threads.
+
+template<typename Char_type>
+void
+Output_merge_string<Char_type>::do_merge_strings(Workqueue* workqueue)
+{
+  if (!this->merge_later_
+      || this->unmerged_list_ >= this->merged_strings_lists_.size())
+    return;
+
+  this->run_merge_work(workqueue,
+		       this->merged_strings_lists_.size() - this->unmerged_list_,
+		       &Output_merge_string::find_shards);
+  this->run_merge_work(workqueue, this->stringpools_.size(),
+		       &Output_merge_string::add_shard_strings);
+
+  for (unsigned int i = this->unmerged_list_;
+       i < this->merged_strings_lists_.size();
+       ++i)
+    {
+      Merged_strings_list* l = this->merged_strings_lists_[i];
+      delete[] l->contents;
+      l->contents = NULL;
+      std::vector<unsigned int>().swap(l->shard_order);
+      std::vector<unsigned int>().swap(l->shard_starts);
+    }
+  this->unmerged_list_ = this->merged_strings_lists_.size();
+}
+
 // Finalize the mappings from the input sections to the output
 // section, and return the final data size.
 
@@ -545,7 +772,20 @@ template<typename Char_type>
 section_size_type
 Output_merge_string<Char_type>::finalize_merged_data()
 {
-  this->stringpool_.set_string_offsets();
+  // Normally the strings have been merged already, on several
+  // threads.
+  this->do_merge_strings(NULL);
+
+  section_offset_type offset;
+  if (this->stringpools_.size() == 1)
+    {
+      this->stringpools_[0]->set_string_offsets();
+      offset = (this->stringpools_[0]->empty()
+		? 0
+		: this->stringpools_[0]->get_strtab_size());
+    }
+  else
+    offset = this->set_shard_string_offsets();
 
   for (typename Merged_strings_lists::const_iterator l =
 	 this->merged_strings_lists_.begin();
@@ -570,8 +810,7 @@ Output_merge_string<Char_type>::finalize_merged_data()
                                          last_output_offset);
 	  last_input_offset = p->offset;
 	  if (p->stringpool_key != 0)
-	    last_output_offset =
-	        this->stringpool_.get_offset_from_key(p->stringpool_key);
+	    last_output_offset = this->key_offset(p->stringpool_key);
 	}
       delete *l;
     }
@@ -580,8 +819,55 @@ Output_merge_string<Char_type>::finalize_merged_data()
   // if called twice, as may happen if Layout::set_segment_offsets
   // finds a better alignment.
   this->merged_strings_lists_.clear();
+  this->unmerged_list_ = 0;
 
-  return this->stringpool_.get_strtab_size();
+  return offset;
+}
+
+// Lay out the strings of the shards in the order in which they were
+// first seen, as a single Stringpool does, so that the output is the
+// same as without threads.  Return the size of the section.
+
+template<typename Char_type>
+section_offset_type
+Output_merge_string<Char_type>::set_shard_string_offsets()
+{
+  // If we have already done this, the strings have been forgotten.
+  if (this->merged_strings_lists_.empty())
+    return this->merged_size_;
+
+  unsigned int shard_count = this->stringpools_.size();
+  std::vector<std::vector<section_offset_type> > offsets(shard_count);
+  for (unsigned int i = 0; i < shard_count; ++i)
+    offsets[i].assign(this->stringpools_[i]->size(), -1);
+
+  section_offset_type offset = 0;
+  for (typename Merged_strings_lists::const_iterator l =
+	 this->merged_strings_lists_.begin();
+       l != this->merged_strings_lists_.end();
+       ++l)
+    {
+      const Merged_strings& merged_strings((*l)->merged_strings);
+      // The last entry only records the end of the section.
+      for (unsigned int j = 0; j + 1 < merged_strings.size(); ++j)
+	{
+	  Stringpool::Key key = merged_strings[j].stringpool_key;
+	  unsigned int shard = (key - 1) % shard_count;
+	  Stringpool::Key k = (key - 1) / shard_count + 1;
+	  section_offset_type* poffset = &offsets[shard][k - 1];
+	  if (*poffset != -1)
+	    continue;
+	  *poffset = align_address(offset, this->addralign());
+	  offset = (*poffset + merged_strings[j + 1].offset
+		    - merged_strings[j].offset);
+	}
+    }
+
+  for (unsigned int i = 0; i < shard_count; ++i)
+    this->stringpools_[i]->set_string_offsets(offsets[i], offset);
+
+  this->merged_size_ = offset;
+  return offset;
 }
 
 template<typename Char_type>
@@ -598,7 +884,11 @@ template<typename Char_type>
 void
 Output_merge_string<Char_type>::do_write(Output_file* of)
 {
-  this->stringpool_.write(of, this->offset());
+  const off_t offset = this->offset();
+  const section_size_type size = this->data_size();
+  unsigned char* view = of->get_output_view(offset, size);
+  this->stringpool_to_buffer(view, size);
+  of->write_output_view(offset, size, view);
 }
 
 // Write a merged string section to a buffer.
@@ -607,7 +897,33 @@ template<typename Char_type>
 void
 Output_merge_string<Char_type>::do_write_to_buffer(unsigned char* buffer)
 {
-  this->stringpool_.write_to_buffer(buffer, this->data_size());
+  this->stringpool_to_buffer(buffer, this->data_size());
+}
+
+// Write the Stringpools to a buffer.  When there are several shards,
+// each one writes its strings at their offsets in the whole section.
+
+template<typename Char_type>
+void
+Output_merge_string<Char_type>::stringpool_to_buffer(
+    unsigned char* buffer,
+    section_size_type buffer_size)
+{
+  if (this->stringpools_.size() > 1)
+    memset(buffer, 0, buffer_size);
+  for (unsigned int i = 0; i < this->stringpools_.size(); ++i)
+    if (!this->stringpools_[i]->empty())
+      this->stringpools_[i]->write_to_buffer(buffer, buffer_size);
+}
+
+// Clear the Stringpools.
+
+template<typename Char_type>
+void
+Output_merge_string<Char_type>::clear_stringpool()
+{
+  for (unsigned int i = 0; i < this->stringpools_.size(); ++i)
+    this->stringpools_[i]->clear();
 }
 
 // Return the name of the types of string to use with
@@ -654,7 +970,16 @@ Output_merge_string<Char_type>::do_print_merge_stats(const char* section_name)
 	  program_name, buf, this->input_size_);
   fprintf(stderr, _("%s: %s input strings: %zu\n"),
 	  program_name, buf, this->input_count_);
-  this->stringpool_.print_stats(buf);
+  if (this->stringpools_.size() == 1)
+    this->stringpools_[0]->print_stats(buf);
+  else
+    {
+      size_t count = 0;
+      for (unsigned int i = 0; i < this->stringpools_.size(); ++i)
+	count += this->stringpools_[i]->size();
+      fprintf(stderr, _("%s: %s entries: %zu; shards: %zu\n"),
+	      program_name, buf, count, this->stringpools_.size());
+    }
 }
 
 // Instantiate the templates we need.
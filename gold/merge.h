@@ -33,6 +33,8 @@
 namespace gold
 {
 
+class Workqueue;
+
 // For each object with merge sections, we store an Object_merge_map.
 // This is used to map locations in input sections to a merged output
 // section.  The output section itself is not recorded here--it can be
@@ -72,6 +74,12 @@ class Object_merge_map
   const Output_section_data*
   find_merge_section(unsigned int shndx) const;
 
+  // Sort the mappings of all the input sections.  After this
+  // get_output_offset does not change the map, so it may be called
+  // from several threads at once.
+  void
+  sort_mappings();
+
   // Initialize an mapping from input offsets to output addresses for
   // section SHNDX.  STARTING_ADDRESS is the output address of the
   // merged section.
@@ -201,6 +209,13 @@ class Output_merge_base : public Output_section_data
   set_keeps_input_sections()
   { this->do_set_keeps_input_sections(); }
 
+  // Merge any strings which have been seen but not yet merged.
+  // WORKQUEUE, if not NULL, may be used to merge them on several
+  // threads.
+  void
+  merge_strings(Workqueue* workqueue)
+  { this->do_merge_strings(workqueue); }
+
   // Return the object of the first merged input section.  This used
   // for script processing.  This is NULL if merge section is empty.
   Relobj*
@@ -253,6 +268,11 @@ class Output_merge_base : public Output_section_data
   do_set_keeps_input_sections()
   { this->keeps_input_sections_ = true; }
 
+  // This may be overridden by the child class.
+  virtual void
+  do_merge_strings(Workqueue*)
+  { }
+
   // Record the merged input section for script processing.
   void
   record_input_section(Relobj* relobj, unsigned int shndx);
@@ -396,16 +416,20 @@ class Output_merge_data : public Output_merge_base
 // Handle SHF_MERGE sections with string data.  This is a template
 // based on the type of the characters in the string.
 
+// When using threads, the strings are split into shards by hash
+// code, and each shard has its own Stringpool.  The input sections
+// are copied as they are seen, and merge_strings adds the strings to
+// the shards on several threads.  The strings of all the shards are
+// then laid out in the order in which they were first seen, so the
+// output is the same as without threads.
+
 template<typename Char_type>
 class Output_merge_string : public Output_merge_base
 {
  public:
-  Output_merge_string(uint64_t addralign)
-    : Output_merge_base(sizeof(Char_type), addralign), stringpool_(addralign),
-      merged_strings_lists_(), input_count_(0), input_size_(0)
-  {
-    this->stringpool_.set_no_zero_null();
-  }
+  Output_merge_string(uint64_t addralign);
+
+  ~Output_merge_string();
 
  protected:
   // Add an input section.
@@ -438,15 +462,17 @@ class Output_merge_string : public Output_merge_base
   void
   do_print_merge_stats(const char* section_name);
 
-  // Writes the stringpool to a buffer.
+  // Merge the strings which have not been merged yet.
+  void
+  do_merge_strings(Workqueue*);
+
+  // Writes the stringpools to a buffer.
   void
-  stringpool_to_buffer(unsigned char* buffer, section_size_type buffer_size)
-  { this->stringpool_.write_to_buffer(buffer, buffer_size); }
+  stringpool_to_buffer(unsigned char* buffer, section_size_type buffer_size);
 
-  // Clears all the data in the stringpool, to save on memory.
+  // Clears all the data in the stringpools, to save on memory.
   void
-  clear_stringpool()
-  { this->stringpool_.clear(); }
+  clear_stringpool();
 
   // Whether this is a merge string section.
   virtual bool
@@ -466,6 +492,54 @@ class Output_merge_string : public Output_merge_base
   const char*
   string_name();
 
+  // A Parallel_work used by do_merge_strings.
+  class Merge_strings_work;
+
+  // Return the shard for the string S of length LEN.
+  unsigned int
+  shard(const Char_type* s, size_t len) const
+  {
+    if (this->stringpools_.size() == 1)
+      return 0;
+    size_t h = string_hash<Char_type>(s, len);
+    return (h ^ (h >> 16)) % this->stringpools_.size();
+  }
+
+  // Return the key we use for the string with key KEY in the
+  // Stringpool for SHARD.  This is never zero.
+  Stringpool::Key
+  make_key(unsigned int shard, Stringpool::Key key) const
+  { return (key - 1) * this->stringpools_.size() + shard + 1; }
+
+  // Return the offset in the output section of the string with key
+  // KEY, as returned by make_key.
+  section_offset_type
+  key_offset(Stringpool::Key key) const
+  {
+    unsigned int shard = (key - 1) % this->stringpools_.size();
+    Stringpool::Key k = (key - 1) / this->stringpools_.size() + 1;
+    return this->stringpools_[shard]->get_offset_from_key(k);
+  }
+
+  // Set the offsets of the strings when there are several shards.
+  section_offset_type
+  set_shard_string_offsets();
+
+  // Sort the strings of the unmerged input section I by shard.
+  void
+  find_shards(unsigned int i);
+
+  // Add the strings of the unmerged input sections which belong in
+  // SHARD to its Stringpool.
+  void
+  add_shard_strings(unsigned int shard);
+
+  // Run FUNCTION for items 0 through COUNT - 1, using WORKQUEUE if
+  // it is not NULL.
+  void
+  run_merge_work(Workqueue* workqueue, unsigned int count,
+		 void (Output_merge_string::*function)(unsigned int));
+
   // As we see input sections, we build a mapping from object, section
   // index and offset to strings.
   struct Merged_string
@@ -490,23 +564,44 @@ class Output_merge_string : public Output_merge_base
     unsigned int shndx;
     // The list of merged strings.
     Merged_strings merged_strings;
+    // If the strings have not been merged yet, a copy of the section
+    // contents, allocated with new[].  Otherwise NULL.
+    const unsigned char* contents;
+    // The indexes in merged_strings of the strings, sorted by shard.
+    std::vector<unsigned int> shard_order;
+    // The index in shard_order of the first string in each shard, and
+    // of the end.
+    std::vector<unsigned int> shard_starts;
 
     Merged_strings_list(Relobj* objecta, unsigned int shndxa)
-      : object(objecta), shndx(shndxa), merged_strings()
+      : object(objecta), shndx(shndxa), merged_strings(), contents(NULL),
+	shard_order(), shard_starts()
     { }
+
+    ~Merged_strings_list()
+    { delete[] this->contents; }
   };
 
   typedef std::vector<Merged_strings_list*> Merged_strings_lists;
 
-  // As we see the strings, we add them to a Stringpool.
-  Stringpool_template<Char_type> stringpool_;
+  // The Stringpools for the shards.
+  std::vector<Stringpool_template<Char_type>*> stringpools_;
   // Map from a location in an input object to an entry in the
   // Stringpool.
   Merged_strings_lists merged_strings_lists_;
+  // Whether the strings are added to the Stringpools by
+  // merge_strings, rather than as the input sections are seen.
+  bool merge_later_;
+  // The index in merged_strings_lists_ of the first input section
+  // whose strings have not been added to the Stringpools.
+  unsigned int unmerged_list_;
   // The number of entries seen in input files.
   size_t input_count_;
   // The total size of input sections.
   size_t input_size_;
+  // The size of the section, once the strings of several shards have
+  // been laid out.
+  section_offset_type merged_size_;
 };
 
 } // End namespace gold.
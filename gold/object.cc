@@ -42,6 +42,7 @@
 #include "compressed_output.h"
 #include "incremental.h"
 #include "merge.h"
+#include "ehframe.h"
 
 namespace gold
 {
@@ -171,7 +172,10 @@ Object::error(const char* format, ...) const
   if (vasprintf(&buf, format, args) < 0)
     gold_nomem();
   va_end(args);
-  gold_error(_("%s: %s"), this->name().c_str(), buf);
+  if (this->error_messages_ != NULL)
+    this->error_messages_->push_back(this->name() + ": " + buf);
+  else
+    gold_error(_("%s: %s"), this->name().c_str(), buf);
   free(buf);
 }
 
@@ -306,6 +310,13 @@ Relobj::find_merge_section(unsigned int shndx) const {
   return object_merge_map->find_merge_section(shndx);
 }
 
+void
+Relobj::sort_merge_mappings()
+{
+  if (this->object_merge_map_ != NULL)
+    this->object_merge_map_->sort_mappings();
+}
+
 // To copy the symbols data read from the file to a local data structure.
 // This function is called from do_layout only while doing garbage
 // collection.
@@ -477,10 +488,12 @@ Sized_relobj_file<size, big_endian>::Sized_relobj_file(
     kept_comdat_sections_(),
     has_eh_frame_(false),
     discarded_eh_frame_shndx_(-1U),
+    parsed_eh_frame_(NULL),
     is_deferred_layout_(false),
     deferred_layout_(),
     deferred_layout_relocs_(),
-    output_views_(NULL)
+    output_views_(NULL),
+    relocate_workqueue_(NULL)
 {
   this->e_type_ = ehdr.get_e_type();
 }
@@ -488,6 +501,7 @@ Sized_relobj_file<size, big_endian>::Sized_relobj_file(
 template<int size, bool big_endian>
 Sized_relobj_file<size, big_endian>::~Sized_relobj_file()
 {
+  delete this->parsed_eh_frame_;
 }
 
 // Set up an object file based on the file header.  This sets up the
@@ -920,6 +934,101 @@ Sized_relobj_file<size, big_endian>::base_read_symbols(Read_symbols_data* sd)
     convert_to_section_size_type(strtabshdr.get_sh_size());
 }
 
+// When using threads, parse the .eh_frame section after reading the
+// symbols, while other objects are being read, rather than during
+// layout.  This is not done for archive members which may not be
+// included in the link, as the result would never be used.
+
+template<int size, bool big_endian>
+void
+Sized_relobj_file<size, big_endian>::do_parse_sections(Read_symbols_data* sd)
+{
+  if (this->has_eh_frame_
+      && this->parsed_eh_frame_ == NULL
+      && sd->symbols != NULL
+      && parameters->options().threads()
+      && !parameters->options().relocatable()
+      && !parameters->incremental())
+    this->parse_eh_frame_section(sd);
+}
+
+// Parse the .eh_frame section of the object, so that layout only has
+// to merge it with the .eh_frame sections of other objects.  This is
+// called from the task which read the symbols, and must only look at
+// this object.
+
+template<int size, bool big_endian>
+void
+Sized_relobj_file<size, big_endian>::parse_eh_frame_section(
+    Read_symbols_data* sd)
+{
+  const unsigned int shnum = this->shnum();
+  const unsigned char* const pshdrs = sd->section_headers->data();
+  const char* names =
+    reinterpret_cast<const char*>(sd->section_names->data());
+
+  // Find the section, as find_eh_frame does.
+  const unsigned char* s = NULL;
+  while (1)
+    {
+      s = this->template find_shdr<size, big_endian>(pshdrs, ".eh_frame",
+						     names,
+						     sd->section_names_size,
+						     s);
+      if (s == NULL)
+	return;
+
+      typename This::Shdr shdr(s);
+      if (this->check_eh_frame_flags(&shdr))
+	break;
+    }
+  unsigned int shndx = (s - pshdrs) / This::shdr_size;
+
+  // Find the reloc section, as do_layout does.  Use -1U if there is
+  // more than one.
+  unsigned int reloc_shndx = 0;
+  unsigned int reloc_type = elfcpp::SHT_NULL;
+  const unsigned char* p = pshdrs + This::shdr_size;
+  for (unsigned int i = 1; i < shnum; ++i, p += This::shdr_size)
+    {
+      typename This::Shdr shdr(p);
+      unsigned int sh_type = shdr.get_sh_type();
+      if ((sh_type == elfcpp::SHT_REL || sh_type == elfcpp::SHT_RELA)
+	  && this->adjust_shndx(shdr.get_sh_info()) == shndx)
+	{
+	  if (reloc_shndx != 0)
+	    reloc_shndx = -1U;
+	  else
+	    {
+	      reloc_shndx = i;
+	      reloc_type = sh_type;
+	    }
+	}
+    }
+
+  Parsed_eh_frame_section* parsed = new Parsed_eh_frame_section(shndx);
+  Eh_frame::parse_ehframe_input_section(this, sd->symbols->data(),
+					sd->symbols_size,
+					sd->symbol_names->data(),
+					sd->symbol_names_size,
+					reloc_shndx, reloc_type, parsed);
+  this->parsed_eh_frame_ = parsed;
+}
+
+// Return the parsed .eh_frame section SHNDX, if any.
+
+template<int size, bool big_endian>
+Parsed_eh_frame_section*
+Sized_relobj_file<size, big_endian>::release_parsed_eh_frame(
+    unsigned int shndx)
+{
+  Parsed_eh_frame_section* parsed = this->parsed_eh_frame_;
+  if (parsed == NULL || parsed->shndx() != shndx)
+    return NULL;
+  this->parsed_eh_frame_ = NULL;
+  return parsed;
+}
+
 // Return the section index of symbol SYM.  Set *VALUE to its value in
 // the object file.  Set *IS_ORDINARY if this is an ordinary section
 // index, not a special code between SHN_LORESERVE and SHN_HIRESERVE.
@@ -1301,6 +1410,10 @@ Sized_relobj_file<size, big_endian>::layout_eh_frame_section(
 					       reloc_shndx,
 					       reloc_type,
 					       &offset);
+
+  // If the section was parsed but not used, we don't need it.
+  delete this->release_parsed_eh_frame(shndx);
+
   this->output_sections()[shndx] = os;
   if (os == NULL || offset == -1)
     {
@@ -1876,7 +1989,7 @@ Sized_relobj_file<size, big_endian>::do_layout(Symbol_table* symtab,
        ++p)
     {
       unsigned int i = *p;
-      layout->add_to_gdb_index(false, this, symbols_data, symbols_size,
+      layout->add_to_gdb_index(false, this, symbols_data != NULL,
 			       i, reloc_shndx[i], reloc_type[i]);
     }
   for (std::vector<unsigned int>::const_iterator p
@@ -1885,7 +1998,7 @@ Sized_relobj_file<size, big_endian>::do_layout(Symbol_table* symtab,
        ++p)
     {
       unsigned int i = *p;
-      layout->add_to_gdb_index(true, this, symbols_data, symbols_size,
+      layout->add_to_gdb_index(true, this, symbols_data != NULL,
 			       i, reloc_shndx[i], reloc_type[i]);
     }
 
@@ -2146,6 +2259,7 @@ Sized_relobj_file<size, big_endian>::set_local_plt_offset(
   std::pair<typename Local_plt_offsets::iterator, bool> ins =
     this->local_plt_offsets_.insert(std::make_pair(symndx, plt_offset));
   gold_assert(ins.second);
+  this->set_local_values_used_late();
 }
 
 // First pass over the local symbols.  Here we add their names to
@@ -3100,6 +3214,53 @@ Input_objects::print_cref(const Symbol_table* symtab, FILE* f) const
     this->cref_->print_cref(symtab, f);
 }
 
+// Print statistics about the memory used for the symbols of the
+// input objects.
+
+void
+Input_objects::print_stats() const
+{
+  if (!parameters->target_valid())
+    return;
+
+  size_t value_size;
+  if (parameters->target().get_size() == 32)
+    value_size = sizeof(Symbol_value<32>);
+  else
+    value_size = sizeof(Symbol_value<64>);
+
+  size_t local_count = 0;
+  size_t freed_count = 0;
+  size_t global_count = 0;
+  for (Relobj_list::const_iterator p = this->relobj_list_.begin();
+       p != this->relobj_list_.end();
+       ++p)
+    {
+      unsigned int count = (*p)->local_symbol_count();
+      local_count += count;
+      if ((*p)->local_values_freed())
+	freed_count += count;
+      const Object::Symbols* syms = (*p)->get_global_symbols();
+      if (syms != NULL)
+	global_count += syms->size();
+    }
+  for (Dynobj_list::const_iterator p = this->dynobj_list_.begin();
+       p != this->dynobj_list_.end();
+       ++p)
+    {
+      const Object::Symbols* syms = (*p)->get_global_symbols();
+      if (syms != NULL)
+	global_count += syms->size();
+    }
+
+  fprintf(stderr, _("%s: local symbol entries: %zu; bytes: %zu\n"),
+	  program_name, local_count, local_count * value_size);
+  fprintf(stderr, _("%s: local symbol bytes freed after relocation: %zu\n"),
+	  program_name, freed_count * value_size);
+  fprintf(stderr, _("%s: object global symbol pointers: %zu; bytes: %zu\n"),
+	  program_name, global_count, global_count * sizeof(Symbol*));
+}
+
 // Relocate_info methods.
 
 // Return a string describing the location of a relocation when file
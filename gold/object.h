@@ -49,6 +49,11 @@ class Dynobj;
 class Object_merge_map;
 class Relocatable_relocs;
 struct Symbols_data;
+class Workqueue;
+class Parsed_eh_frame_section;
+
+template<int size, bool big_endian>
+class Relocate_sections_work;
 
 template<typename Stringpool_char>
 class Stringpool_template;
@@ -401,7 +406,7 @@ class Object
       is_dynamic_(is_dynamic), is_needed_(false), uses_split_stack_(false),
       has_no_split_stack_(false), no_export_(false),
       is_in_system_directory_(false), as_needed_(false), xindex_(NULL),
-      compressed_sections_(NULL)
+      compressed_sections_(NULL), error_messages_(NULL)
   {
     if (input_file != NULL)
       {
@@ -644,6 +649,13 @@ class Object
   read_symbols(Read_symbols_data* sd)
   { return this->do_read_symbols(sd); }
 
+  // Parse sections which can be parsed before layout, using the data
+  // read by read_symbols.  This is only called for an object which
+  // will be added to the link, on the thread which read it.
+  void
+  parse_sections(Read_symbols_data* sd)
+  { this->do_parse_sections(sd); }
+
   // Pass sections which should be included in the link to the Layout
   // object, and record where the sections go in the output file.
   void
@@ -704,6 +716,14 @@ class Object
   void
   error(const char* format, ...) const ATTRIBUTE_PRINTF_2;
 
+  // Save the messages reported by error in MESSAGES rather than
+  // printing them, until this is called again with NULL.  This is
+  // used when several objects are read at once, so that their errors
+  // can be printed in a fixed order.
+  void
+  set_error_messages(std::vector<std::string>* messages)
+  { this->error_messages_ = messages; }
+
   // A location in the file.
   struct Location
   {
@@ -880,6 +900,12 @@ class Object
   virtual void
   do_read_symbols(Read_symbols_data*) = 0;
 
+  // Parse sections before layout--implemented by child class if
+  // needed.
+  virtual void
+  do_parse_sections(Read_symbols_data*)
+  { }
+
   // Lay out sections--implemented by child class.
   virtual void
   do_layout(Symbol_table*, Layout*, Read_symbols_data*) = 0;
@@ -1084,6 +1110,8 @@ class Object
   // For compressed debug sections, map section index to uncompressed size
   // and contents.
   Compressed_section_map* compressed_sections_;
+  // If not NULL, error saves messages here rather than printing them.
+  std::vector<std::string>* error_messages_;
 };
 
 // A regular object (ET_REL).  This is an abstract base class itself.
@@ -1098,6 +1126,8 @@ class Relobj : public Object
       map_to_relocatable_relocs_(NULL),
       object_merge_map_(NULL),
       relocs_must_follow_section_writes_(false),
+      local_values_used_late_(false),
+      local_values_freed_(false),
       sd_(NULL),
       reloc_counts_(NULL),
       reloc_bases_(NULL),
@@ -1201,14 +1231,20 @@ class Relobj : public Object
   void
   set_local_got_offset(unsigned int symndx, unsigned int got_type,
 		       unsigned int got_offset)
-  { this->do_set_local_got_offset(symndx, got_type, got_offset, 0); }
+  {
+    this->local_values_used_late_ = true;
+    this->do_set_local_got_offset(symndx, got_type, got_offset, 0);
+  }
 
   // Set the GOT offset with type GOT_TYPE of the local symbol SYMNDX
   // plus ADDEND to GOT_OFFSET.
   void
   set_local_got_offset(unsigned int symndx, unsigned int got_type,
 		       unsigned int got_offset, uint64_t addend)
-  { this->do_set_local_got_offset(symndx, got_type, got_offset, addend); }
+  {
+    this->local_values_used_late_ = true;
+    this->do_set_local_got_offset(symndx, got_type, got_offset, addend);
+  }
 
   // Return whether the local symbol SYMNDX is a TLS symbol.
   bool
@@ -1275,9 +1311,11 @@ class Relobj : public Object
   { return this->dyn_reloc_count_; }
 
   // Relocate the input sections and write out the local symbols.
+  // WORKQUEUE may be used to relocate sections on other threads.
   void
-  relocate(const Symbol_table* symtab, const Layout* layout, Output_file* of)
-  { return this->do_relocate(symtab, layout, of); }
+  relocate(const Symbol_table* symtab, const Layout* layout, Output_file* of,
+	   Workqueue* workqueue)
+  { return this->do_relocate(symtab, layout, of, workqueue); }
 
   // Return whether an input section is being included in the link.
   bool
@@ -1310,6 +1348,26 @@ class Relobj : public Object
   relocs_must_follow_section_writes() const
   { return this->relocs_must_follow_section_writes_; }
 
+  // Return true if the values of the local symbols are needed after
+  // this object has been relocated, for a GOT or PLT entry or a
+  // dynamic relocation.  If this is false, --reduce-memory-overheads
+  // may free them as soon as the object has been relocated.
+  bool
+  local_values_used_late() const
+  { return this->local_values_used_late_; }
+
+  // Record that the values of the local symbols are needed after
+  // this object has been relocated.
+  void
+  set_local_values_used_late()
+  { this->local_values_used_late_ = true; }
+
+  // Return true if the values of the local symbols have been freed.
+  // This is only used for --stats.
+  bool
+  local_values_freed() const
+  { return this->local_values_freed_; }
+
   Object_merge_map*
   get_or_create_merge_map();
 
@@ -1333,6 +1391,12 @@ class Relobj : public Object
   const Output_section_data*
   find_merge_section(unsigned int shndx) const;
 
+  // Sort the merge mappings, so that merge_output_offset does not
+  // change them.  This is needed before looking up merge offsets
+  // from several threads.
+  void
+  sort_merge_mappings();
+
   // Record the relocatable reloc info for an input reloc section.
   void
   set_relocatable_relocs(unsigned int reloc_shndx, Relocatable_relocs* rr)
@@ -1455,7 +1519,8 @@ class Relobj : public Object
   // Relocate the input sections and write out the local
   // symbols--implemented by child class.
   virtual void
-  do_relocate(const Symbol_table* symtab, const Layout*, Output_file* of) = 0;
+  do_relocate(const Symbol_table* symtab, const Layout*, Output_file* of,
+	      Workqueue*) = 0;
 
   // Set the offset of a section--implemented by child class.
   virtual void
@@ -1499,6 +1564,11 @@ class Relobj : public Object
   set_relocs_must_follow_section_writes()
   { this->relocs_must_follow_section_writes_ = true; }
 
+  // Record that the values of the local symbols have been freed.
+  void
+  set_local_values_freed()
+  { this->local_values_freed_ = true; }
+
   // Allocate the array for counting incremental relocations.
   void
   allocate_incremental_reloc_counts()
@@ -1561,6 +1631,10 @@ class Relobj : public Object
   // Whether we need to wait for output sections to be written before
   // we can apply relocations.
   bool relocs_must_follow_section_writes_;
+  // Whether the local symbol values are needed after relocation.
+  bool local_values_used_late_;
+  // Whether the local symbol values have been freed.
+  bool local_values_freed_;
   // Used to store the relocs data computed by the Read_relocs pass. 
   // Used during garbage collection of unused sections.
   Read_relocs_data* rd_;
@@ -2326,6 +2400,12 @@ class Sized_relobj_file : public Sized_relobj<size, big_endian>
   bool is_deferred_layout() const
   { return this->is_deferred_layout_; }
 
+  // If the .eh_frame section SHNDX was parsed when the symbols were
+  // read, return the result and pass ownership of it to the caller.
+  // Otherwise return NULL.
+  Parsed_eh_frame_section*
+  release_parsed_eh_frame(unsigned int shndx);
+
  protected:
   typedef typename Sized_relobj<size, big_endian>::Output_sections
       Output_sections;
@@ -2338,6 +2418,10 @@ class Sized_relobj_file : public Sized_relobj<size, big_endian>
   void
   do_read_symbols(Read_symbols_data*);
 
+  // Parse the .eh_frame section, if using threads.
+  void
+  do_parse_sections(Read_symbols_data*);
+
   // Read the symbols.  This is common code for all target-specific
   // overrides of do_read_symbols.
   void
@@ -2430,7 +2514,8 @@ class Sized_relobj_file : public Sized_relobj<size, big_endian>
 
   // Relocate the input sections and write out the local symbols.
   void
-  do_relocate(const Symbol_table* symtab, const Layout*, Output_file* of);
+  do_relocate(const Symbol_table* symtab, const Layout*, Output_file* of,
+	      Workqueue*);
 
   // Get the size of a section.
   uint64_t
@@ -2562,12 +2647,25 @@ class Sized_relobj_file : public Sized_relobj<size, big_endian>
 		       const unsigned char* pshdrs, Output_file* of,
 		       Views* pviews);
 
-  // Relocate section data for a range of sections.
+  // Relocate section data for a range of sections.  If WORK is not
+  // NULL, add the sections to WORK rather than relocating them.
   void
   relocate_section_range(const Symbol_table* symtab, const Layout* layout,
 			 const unsigned char* pshdrs, Output_file* of,
 			 Views* pviews, unsigned int start_shndx,
-			 unsigned int end_shndx);
+			 unsigned int end_shndx,
+			 Relocate_sections_work<size, big_endian>* work = NULL);
+
+  // Return whether the sections may be relocated on several threads.
+  bool
+  can_relocate_sections_in_parallel() const;
+
+  // Relocate the sections, using several threads for large objects.
+  void
+  relocate_sections_in_parallel(const Symbol_table* symtab,
+				const Layout* layout,
+				const unsigned char* pshdrs, Output_file* of,
+				Views* pviews);
 
   // Adjust this local symbol value.  Return false if the symbol
   // should be discarded from the output file.
@@ -2621,6 +2719,10 @@ class Sized_relobj_file : public Sized_relobj<size, big_endian>
   find_eh_frame(const unsigned char* pshdrs, const char* names,
 		section_size_type names_size) const;
 
+  // Parse the .eh_frame section using the symbols in SD.
+  void
+  parse_eh_frame_section(Read_symbols_data* sd);
+
   // Whether to include a section group in the link.
   bool
   include_section_group(Symbol_table*, Layout*, unsigned int, const char*,
@@ -2665,6 +2767,11 @@ class Sized_relobj_file : public Sized_relobj<size, big_endian>
   void
   reverse_words(unsigned char*, section_size_type);
 
+  // Ask the system to read ahead the sections we will read when
+  // relocating, for --prefetch-inputs.
+  void
+  prefetch_sections();
+
   // Scan the input relocations for --emit-relocs.
   void
   emit_relocs_scan(Symbol_table*, Layout*, const unsigned char* plocal_syms,
@@ -2845,6 +2952,9 @@ class Sized_relobj_file : public Sized_relobj<size, big_endian>
   // If this object has a GNU style .eh_frame section that is discarded in
   // output, record the index here.  Otherwise it is -1U.
   unsigned int discarded_eh_frame_shndx_;
+  // The .eh_frame section, if it was parsed when the symbols were
+  // read and has not yet been laid out.
+  Parsed_eh_frame_section* parsed_eh_frame_;
   // True if the layout of this object was deferred, waiting for plugin
   // replacement files.
   bool is_deferred_layout_;
@@ -2854,6 +2964,9 @@ class Sized_relobj_file : public Sized_relobj<size, big_endian>
   std::vector<Deferred_layout> deferred_layout_relocs_;
   // Pointer to the list of output views; valid only during do_relocate().
   const Views* output_views_;
+  // The workqueue to use for relocating sections on other threads;
+  // valid only during do_relocate().
+  Workqueue* relocate_workqueue_;
 };
 
 // A class to manage the list of all objects.
@@ -2904,6 +3017,11 @@ class Input_objects
   void
   print_cref(const Symbol_table*, FILE*) const;
 
+  // Print statistics about the symbols of the input objects to
+  // stderr.  This is used for --stats.
+  void
+  print_stats() const;
+
   // Iterate over all regular objects.
 
   Relobj_iterator
@@ -772,6 +772,7 @@ Output_reloc<elfcpp::SHT_REL, dynamic, size, big_endian>::Output_reloc(
   // this->type_ is a bitfield; make sure TYPE fits.
   gold_assert(this->type_ == type);
   this->u1_.relobj = relobj;
+  relobj->set_local_values_used_late();
   this->u2_.od = od;
   if (dynamic)
     this->set_needs_dynsym_index();
@@ -799,6 +800,7 @@ Output_reloc<elfcpp::SHT_REL, dynamic, size, big_endian>::Output_reloc(
   // this->type_ is a bitfield; make sure TYPE fits.
   gold_assert(this->type_ == type);
   this->u1_.relobj = relobj;
+  relobj->set_local_values_used_late();
   this->u2_.relobj = relobj;
   if (dynamic)
     this->set_needs_dynsym_index();
@@ -4055,6 +4057,18 @@ Output_section::print_merge_stats()
     p->print_merge_stats(this->name_);
 }
 
+// Merge the strings of the merged string sections.
+
+void
+Output_section::merge_strings(Workqueue* workqueue)
+{
+  for (Input_section_list::iterator p = this->input_sections_.begin();
+       p != this->input_sections_.end();
+       ++p)
+    if (p->is_merge_section())
+      p->output_merge_base()->merge_strings(workqueue);
+}
+
 // Set a fixed layout for the section.  Used for incremental update links.
 
 void
@@ -4501,11 +4515,13 @@ Output_segment::set_section_list_addresses(Layout* layout, bool reset,
 {
   off_t startoff = *poff;
   // For incremental updates, we may allocate non-fixed sections from
-  // free space in the file.  This keeps track of the high-water mark.
+  // free space in the file.  This keeps track of the high-water mark,
+  // in memory and in the file.
   off_t maxoff = startoff;
 
   off_t off = startoff;
   off_t foff = *pfoff;
+  off_t maxfoff = foff;
   for (Output_data_list::iterator p = pdl->begin();
        p != pdl->end();
        ++p)
@@ -4656,6 +4672,8 @@ Output_segment::set_section_list_addresses(Layout* layout, bool reset,
 
       if (off > maxoff)
 	maxoff = off;
+      if (foff > maxfoff)
+	maxfoff = foff;
 
       if ((*p)->is_section())
 	{
@@ -4665,7 +4683,9 @@ Output_segment::set_section_list_addresses(Layout* layout, bool reset,
     }
 
   *poff = maxoff;
-  *pfoff = foff;
+  // A section allocated from free space may lie beyond the fixed
+  // sections which follow it in the list.
+  *pfoff = parameters->incremental_update() ? maxfoff : foff;
   return addr + (maxoff - startoff);
 }
 
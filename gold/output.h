@@ -42,6 +42,7 @@ class Output_merge_base;
 class Output_section;
 class Relocatable_relocs;
 class Target;
+class Workqueue;
 template<int size, bool big_endian>
 class Sized_target;
 template<int size, bool big_endian>
@@ -4090,6 +4091,11 @@ class Output_section : public Output_data
   void
   print_merge_stats();
 
+  // Merge the strings of the merged string sections, using WORKQUEUE
+  // to merge them on several threads.
+  void
+  merge_strings(Workqueue* workqueue);
+
   // Set a fixed layout for the section.  Used for incremental update links.
   void
   set_fixed_layout(uint64_t sh_addr, off_t sh_offset, off_t sh_size,
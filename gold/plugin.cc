@@ -644,7 +644,8 @@ Plugin_manager::rescan(Task* task)
 	{
 	  Task_lock_obj<Archive> tl(task, r.u.archive);
 	  r.u.archive->add_symbols(this->symtab_, this->layout_,
-				   this->input_objects_, this->mapfile_);
+				   this->input_objects_, this->mapfile_,
+				   NULL);
 	}
       else
 	{
@@ -661,7 +662,8 @@ Plugin_manager::rescan(Task* task)
 		  Task_lock_obj<Archive> tl(task, *p);
 
 		  (*p)->add_symbols(this->symtab_, this->layout_,
-				    this->input_objects_, this->mapfile_);
+				    this->input_objects_, this->mapfile_,
+				    NULL);
 		}
 
 	      next_saw_undefined = this->symtab_->saw_undefined();
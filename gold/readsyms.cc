@@ -400,6 +400,11 @@ Read_symbols::do_read_symbols(Workqueue* workqueue)
       Read_symbols_data* sd = new Read_symbols_data;
       elf_obj->read_symbols(sd);
 
+      // A member of a --start-lib group may not be included in the
+      // link, so leave any parsing to layout.
+      if (this->member_ == NULL)
+	elf_obj->parse_sections(sd);
+
       // Opening the file locked it, so now we need to unlock it.  We
       // need to unlock it before queuing the Add_symbols task,
       // because the workqueue doesn't know about our lock on the
@@ -839,7 +844,7 @@ Finish_group::locks(Task_locker* tl)
 // Loop over the archives until there are no new undefined symbols.
 
 void
-Finish_group::run(Workqueue*)
+Finish_group::run(Workqueue* workqueue)
 {
   size_t saw_undefined = this->saw_undefined_;
   while (saw_undefined != this->symtab_->saw_undefined())
@@ -853,7 +858,7 @@ Finish_group::run(Workqueue*)
 	  Task_lock_obj<Archive> tl(this, *p);
 
 	  (*p)->add_symbols(this->symtab_, this->layout_,
-			    this->input_objects_, this->mapfile_);
+			    this->input_objects_, this->mapfile_, workqueue);
 	}
     }
 
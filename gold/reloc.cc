@@ -234,9 +234,10 @@ Relocate_task::locks(Task_locker* tl)
 // Run the task.
 
 void
-Relocate_task::run(Workqueue*)
+Relocate_task::run(Workqueue* workqueue)
 {
-  this->object_->relocate(this->symtab_, this->layout_, this->of_);
+  this->object_->relocate(this->symtab_, this->layout_, this->of_,
+			  workqueue);
 
   // This is normally the last thing we will do with an object, so
   // uncache all views.
@@ -253,6 +254,97 @@ Relocate_task::get_name() const
   return "Relocate_task " + this->object_->name();
 }
 
+// The sections of one Sized_relobj_file to relocate on several
+// threads.  Each item is one call to relocate_section.
+
+template<int size, bool big_endian>
+class Relocate_sections_work : public Parallel_work
+{
+ public:
+  typedef typename elfcpp::Elf_types<size>::Elf_Addr Address;
+
+  // The arguments for one call to relocate_section.
+  struct Section
+  {
+    Relocate_info<size, big_endian> relinfo;
+    unsigned int sh_type;
+    const unsigned char* prelocs;
+    size_t reloc_count;
+    Output_section* output_section;
+    bool needs_special_offset_handling;
+    unsigned char* view;
+    Address address;
+    section_size_type view_size;
+    const Reloc_symbol_changes* reloc_map;
+  };
+
+  Relocate_sections_work(const std::string& name)
+    : Parallel_work(name), read_lock_(), sections_(), reloc_count_(0)
+  { }
+
+  // A lock for reading the object file while several threads are
+  // running.
+  Lock*
+  read_lock()
+  { return &this->read_lock_; }
+
+  // Add a section.
+  void
+  add_section(const Section& section)
+  {
+    this->sections_.push_back(section);
+    this->reloc_count_ += section.reloc_count;
+  }
+
+  // The number of sections.
+  unsigned int
+  section_count() const
+  { return this->sections_.size(); }
+
+  // The total number of relocations.
+  size_t
+  reloc_count() const
+  { return this->reloc_count_; }
+
+  // Put the sections with the most relocations first, so that the
+  // threads finish at about the same time.
+  void
+  sort_sections()
+  {
+    std::stable_sort(this->sections_.begin(), this->sections_.end(),
+		     Section_compare());
+  }
+
+ protected:
+  void
+  do_item(unsigned int i)
+  {
+    const Section& sec(this->sections_[i]);
+    Sized_target<size, big_endian>* target =
+      parameters->sized_target<size, big_endian>();
+    target->relocate_section(&sec.relinfo, sec.sh_type, sec.prelocs,
+			     sec.reloc_count, sec.output_section,
+			     sec.needs_special_offset_handling, sec.view,
+			     sec.address, sec.view_size, sec.reloc_map);
+  }
+
+ private:
+  // Sort by decreasing number of relocations.
+  struct Section_compare
+  {
+    bool
+    operator()(const Section& s1, const Section& s2) const
+    { return s1.reloc_count > s2.reloc_count; }
+  };
+
+  // Lock passed to File_read::set_read_lock.
+  Lock read_lock_;
+  // The sections to relocate.
+  std::vector<Section> sections_;
+  // The total number of relocations.
+  size_t reloc_count_;
+};
+
 // Read the relocs and local symbols from the object file and store
 // the information in RD.
 
@@ -499,6 +591,55 @@ Sized_relobj_file<size, big_endian>::do_scan_relocs(Symbol_table* symtab,
       delete rd->local_symbols;
       rd->local_symbols = NULL;
     }
+
+  if (parameters->options().prefetch_inputs())
+    this->prefetch_sections();
+}
+
+// Ask the system to read ahead the contents and relocations of the
+// sections which we will read when we relocate this object.  We do
+// this after scanning the relocations, when garbage collection and
+// identical code folding have decided which sections are kept, so
+// that the reads can proceed while the other objects are scanned.
+
+template<int size, bool big_endian>
+void
+Sized_relobj_file<size, big_endian>::prefetch_sections()
+{
+  const unsigned int shnum = this->shnum();
+  const Output_sections& out_sections(this->output_sections());
+  const unsigned char* pshdrs = this->get_view(this->elf_file_.shoff(),
+					       shnum * This::shdr_size,
+					       true, true);
+
+  File_read::Prefetch_list pl;
+  const unsigned char* ps = pshdrs + This::shdr_size;
+  for (unsigned int i = 1; i < shnum; ++i, ps += This::shdr_size)
+    {
+      typename This::Shdr shdr(ps);
+      unsigned int sh_type = shdr.get_sh_type();
+      if (sh_type == elfcpp::SHT_NOBITS)
+	continue;
+
+      if (sh_type == elfcpp::SHT_REL || sh_type == elfcpp::SHT_RELA)
+	{
+	  unsigned int shndx = this->adjust_shndx(shdr.get_sh_info());
+	  if (shndx >= shnum || out_sections[shndx] == NULL)
+	    continue;
+	}
+      else if (out_sections[i] == NULL
+	       || this->is_output_section_offset_invalid(i))
+	{
+	  // Sections which need special handling, like merged
+	  // sections, were already read when they were laid out.
+	  continue;
+	}
+
+      pl.push_back(File_read::Prefetch_entry(shdr.get_sh_offset(),
+					     shdr.get_sh_size()));
+    }
+
+  this->input_file()->file().prefetch(this->offset(), pl);
 }
 
 // Scan the input relocations for --emit-relocs.
@@ -586,7 +727,8 @@ template<int size, bool big_endian>
 void
 Sized_relobj_file<size, big_endian>::do_relocate(const Symbol_table* symtab,
 						 const Layout* layout,
-						 Output_file* of)
+						 Output_file* of,
+						 Workqueue* workqueue)
 {
   unsigned int shnum = this->shnum();
 
@@ -628,7 +770,9 @@ Sized_relobj_file<size, big_endian>::do_relocate(const Symbol_table* symtab,
 
   // Apply relocations.
 
+  this->relocate_workqueue_ = workqueue;
   this->relocate_sections(symtab, layout, pshdrs, of, &views);
+  this->relocate_workqueue_ = NULL;
 
   // After we've done the relocations, we release the hash tables,
   // since we no longer need them.
@@ -658,6 +802,18 @@ Sized_relobj_file<size, big_endian>::do_relocate(const Symbol_table* symtab,
   this->write_local_symbols(of, layout->sympool(), layout->dynpool(),
 			    layout->symtab_xindex(), layout->dynsym_xindex(),
 			    layout->symtab_section_offset());
+
+  // With --reduce-memory-overheads, free the local symbol values if
+  // nothing will look at them again.
+  if (parameters->options().reduce_memory_overheads()
+      && !parameters->options().relocatable()
+      && !parameters->incremental()
+      && parameters->target().can_free_local_values()
+      && !this->local_values_used_late())
+    {
+      Local_values().swap(this->local_values_);
+      this->set_local_values_freed();
+    }
 }
 
 // Sort a Read_multiple vector by file offset.
@@ -871,12 +1027,80 @@ Sized_relobj_file<size, big_endian>::do_relocate_sections(
     Output_file* of,
     Views* pviews)
 {
+  if (this->can_relocate_sections_in_parallel())
+    this->relocate_sections_in_parallel(symtab, layout, pshdrs, of, pviews);
+  else
+    this->relocate_section_range(symtab, layout, pshdrs, of, pviews,
+				 1, this->shnum() - 1);
+}
+
+// Return whether the relocation sections of this object may be
+// applied by several threads.  We only do this for a final link
+// without --emit-relocs or incremental relocs, since those write to
+// shared output sections.  The target must also agree.
+
+template<int size, bool big_endian>
+bool
+Sized_relobj_file<size, big_endian>::can_relocate_sections_in_parallel() const
+{
+  return (this->relocate_workqueue_ != NULL
+	  && parameters->options().threads()
+	  && !parameters->options().relocatable()
+	  && !parameters->options().emit_relocs()
+	  && !parameters->incremental()
+	  && parameters->target().can_relocate_sections_in_parallel());
+}
+
+// The number of relocations an object must have before we use more
+// than one thread to apply them.
+static const size_t parallel_relocate_minimum_relocs = 20000;
+
+// Relocate the sections of this object, queuing tasks to help if
+// there are a lot of relocations.  The sections and relocations are
+// read here, and then the target relocate_section calls are shared
+// between this thread and the helper tasks.  While the helpers run
+// the object file is read under a lock, as relocate_section may need
+// to read it to report an error.
+
+template<int size, bool big_endian>
+void
+Sized_relobj_file<size, big_endian>::relocate_sections_in_parallel(
+    const Symbol_table* symtab,
+    const Layout* layout,
+    const unsigned char* pshdrs,
+    Output_file* of,
+    Views* pviews)
+{
+  Relocate_sections_work<size, big_endian>* work =
+    new Relocate_sections_work<size, big_endian>(this->name());
+
   this->relocate_section_range(symtab, layout, pshdrs, of, pviews,
-			       1, this->shnum() - 1);
+			       1, this->shnum() - 1, work);
+
+  unsigned int helpers = 0;
+  if (work->reloc_count() >= parallel_relocate_minimum_relocs)
+    helpers = this->relocate_workqueue_->thread_count() - 1;
+
+  if (helpers == 0)
+    work->run(NULL, work->section_count(), 0);
+  else
+    {
+      work->sort_sections();
+      this->sort_merge_mappings();
+      File_read& file(this->input_file()->file());
+      file.set_read_lock(work->read_lock());
+
+      work->run(this->relocate_workqueue_, work->section_count(), helpers);
+
+      file.set_read_lock(NULL);
+    }
+
+  work->release();
 }
 
 // Relocate section data for the range of sections START_SHNDX through
-// END_SHNDX.
+// END_SHNDX.  If WORK is not NULL, add the sections to WORK instead
+// of calling relocate_section.
 
 template<int size, bool big_endian>
 void
@@ -887,7 +1111,8 @@ Sized_relobj_file<size, big_endian>::relocate_section_range(
     Output_file* of,
     Views* pviews,
     unsigned int start_shndx,
-    unsigned int end_shndx)
+    unsigned int end_shndx,
+    Relocate_sections_work<size, big_endian>* work)
 {
   gold_assert(start_shndx >= 1);
   gold_assert(end_shndx < this->shnum());
@@ -1000,7 +1225,22 @@ Sized_relobj_file<size, big_endian>::relocate_section_range(
 	rr = this->relocatable_relocs(i);
       relinfo.rr = rr;
 
-      if (!parameters->options().relocatable())
+      if (work != NULL)
+	{
+	  typename Relocate_sections_work<size, big_endian>::Section sec;
+	  sec.relinfo = relinfo;
+	  sec.sh_type = sh_type;
+	  sec.prelocs = prelocs;
+	  sec.reloc_count = reloc_count;
+	  sec.output_section = os;
+	  sec.needs_special_offset_handling = output_offset == invalid_address;
+	  sec.view = view;
+	  sec.address = address;
+	  sec.view_size = view_size;
+	  sec.reloc_map = reloc_map;
+	  work->add_section(sec);
+	}
+      else if (!parameters->options().relocatable())
 	{
 	  target->relocate_section(&relinfo, sh_type, prelocs, reloc_count, os,
 				   output_offset == invalid_address,
@@ -1703,7 +1943,8 @@ template
 void
 Sized_relobj_file<32, false>::do_relocate(const Symbol_table* symtab,
 					  const Layout* layout,
-					  Output_file* of);
+					  Output_file* of,
+					  Workqueue* workqueue);
 #endif
 
 #ifdef HAVE_TARGET_32_BIG
@@ -1711,7 +1952,8 @@ template
 void
 Sized_relobj_file<32, true>::do_relocate(const Symbol_table* symtab,
 					 const Layout* layout,
-					 Output_file* of);
+					 Output_file* of,
+					 Workqueue* workqueue);
 #endif
 
 #ifdef HAVE_TARGET_64_LITTLE
@@ -1719,7 +1961,8 @@ template
 void
 Sized_relobj_file<64, false>::do_relocate(const Symbol_table* symtab,
 					  const Layout* layout,
-					  Output_file* of);
+					  Output_file* of,
+					  Workqueue* workqueue);
 #endif
 
 #ifdef HAVE_TARGET_64_BIG
@@ -1727,7 +1970,8 @@ template
 void
 Sized_relobj_file<64, true>::do_relocate(const Symbol_table* symtab,
 					 const Layout* layout,
-					 Output_file* of);
+					 Output_file* of,
+					 Workqueue* workqueue);
 #endif
 
 #ifdef HAVE_TARGET_32_LITTLE
@@ -1749,7 +1993,8 @@ Sized_relobj_file<32, false>::relocate_section_range(
     Output_file* of,
     Views* pviews,
     unsigned int start_shndx,
-    unsigned int end_shndx);
+    unsigned int end_shndx,
+    Relocate_sections_work<32, false>* work);
 
 template
 unsigned char*
@@ -1777,7 +2022,8 @@ Sized_relobj_file<32, true>::relocate_section_range(
     Output_file* of,
     Views* pviews,
     unsigned int start_shndx,
-    unsigned int end_shndx);
+    unsigned int end_shndx,
+    Relocate_sections_work<32, true>* work);
 
 template
 unsigned char*
@@ -1805,7 +2051,8 @@ Sized_relobj_file<64, false>::relocate_section_range(
     Output_file* of,
     Views* pviews,
     unsigned int start_shndx,
-    unsigned int end_shndx);
+    unsigned int end_shndx,
+    Relocate_sections_work<64, false>* work);
 
 template
 unsigned char*
@@ -1833,7 +2080,8 @@ Sized_relobj_file<64, true>::relocate_section_range(
     Output_file* of,
     Views* pviews,
     unsigned int start_shndx,
-    unsigned int end_shndx);
+    unsigned int end_shndx,
+    Relocate_sections_work<64, true>* work);
 
 template
 unsigned char*
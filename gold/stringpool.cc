@@ -519,6 +519,15 @@ Stringpool_template<Stringpool_char>::print_stats(const char* name) const
 #endif
   fprintf(stderr, _("%s: %s Stringdata structures: %zu\n"),
 	  program_name, name, this->strings_.size());
+
+  size_t bytes = 0;
+  for (typename Stringdata_list::const_iterator p = this->strings_.begin();
+       p != this->strings_.end();
+       ++p)
+    bytes += sizeof(Stringdata) + (*p)->alc;
+  fprintf(stderr, _("%s: %s string bytes: %zu; key bytes: %zu\n"),
+	  program_name, name, bytes,
+	  this->key_to_offset_.size() * sizeof(section_offset_type));
 }
 
 // Instantiate the templates we need.
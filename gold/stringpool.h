@@ -235,12 +235,35 @@ class Stringpool_template
   const Stringpool_char*
   find(const Stringpool_char* s, Key* pkey) const;
 
+  // Return the number of strings in the pool.
+  size_t
+  size() const
+  { return this->string_set_.size(); }
+
+  // Return whether the pool is empty.
+  bool
+  empty() const
+  { return this->string_set_.empty(); }
+
   // Turn the stringpool into a string table: determine the offsets of
   // all the strings.  After this is called, no more strings may be
   // added to the stringpool.
   void
   set_string_offsets();
 
+  // Set the offsets of the strings to OFFSETS, indexed by key minus
+  // one, and the size of the string table to STRTAB_SIZE.  This is
+  // used when the strings of several pools are laid out together.
+  void
+  set_string_offsets(const std::vector<section_offset_type>& offsets,
+		     section_size_type strtab_size)
+  {
+    gold_assert(offsets.size() == this->key_to_offset_.size());
+    for (size_t i = 0; i < offsets.size(); ++i)
+      this->key_to_offset_[i] = offsets[i];
+    this->strtab_size_ = strtab_size;
+  }
+
   // Get the offset of the string S in the string table.  This returns
   // the offset in bytes, not in units of Stringpool_char.  This may
   // only be called after set_string_offsets has been called.
@@ -3410,6 +3410,16 @@ Symbol_table::print_stats() const
   fprintf(stderr, _("%s: symbol table entries: %zu\n"),
 	  program_name, this->table_.size());
 #endif
+  if (parameters->target_valid())
+    {
+      size_t symsize;
+      if (parameters->target().get_size() == 32)
+	symsize = sizeof(Sized_symbol<32>);
+      else
+	symsize = sizeof(Sized_symbol<64>);
+      fprintf(stderr, _("%s: symbol table symbol bytes: %zu\n"),
+	      program_name, this->table_.size() * symsize);
+    }
   this->namepool_.print_stats("symbol table stringpool");
 }
 
@@ -310,6 +310,19 @@ class Target
   can_check_for_function_pointers() const
   { return this->do_can_check_for_function_pointers(); }
 
+  // Return whether the relocation sections of a single object may be
+  // applied by several threads at once.
+  bool
+  can_relocate_sections_in_parallel() const
+  { return this->do_can_relocate_sections_in_parallel(); }
+
+  // Return whether the local symbol values of an object may be freed
+  // once the object has been relocated, provided the object has not
+  // recorded that they are needed later.
+  bool
+  can_free_local_values() const
+  { return this->do_can_free_local_values(); }
+
   // Return whether a relocation to a merged section can be processed
   // to retrieve the contents.
   bool
@@ -650,6 +663,21 @@ class Target
   do_can_check_for_function_pointers() const
   { return false; }
 
+  // Virtual function which may be overriden by the child class.  This
+  // should only return true if relocate_section only writes to the
+  // view it is given.
+  virtual bool
+  do_can_relocate_sections_in_parallel() const
+  { return false; }
+
+  // Virtual function which may be overridden by the child class.  This
+  // should only return true if the target never looks at the local
+  // symbols of an object after relocating it, other than through GOT
+  // and PLT entries and dynamic relocations.
+  virtual bool
+  do_can_free_local_values() const
+  { return false; }
+
   // Virtual function which may be overridden by the child class.  We
   // recognize some default sections for which we don't care whether
   // they have function pointers.
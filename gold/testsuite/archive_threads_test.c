@@ -0,0 +1,45 @@
+/* archive_threads_test.c -- a member of the archive_threads_test archive.
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   This file is compiled several times with a different value of
+   MEMBER, to make the members of an archive which is linked with
+   --whole-archive.  Each member defines a function and some data,
+   and refers to the next member.  */
+
+#define CAT2(a, b) a ## b
+#define CAT(a, b) CAT2 (a, b)
+
+#define FN CAT (archive_threads_member_, MEMBER)
+#define NEXT CAT (archive_threads_member_, NEXT_MEMBER)
+#define DATA CAT (archive_threads_data_, MEMBER)
+
+extern const char *FN (int);
+extern const char *NEXT (int);
+
+const char *DATA[] = { "member", "data", __FILE__ };
+
+const char *
+FN (int i)
+{
+  if (i <= 0)
+    return DATA[0];
+  return NEXT (i - 1);
+}
@@ -0,0 +1,43 @@
+#!/bin/sh
+
+# archive_threads_test.sh -- test --whole-archive with --threads.
+
+# Copyright (C) 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# With --threads, gold reads the members of an archive linked with
+# --whole-archive on several threads.  The members must still be
+# added to the link in archive order, so the output and the map file
+# must be the same as for a link without --threads.
+
+check_same()
+{
+    if ! cmp -s "$1" "$2"
+    then
+	echo "$1 and $2 differ"
+	exit 1
+    fi
+}
+
+check_same archive_threads_test archive_threads_test_serial
+check_same archive_threads_test.map archive_threads_test_serial.map
+
+./archive_threads_test || exit 1
+
+exit 0
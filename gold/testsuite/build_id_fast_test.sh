@@ -0,0 +1,63 @@
+#!/bin/sh
+
+# build_id_fast_test.sh -- test --build-id=fast.
+
+# Copyright (C) 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# --build-id=fast hashes each chunk of the output in a separate task,
+# then hashes the chunk hashes.  The build ID must be 16 bytes, and the
+# output must be the same whether or not the chunks are hashed on
+# several threads.
+
+check_same()
+{
+    if ! cmp -s "$1" "$2"
+    then
+	echo "$1 and $2 differ"
+	exit 1
+    fi
+}
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check_same build_id_fast_test build_id_fast_test_serial
+
+check build_id_fast_test.stdout "GNU  *0x00000010	NT_GNU_BUILD_ID"
+check build_id_fast_test.stdout "Build ID: [0-9a-f]\{32\}$"
+
+if grep -q "Build ID: 0\{32\}$" build_id_fast_test.stdout; then
+    echo "Build ID was not computed"
+    exit 1
+fi
+
+./build_id_fast_test || exit 1
+
+exit 0
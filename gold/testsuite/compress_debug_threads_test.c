@@ -0,0 +1,45 @@
+/* compress_debug_threads_test.c -- test compressing large debug sections.
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.  */
+
+/* The 192 structs below have 1024 members each.  Compiled with -g,
+   their debug information makes a .debug_info section of over 2 MiB,
+   which gold compresses as several 1 MiB chunks.  */
+
+#define M1(n) int member_with_a_long_name_##n;
+#define M4(n) M1(n##0) M1(n##1) M1(n##2) M1(n##3)
+#define M16(n) M4(n##0) M4(n##1) M4(n##2) M4(n##3)
+#define M64(n) M16(n##0) M16(n##1) M16(n##2) M16(n##3)
+#define M256(n) M64(n##0) M64(n##1) M64(n##2) M64(n##3)
+#define M1024(n) M256(n##0) M256(n##1) M256(n##2) M256(n##3)
+
+#define STRUCT(n) struct s##n { M1024(1) } v##n;
+#define S4(n) STRUCT(n##0) STRUCT(n##1) STRUCT(n##2) STRUCT(n##3)
+#define S16(n) S4(n##0) S4(n##1) S4(n##2) S4(n##3)
+#define S64(n) S16(n##0) S16(n##1) S16(n##2) S16(n##3)
+
+S64(1) S64(2) S64(3)
+
+int
+main (void)
+{
+  return (v1000.member_with_a_long_name_100000
+	  + v3333.member_with_a_long_name_133333);
+}
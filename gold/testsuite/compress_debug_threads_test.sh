@@ -0,0 +1,62 @@
+#!/bin/sh
+
+# compress_debug_threads_test.sh -- test compressing large debug
+# sections with --threads.
+
+# Copyright (C) 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# The .debug_info section of compress_debug_threads_test is over
+# 2 MiB, so gold compresses it as several 1 MiB chunks, which are
+# joined with sync flushes and a combined Adler-32 checksum.  The
+# chunks do not depend on the threads, so the output must be the same
+# as for a link without --threads.  readelf must decompress the
+# section to the contents of an uncompressed link.
+
+check_same()
+{
+    if ! cmp -s "$1" "$2"
+    then
+	echo "$1 and $2 differ"
+	exit 1
+    fi
+}
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check compress_debug_threads_test.sections "\.debug_info .* C "
+
+check_same compress_debug_threads_test compress_debug_threads_test_serial
+check_same compress_debug_threads_test.stdout \
+    compress_debug_threads_test_none.stdout
+
+./compress_debug_threads_test || exit 1
+
+exit 0
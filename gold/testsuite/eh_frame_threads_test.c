@@ -0,0 +1,40 @@
+/* eh_frame_threads_test.c -- test sorting .eh_frame_hdr with --threads.
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.  */
+
+/* This defines 32768 functions, each with an FDE, which is enough for
+   gold to sort the .eh_frame_hdr table in more than one piece.  The
+   functions are defined in the reverse order of their names.  With
+   -ffunction-sections and --sort-section=name the FDEs are then in
+   the reverse order of their addresses, so the pieces must really be
+   sorted and merged.  */
+
+#define F(n)						\
+  int eh_frame_sort_##n (int);					\
+  int eh_frame_sort_##n (int x) { return x + n; }
+#define F4(n) F(n##3) F(n##2) F(n##1) F(n##0)
+#define F16(n) F4(n##3) F4(n##2) F4(n##1) F4(n##0)
+#define F64(n) F16(n##3) F16(n##2) F16(n##1) F16(n##0)
+#define F256(n) F64(n##3) F64(n##2) F64(n##1) F64(n##0)
+#define F1024(n) F256(n##3) F256(n##2) F256(n##1) F256(n##0)
+#define F4096(n) F1024(n##3) F1024(n##2) F1024(n##1) F1024(n##0)
+
+F4096(8) F4096(7) F4096(6) F4096(5)
+F4096(4) F4096(3) F4096(2) F4096(1)
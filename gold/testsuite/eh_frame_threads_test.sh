@@ -0,0 +1,47 @@
+#!/bin/sh
+
+# eh_frame_threads_test.sh -- test .eh_frame handling with --threads.
+
+# Copyright (C) 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# With --threads, gold parses .eh_frame sections while reading the
+# input files, and sorts .eh_frame_hdr on several threads.  The
+# output must be the same as for a link without --threads.  The
+# threaded link also uses --preread-archive-symbols, so that an
+# archive member which is read but not included has an .eh_frame
+# section.  eh_frame_threads_test_4.o has enough FDEs for the
+# .eh_frame_hdr table to be sorted in pieces, which must show up in
+# the --debug=task output.
+
+if ! grep -q "Parallel_work_task sort eh_frame_hdr" eh_frame_threads_test.task
+then
+    echo "eh_frame_threads_test did not sort .eh_frame_hdr on several threads"
+    exit 1
+fi
+
+if ! cmp -s eh_frame_threads_test eh_frame_threads_test_serial
+then
+    echo "eh_frame_threads_test and eh_frame_threads_test_serial differ"
+    exit 1
+fi
+
+./eh_frame_threads_test || exit 1
+
+exit 0
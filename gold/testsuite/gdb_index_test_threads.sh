@@ -0,0 +1,62 @@
+#!/bin/sh
+
+# gdb_index_test_threads.sh -- test --gdb-index with --threads.
+
+# Copyright (C) 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# With --threads, gold scans the debug info of each object for
+# --gdb-index on several threads, and adds the results to the index
+# in input order.  The output must be the same as for a link without
+# --threads, and the index must cover every object.
+
+check_same()
+{
+    if ! cmp -s "$1" "$2"
+    then
+	echo "$1 and $2 differ"
+	exit 1
+    fi
+}
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check_same gdb_index_test_threads gdb_index_test_threads_serial
+
+STDOUT=gdb_index_test_threads.stdout
+
+check $STDOUT "^\[  3\] 0x"
+check $STDOUT "^\[ *[0-9]*\] t1: 0 "
+check $STDOUT "^\[ *[0-9]*\] t16a: 1 "
+check $STDOUT "^\[ *[0-9]*\] t1_2: 2 "
+check $STDOUT "^\[ *[0-9]*\] one::c1: T[0-9]* "
+check $STDOUT "^\[ *[0-9]*\] two::c2v1: 3 "
+
+exit 0
@@ -0,0 +1,64 @@
+// icf_threads_test.cc -- test --icf with --threads.
+
+// Copyright (C) 2026 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+// Each group of functions below has two identical leaf functions,
+// two callers which only differ in the leaf they call, and two
+// callers of those.  The callers can only be folded once ICF has
+// found that the functions they call are the same.  Each group uses
+// a different constant, so the groups are not folded with each
+// other.  There are enough groups for the ICF work to be split
+// between several threads.
+
+#define GROUP(n)						\
+  int leaf_kept_##n(int x) { return x * 3 + n; }		\
+  int leaf_folded_##n(int x) { return x * 3 + n; }		\
+  int call_kept_##n(int x) { return leaf_kept_##n(x) + 1; }	\
+  int call_folded_##n(int x) { return leaf_folded_##n(x) + 1; }	\
+  int outer_kept_##n(int x) { return call_kept_##n(x) * 2; }	\
+  int outer_folded_##n(int x) { return call_folded_##n(x) * 2; }
+
+#define GROUP8(n)						\
+  GROUP(n##0) GROUP(n##1) GROUP(n##2) GROUP(n##3)		\
+  GROUP(n##4) GROUP(n##5) GROUP(n##6) GROUP(n##7)
+
+GROUP8(1) GROUP8(2) GROUP8(3) GROUP8(4)
+GROUP8(5) GROUP8(6) GROUP8(7) GROUP8(8)
+GROUP8(9) GROUP8(10) GROUP8(11) GROUP8(12)
+GROUP8(13) GROUP8(14) GROUP8(15) GROUP8(16)
+
+#define CHECK(n)						\
+  if (outer_kept_##n(1) != outer_folded_##n(1)			\
+      || outer_kept_##n(1) != (3 + n + 1) * 2)			\
+    return 1;
+
+#define CHECK8(n)						\
+  CHECK(n##0) CHECK(n##1) CHECK(n##2) CHECK(n##3)		\
+  CHECK(n##4) CHECK(n##5) CHECK(n##6) CHECK(n##7)
+
+int
+main()
+{
+  CHECK8(1) CHECK8(2) CHECK8(3) CHECK8(4)
+  CHECK8(5) CHECK8(6) CHECK8(7) CHECK8(8)
+  CHECK8(9) CHECK8(10) CHECK8(11) CHECK8(12)
+  CHECK8(13) CHECK8(14) CHECK8(15) CHECK8(16)
+  return 0;
+}
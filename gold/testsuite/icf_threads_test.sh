@@ -0,0 +1,59 @@
+#!/bin/sh
+
+# icf_threads_test.sh -- test --icf with --threads.
+
+# Copyright (C) 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# With --threads, gold computes and hashes the contents of the ICF
+# candidate sections on several threads.  The groups are still formed
+# in section order, so the same sections must be folded, over the same
+# number of iterations, as in a link without --threads.
+
+check_same()
+{
+    if ! cmp -s "$1" "$2"
+    then
+	echo "$1 and $2 differ"
+	exit 1
+    fi
+}
+
+check_folded()
+{
+    if ! sed -n '/^Discarded input sections/,/^Memory map/p' "$1" \
+	 | grep -q "\.text\..*$2"
+    then
+	echo "Identical Code Folding did not fold $2"
+	exit 1
+    fi
+}
+
+check_same icf_threads_test icf_threads_test_serial
+check_same icf_threads_test.map icf_threads_test_serial.map
+
+for n in 10 47 167; do
+    check_folded icf_threads_test.map "leaf_folded_$n"
+    check_folded icf_threads_test.map "call_folded_$n"
+    check_folded icf_threads_test.map "outer_folded_$n"
+done
+
+./icf_threads_test || exit 1
+
+exit 0
@@ -0,0 +1,46 @@
+#!/bin/sh
+
+# incremental_restart_test.sh -- test restarting an incremental link.
+
+# Copyright (C) 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# The last link in incremental_restart_test.err runs out of PLT patch
+# space.  With --incremental, gold must explain why it cannot update
+# the output, and then link again with --incremental-full.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check incremental_restart_test.err "the link might take longer: cannot perform incremental link: out of patch space (PLT)"
+check incremental_restart_test.err "linking with --incremental-full"
+
+./incremental_restart_test || exit 1
+
+exit 0
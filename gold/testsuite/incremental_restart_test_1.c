@@ -0,0 +1,44 @@
+/* incremental_restart_test_1.c -- test restarting an incremental link.
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.  */
+
+/* The second version calls a function in the C library, which needs
+   a new PLT entry.  The incremental update runs out of patch space
+   for it, and must fall back to a full link.  */
+
+#ifdef VERSION2
+
+#include <stdlib.h>
+
+int
+incremental_restart_1 (void)
+{
+  return atoi ("1");
+}
+
+#else
+
+int
+incremental_restart_1 (void)
+{
+  return 1;
+}
+
+#endif
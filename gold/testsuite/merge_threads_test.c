@@ -0,0 +1,59 @@
+/* merge_threads_test.c -- test merged strings with --threads.
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   This file is compiled several times with a different value of
+   PART.  Each part has strings of its own, strings which are the
+   same in every part, and strings which are suffixes of other
+   strings, so that strings are merged across input sections.  */
+
+#define STR2(x) #x
+#define STR(x) STR2 (x)
+
+#define CAT2(a, b) a ## b
+#define CAT(a, b) CAT2 (a, b)
+
+#define FN CAT (merge_threads_part_, PART)
+
+#define STRINGS(n) \
+  "merge_threads_test " #n, \
+  "threads_test " #n, \
+  "part " STR (PART) " string " #n, \
+  "string " #n
+
+static const char *const strings[] =
+{
+  STRINGS (0), STRINGS (1), STRINGS (2), STRINGS (3),
+  STRINGS (4), STRINGS (5), STRINGS (6), STRINGS (7),
+  STRINGS (8), STRINGS (9), STRINGS (10), STRINGS (11),
+  STRINGS (12), STRINGS (13), STRINGS (14), STRINGS (15),
+  "part " STR (PART),
+  "",
+};
+
+extern const char *FN (unsigned int);
+
+const char *
+FN (unsigned int i)
+{
+  if (i >= sizeof strings / sizeof strings[0])
+    return 0;
+  return strings[i];
+}
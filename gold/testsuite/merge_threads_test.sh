@@ -0,0 +1,45 @@
+#!/bin/sh
+
+# merge_threads_test.sh -- test merged strings with --threads.
+
+# Copyright (C) 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# With --threads, gold adds the strings of merged string sections to
+# their hash shards on several threads.  The shards, and the order of
+# the strings within each shard, do not depend on the threads, so the
+# output must be the same as for a link without --threads.  This
+# covers .rodata.str1.1 and the .debug_str sections, in a final link
+# and in a -r link.
+
+check_same()
+{
+    if ! cmp -s "$1" "$2"
+    then
+	echo "$1 and $2 differ"
+	exit 1
+    fi
+}
+
+check_same merge_threads_test merge_threads_test_serial
+check_same merge_threads_test_r.o merge_threads_test_r_serial.o
+
+./merge_threads_test || exit 1
+
+exit 0
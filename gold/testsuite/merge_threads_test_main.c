@@ -0,0 +1,83 @@
+/* merge_threads_test_main.c -- test merged strings with --threads.
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.  */
+
+#include <stdio.h>
+#include <string.h>
+
+extern const char *merge_threads_part_1 (unsigned int);
+extern const char *merge_threads_part_2 (unsigned int);
+extern const char *merge_threads_part_3 (unsigned int);
+extern const char *merge_threads_part_4 (unsigned int);
+
+static int
+check_part (const char *(*fn) (unsigned int), int part)
+{
+  char buf[100];
+  unsigned int i;
+  int ret = 1;
+
+  for (i = 0; i < 16; ++i)
+    {
+      sprintf (buf, "merge_threads_test %u", i);
+      if (strcmp (fn (i * 4), buf) != 0)
+	ret = 0;
+      sprintf (buf, "threads_test %u", i);
+      if (strcmp (fn (i * 4 + 1), buf) != 0)
+	ret = 0;
+      sprintf (buf, "part %d string %u", part, i);
+      if (strcmp (fn (i * 4 + 2), buf) != 0)
+	ret = 0;
+      sprintf (buf, "string %u", i);
+      if (strcmp (fn (i * 4 + 3), buf) != 0)
+	ret = 0;
+    }
+  sprintf (buf, "part %d", part);
+  if (strcmp (fn (64), buf) != 0)
+    ret = 0;
+  if (strcmp (fn (65), "") != 0)
+    ret = 0;
+  if (fn (66) != NULL)
+    ret = 0;
+
+  if (!ret)
+    fprintf (stderr, "bad strings in part %d\n", part);
+  return ret;
+}
+
+int
+main (void)
+{
+  int ret = 1;
+
+  ret &= check_part (merge_threads_part_1, 1);
+  ret &= check_part (merge_threads_part_2, 2);
+  ret &= check_part (merge_threads_part_3, 3);
+  ret &= check_part (merge_threads_part_4, 4);
+
+  /* Identical strings from different parts must have been merged.  */
+  if (merge_threads_part_1 (0) != merge_threads_part_4 (0))
+    {
+      fprintf (stderr, "identical strings were not merged\n");
+      ret = 0;
+    }
+
+  return ret ? 0 : 1;
+}
@@ -0,0 +1,64 @@
+#!/bin/sh
+
+# prefetch_inputs_test.sh -- test --prefetch-inputs.
+
+# Copyright (C) 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# --prefetch-inputs only asks the kernel to read the sections which
+# will be relocated, so the output must be the same as that of
+# icf_threads_test_serial.  The sections folded by ICF are not
+# prefetched, so every prefetched byte must be read later.  Where
+# posix_fadvise is missing nothing is prefetched.
+
+check_same()
+{
+    if ! cmp -s "$1" "$2"
+    then
+	echo "$1 and $2 differ"
+	exit 1
+    fi
+}
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check_same prefetch_inputs_test icf_threads_test_serial
+
+if grep -q "define HAVE_POSIX_FADVISE 1" ../config.h; then
+    check prefetch_inputs_test.stats "total bytes prefetched: [1-9]"
+    check prefetch_inputs_test.stats "prefetched pieces read: [1-9][0-9]*; bytes: [1-9]"
+    check prefetch_inputs_test.stats "prefetched bytes never read: 0$"
+else
+    check prefetch_inputs_test.stats "total bytes prefetched: 0$"
+fi
+
+./prefetch_inputs_test || exit 1
+
+exit 0
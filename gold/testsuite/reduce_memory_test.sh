@@ -0,0 +1,64 @@
+#!/bin/sh
+
+# reduce_memory_test.sh -- test --reduce-memory-overheads.
+
+# Copyright (C) 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# --reduce-memory-overheads frees the local symbol values of each
+# object once it has been relocated.  The output must be the same as
+# that of icf_threads_test_serial, which is linked without the option
+# and without --threads.  The --stats output must show that some local
+# symbol values were freed, and must report the ICF sections.
+
+check_same()
+{
+    if ! cmp -s "$1" "$2"
+    then
+	echo "$1 and $2 differ"
+	exit 1
+    fi
+}
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check_same reduce_memory_test icf_threads_test_serial
+
+check reduce_memory_test.stats "local symbol entries: [1-9][0-9]*; bytes: [1-9]"
+check reduce_memory_test.stats "local symbol bytes freed after relocation: [1-9]"
+check reduce_memory_test.stats "object global symbol pointers: [1-9]"
+check reduce_memory_test.stats "symbol table symbol bytes: [1-9]"
+check reduce_memory_test.stats "symbol table stringpool string bytes: [1-9][0-9]*; key bytes: [1-9]"
+check reduce_memory_test.stats "ICF candidate sections: [1-9]"
+check reduce_memory_test.stats "ICF folded sections: [1-9][0-9]*; folded bytes: [1-9]"
+
+./reduce_memory_test || exit 1
+
+exit 0
@@ -0,0 +1,79 @@
+/* relocate_threads_test.c -- test relocating an object with --threads.
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.  */
+
+/* Each table below has 4096 entries, and each entry needs a
+   relocation.  With 8 tables, each in its own section when compiled
+   with -fdata-sections, the object has more than the 20000
+   relocations gold needs before it relocates the sections of a single
+   object on several threads.  */
+
+#include <stdio.h>
+
+static int vars[16];
+
+#define R1(x) &vars[(x) & 15]
+#define R2(x) R1(x), R1((x) + 1)
+#define R4(x) R2(x), R2((x) + 2)
+#define R8(x) R4(x), R4((x) + 4)
+#define R16(x) R8(x), R8((x) + 8)
+#define R32(x) R16(x), R16((x) + 16)
+#define R64(x) R32(x), R32((x) + 32)
+#define R128(x) R64(x), R64((x) + 64)
+#define R256(x) R128(x), R128((x) + 128)
+#define R512(x) R256(x), R256((x) + 256)
+#define R1024(x) R512(x), R512((x) + 512)
+#define R2048(x) R1024(x), R1024((x) + 1024)
+#define R4096(x) R2048(x), R2048((x) + 2048)
+
+#define TABLE(n) int *table_##n[4096] = { R4096(n) };
+
+TABLE(0) TABLE(1) TABLE(2) TABLE(3)
+TABLE(4) TABLE(5) TABLE(6) TABLE(7)
+
+static int
+check_table (int *const *table, int n)
+{
+  int i;
+
+  for (i = 0; i < 4096; ++i)
+    if (table[i] != &vars[(n + i) & 15])
+      {
+	fprintf (stderr, "bad entry %d in table %d\n", i, n);
+	return 0;
+      }
+  return 1;
+}
+
+int
+main (void)
+{
+  int ret = 1;
+
+  ret &= check_table (table_0, 0);
+  ret &= check_table (table_1, 1);
+  ret &= check_table (table_2, 2);
+  ret &= check_table (table_3, 3);
+  ret &= check_table (table_4, 4);
+  ret &= check_table (table_5, 5);
+  ret &= check_table (table_6, 6);
+  ret &= check_table (table_7, 7);
+  return ret ? 0 : 1;
+}
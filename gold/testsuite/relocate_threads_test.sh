@@ -0,0 +1,54 @@
+#!/bin/sh
+
+# relocate_threads_test.sh -- test relocating an object with --threads.
+
+# Copyright (C) 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# relocate_threads_test.o has more than 20000 relocations, so with
+# --threads gold applies them with the help of other threads.  The
+# --debug=task output must show the helper tasks, and the output must
+# be the same as for a link without --threads.
+
+check_same()
+{
+    if ! cmp -s "$1" "$2"
+    then
+	echo "$1 and $2 differ"
+	exit 1
+    fi
+}
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	exit 1
+    fi
+}
+
+check relocate_threads_test.task "Parallel_work_task relocate_threads_test.o"
+
+check_same relocate_threads_test relocate_threads_test_serial
+
+./relocate_threads_test || exit 1
+
+exit 0
@@ -0,0 +1,79 @@
+#!/bin/sh
+
+# workqueue_threads_test.sh -- test the workqueue run queues.
+
+# Copyright (C) 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# With --threads --thread-count 3 there are three run queues, and each
+# thread takes tasks from its own queue before stealing from the
+# others.  Which thread runs a task depends on timing, so only check
+# that --stats reports tasks for some of the three queues and for no
+# others.  Without --threads there is a single run queue and nothing
+# is stolen.  The output must not depend on the threads.
+
+check_same()
+{
+    if ! cmp -s "$1" "$2"
+    then
+	echo "$1 and $2 differ"
+	exit 1
+    fi
+}
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check_not()
+{
+    if grep -q "$2" "$1"
+    then
+	echo "Found unexpected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check workqueue_threads_test.stats \
+    "run queue [0-2]: [1-9][0-9]* tasks run, [0-9]* stolen, wall: "
+check_not workqueue_threads_test.stats "run queue [3-9]"
+
+check workqueue_threads_test_serial.stats \
+    "run queue 0: [1-9][0-9]* tasks run, 0 stolen, wall: "
+check_not workqueue_threads_test_serial.stats "run queue [1-9]"
+
+check_same workqueue_threads_test workqueue_threads_test_serial
+check_same workqueue_threads_test merge_threads_test_serial
+
+./workqueue_threads_test || exit 1
+
+exit 0
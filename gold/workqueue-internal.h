@@ -37,6 +37,91 @@ namespace gold
 
 class Workqueue_thread;
 
+// A run queue holding Tasks which are ready to run.  The Workqueue
+// has one run queue per thread, up to a limit; threads beyond the
+// limit share queues.  A thread takes work from its own queue first,
+// and steals work from the other queues when its own queue is empty.
+// This keeps the threads from all scanning the same list.  The lists
+// are protected by the run queue lock, which may be taken while
+// holding the Workqueue lock but not the other way around.  The
+// statistics are protected by the Workqueue lock.
+
+class Workqueue_runqueue
+{
+ public:
+  Workqueue_runqueue()
+    : lock_(), first_tasks_(), tasks_(), tasks_run_(0), tasks_stolen_(0),
+      run_time_(0)
+  { }
+
+  // Add T to the queue.  If SOON is true, add it to the tasks to run
+  // soon.  If FRONT is true, add it to the front.
+  void
+  push(Task* t, bool soon, bool front)
+  {
+    Hold_lock hl(this->lock_);
+    Task_list* list = soon ? &this->first_tasks_ : &this->tasks_;
+    if (front)
+      list->push_front(t);
+    else
+      list->push_back(t);
+  }
+
+  // Remove and return the first Task in the queue, or NULL.  If SOON
+  // is true, only look at the tasks to run soon, otherwise only look
+  // at the other tasks.
+  Task*
+  pop(bool soon)
+  {
+    Hold_lock hl(this->lock_);
+    return soon ? this->first_tasks_.pop_front() : this->tasks_.pop_front();
+  }
+
+  // Record that a thread using this queue ran a Task which took TIME
+  // milliseconds.  STOLEN is true if the Task was found on some other
+  // queue.
+  void
+  add_task_stats(bool stolen, long time)
+  {
+    ++this->tasks_run_;
+    if (stolen)
+      ++this->tasks_stolen_;
+    this->run_time_ += time;
+  }
+
+  // The number of tasks run.
+  unsigned int
+  tasks_run() const
+  { return this->tasks_run_; }
+
+  // The number of tasks taken from other queues.
+  unsigned int
+  tasks_stolen() const
+  { return this->tasks_stolen_; }
+
+  // The total wall clock time spent running tasks, in milliseconds.
+  long
+  run_time() const
+  { return this->run_time_; }
+
+ private:
+  Workqueue_runqueue(const Workqueue_runqueue&);
+  Workqueue_runqueue& operator=(const Workqueue_runqueue&);
+
+  // Lock controlling access to the lists.
+  Lock lock_;
+  // List of tasks to execute soon.
+  Task_list first_tasks_;
+  // List of tasks to execute after the ones in first_tasks_.
+  Task_list tasks_;
+  // Number of tasks run by threads using this queue.
+  unsigned int tasks_run_;
+  // Number of those tasks which were stolen from another queue.
+  unsigned int tasks_stolen_;
+  // Wall clock time spent running those tasks, in milliseconds.
+  long run_time_;
+};
+
 // The Workqueue_threader abstract class.  This is the interface used
 // by the general workqueue code to manage threads.
 
@@ -54,6 +139,10 @@ class Workqueue_threader
   virtual void
   set_thread_count(int) = 0;
 
+  // Return the number of threads we want to have running.
+  virtual int
+  thread_count() = 0;
+
   // Return whether to cancel the current thread.
   virtual bool
   should_cancel_thread(int thread_number) = 0;
@@ -82,6 +171,10 @@ class Workqueue_threader_threadpool : public Workqueue_threader
   void
   set_thread_count(int);
 
+  // Return the thread count.
+  int
+  thread_count();
+
   // Return whether to cancel a thread.
   bool
   should_cancel_thread(int thread_number);
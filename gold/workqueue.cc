@@ -24,6 +24,7 @@
 
 #include "debug.h"
 #include "options.h"
+#include "parameters.h"
 #include "timer.h"
 #include "workqueue.h"
 #include "workqueue-internal.h"
@@ -31,6 +32,91 @@
 namespace gold
 {
 
+// Class Parallel_work.
+
+Parallel_work::Parallel_work(const std::string& name)
+  : lock_(), condvar_(this->lock_), name_(name), count_(0), next_(0),
+    active_(0), refs_(1)
+{
+}
+
+// Do all the items.
+
+void
+Parallel_work::run(Workqueue* workqueue, unsigned int count,
+		   unsigned int helpers)
+{
+  this->count_ = count;
+
+  // There is no point in having more helpers than items that we
+  // won't do ourselves.
+  if (count == 0)
+    helpers = 0;
+  else if (helpers > count - 1)
+    helpers = count - 1;
+  for (unsigned int i = 0; i < helpers; ++i)
+    workqueue->queue_soon(new Parallel_work_task(this));
+
+  this->do_items();
+
+  // Wait for the items started by the helpers.
+  Hold_lock hl(this->lock_);
+  while (this->active_ > 0)
+    this->condvar_.wait();
+}
+
+// Add a reference.
+
+void
+Parallel_work::add_ref()
+{
+  Hold_lock hl(this->lock_);
+  ++this->refs_;
+}
+
+// Drop a reference.
+
+void
+Parallel_work::release()
+{
+  bool last;
+  {
+    Hold_lock hl(this->lock_);
+    --this->refs_;
+    last = this->refs_ == 0;
+  }
+  if (last)
+    delete this;
+}
+
+// Do items until there are none left to start.
+
+void
+Parallel_work::do_items()
+{
+  while (true)
+    {
+      unsigned int i;
+      {
+	Hold_lock hl(this->lock_);
+	if (this->next_ >= this->count_)
+	  return;
+	i = this->next_;
+	++this->next_;
+	++this->active_;
+      }
+
+      this->do_item(i);
+
+      {
+	Hold_lock hl(this->lock_);
+	--this->active_;
+	if (this->active_ == 0 && this->next_ >= this->count_)
+	  this->condvar_.broadcast();
+      }
+    }
+}
+
 // Class Task_list.
 
 // Add T to the end of the list.
@@ -109,6 +195,10 @@ class Workqueue_threader_single : public Workqueue_threader
   set_thread_count(int thread_count)
   { gold_assert(thread_count > 0); }
 
+  int
+  thread_count()
+  { return 1; }
+
   bool
   should_cancel_thread(int)
   { return false; }
@@ -118,8 +208,10 @@ class Workqueue_threader_single : public Workqueue_threader
 
 Workqueue::Workqueue(const General_options& options)
   : lock_(),
-    first_tasks_(),
-    tasks_(),
+    runqueues_(NULL),
+    runqueue_count_(1),
+    next_runqueue_(0),
+    queued_(0),
     running_(0),
     waiting_(0),
     condvar_(this->lock_),
@@ -135,21 +227,49 @@ Workqueue::Workqueue(const General_options& options)
     {
 #ifdef ENABLE_THREADS
       this->threader_ = new Workqueue_threader_threadpool(this);
+
+      // Use one run queue per thread if we know how many threads
+      // there will be.
+      int count = options.thread_count_initial();
+      if (count < static_cast<int>(options.thread_count_middle()))
+	count = options.thread_count_middle();
+      if (count < static_cast<int>(options.thread_count_final()))
+	count = options.thread_count_final();
+      if (count == 0)
+	count = default_runqueue_count;
+      else if (count > max_runqueue_count)
+	count = max_runqueue_count;
+      this->runqueue_count_ = count;
 #else
       gold_unreachable();
 #endif
     }
+  this->runqueues_ = new Workqueue_runqueue[this->runqueue_count_];
 }
 
 Workqueue::~Workqueue()
 {
+  delete[] this->runqueues_;
+}
+
+// Add a runnable task to a run queue and tell any waiting thread
+// that there is work to do.  The workqueue lock must be held when
+// this is called.
+
+void
+Workqueue::push_runnable(Task* t, int runqueue, bool front)
+{
+  this->runqueues_[runqueue].push(t, t->should_run_soon(), front);
+  ++this->queued_;
+  this->condvar_.signal();
 }
 
-// Add a task to the end of a specific queue, or put it on the list
-// waiting for a Token.
+// Add a task to the end of a run queue, or put it on the list waiting
+// for a Token.  We don't know which thread is adding the task, so we
+// spread the tasks over the run queues.
 
 void
-Workqueue::add_to_queue(Task_list* queue, Task* t, bool front)
+Workqueue::add_to_queue(Task* t, bool front)
 {
   Hold_lock hl(this->lock_);
 
@@ -164,12 +284,11 @@ Workqueue::add_to_queue(Task_list* queue, Task* t, bool front)
     }
   else
     {
-      if (front)
-	queue->push_front(t);
-      else
-	queue->push_back(t);
-      // Tell any waiting thread that there is work to do.
-      this->condvar_.signal();
+      int runqueue = this->next_runqueue_;
+      ++this->next_runqueue_;
+      if (this->next_runqueue_ >= this->runqueue_count_)
+	this->next_runqueue_ = 0;
+      this->push_runnable(t, runqueue, front);
     }
 }
 
@@ -178,7 +297,7 @@ Workqueue::add_to_queue(Task_list* queue, Task* t, bool front)
 void
 Workqueue::queue(Task* t)
 {
-  this->add_to_queue(&this->tasks_, t, false);
+  this->add_to_queue(t, false);
 }
 
 // Queue a task which should run soon.
@@ -187,7 +306,7 @@ void
 Workqueue::queue_soon(Task* t)
 {
   t->set_should_run_soon();
-  this->add_to_queue(&this->first_tasks_, t, false);
+  this->add_to_queue(t, false);
 }
 
 // Queue a task which should run next.
@@ -196,7 +315,7 @@ void
 Workqueue::queue_next(Task* t)
 {
   t->set_should_run_soon();
-  this->add_to_queue(&this->first_tasks_, t, true);
+  this->add_to_queue(t, true);
 }
 
 // Return whether to cancel the current thread.
@@ -207,26 +326,51 @@ Workqueue::should_cancel_thread(int thread_number)
   return this->threader_->should_cancel_thread(thread_number);
 }
 
-// Find a runnable task in TASKS.  Return NULL if none could be found.
-// If we find a Task waiting for a Token, add it to the list for that
-// Token.  The workqueue lock must be held when this is called.
+// Remove a task from the run queues.  Tasks which should run soon
+// come first.  We look at the run queue for THREAD_NUMBER first, and
+// then steal from the other run queues.  Set *STOLEN to whether the
+// task came from another queue.  Return NULL if the run queues are
+// empty.  This may be called with or without the workqueue lock.
 
 Task*
-Workqueue::find_runnable_in_list(Task_list* tasks)
+Workqueue::pop_task(int thread_number, bool* stolen)
 {
-  Task* t;
-  while ((t = tasks->pop_front()) != NULL)
+  int self = this->runqueue_for_thread(thread_number);
+  for (int pass = 0; pass < 2; ++pass)
     {
-      Task_token* token = t->is_runnable();
+      bool soon = pass == 0;
+      int q = self;
+      for (int i = 0; i < this->runqueue_count_; ++i)
+	{
+	  Task* t = this->runqueues_[q].pop(soon);
+	  if (t != NULL)
+	    {
+	      *stolen = q != self;
+	      return t;
+	    }
+	  ++q;
+	  if (q >= this->runqueue_count_)
+	    q = 0;
+	}
+    }
+  return NULL;
+}
 
-      if (token == NULL)
-	return t;
+// T has been removed from a run queue.  Return T if it can run now.
+// Otherwise add it to the list for the Token it is waiting for, and
+// return NULL.  The workqueue lock must be held when this is called.
 
-      token->add_waiting(t);
-      ++this->waiting_;
-    }
+Task*
+Workqueue::check_runnable(Task* t)
+{
+  --this->queued_;
 
-  // We couldn't find any runnable task.
+  Task_token* token = t->is_runnable();
+  if (token == NULL)
+    return t;
+
+  token->add_waiting(t);
+  ++this->waiting_;
   return NULL;
 }
 
@@ -234,12 +378,17 @@ Workqueue::find_runnable_in_list(Task_list* tasks)
 // workqueue lock must be held when this is called.
 
 Task*
-Workqueue::find_runnable()
+Workqueue::find_runnable(int thread_number, bool* stolen)
 {
-  Task* t = this->find_runnable_in_list(&this->first_tasks_);
-  if (t == NULL)
-    t = this->find_runnable_in_list(&this->tasks_);
-  return t;
+  Task* t;
+  while ((t = this->pop_task(thread_number, stolen)) != NULL)
+    {
+      if (this->check_runnable(t) != NULL)
+	return t;
+    }
+
+  // We couldn't find any runnable task.
+  return NULL;
 }
 
 // Find a runnable a task, and wait until we find one.  Return NULL if
@@ -247,15 +396,16 @@ Workqueue::find_runnable()
 // called.
 
 Task*
-Workqueue::find_runnable_or_wait(int thread_number)
+Workqueue::find_runnable_or_wait(int thread_number, bool* stolen)
 {
-  Task* t = this->find_runnable();
+  Task* t = this->find_runnable(thread_number, stolen);
 
   while (t == NULL)
     {
-      if (this->running_ == 0
-	  && this->first_tasks_.empty()
-	  && this->tasks_.empty())
+      // If QUEUED_ is not zero here, another thread has taken a task
+      // from a run queue but has not yet looked at it.  That thread
+      // will check again for the end of the work.
+      if (this->running_ == 0 && this->queued_ == 0)
 	{
 	  // Kick all the threads to make them exit.
 	  this->condvar_.broadcast();
@@ -273,7 +423,7 @@ Workqueue::find_runnable_or_wait(int thread_number)
 
       gold_debug(DEBUG_TASK, "%3d awake", thread_number);
 
-      t = this->find_runnable();
+      t = this->find_runnable(thread_number, stolen);
     }
 
   return t;
@@ -290,12 +440,21 @@ Workqueue::find_and_run_task(int thread_number)
 {
   Task* t;
   Task_locker tl;
+  bool stolen = false;
+
+  // Take a task from the run queues before getting the workqueue
+  // lock, so that idle threads looking for work do not hold it.
+  t = this->pop_task(thread_number, &stolen);
 
   {
     Hold_lock hl(this->lock_);
 
+    if (t != NULL)
+      t = this->check_runnable(t);
+
     // Find a runnable task.
-    t = this->find_runnable_or_wait(thread_number);
+    if (t == NULL)
+      t = this->find_runnable_or_wait(thread_number, &stolen);
 
     if (t == NULL)
       return false;
@@ -307,21 +466,27 @@ Workqueue::find_and_run_task(int thread_number)
     ++this->running_;
   }
 
+  bool collect_stats = parameters->options().stats();
+  Workqueue_runqueue* runqueue =
+    &this->runqueues_[this->runqueue_for_thread(thread_number)];
+
   while (t != NULL)
     {
       gold_debug(DEBUG_TASK, "%3d running   task %s", thread_number,
 		 t->name().c_str());
 
       Timer timer;
-      if (is_debugging_enabled(DEBUG_TASK))
+      if (collect_stats || is_debugging_enabled(DEBUG_TASK))
         timer.start();
 
       t->run(this);
 
+      Timer::TimeStats elapsed = { 0, 0, 0 };
+      if (collect_stats || is_debugging_enabled(DEBUG_TASK))
+	elapsed = timer.get_elapsed_time();
+
       if (is_debugging_enabled(DEBUG_TASK))
         {
-          Timer::TimeStats elapsed = timer.get_elapsed_time();
-
           gold_debug(DEBUG_TASK,
                      "%3d completed task %s "
                      "(user: %ld.%06ld sys: %ld.%06ld wall: %ld.%06ld)",
@@ -337,12 +502,16 @@ Workqueue::find_and_run_task(int thread_number)
 
 	--this->running_;
 
+	if (collect_stats)
+	  runqueue->add_task_stats(stolen, elapsed.wall);
+
 	// Release the locks for the task.  This must be done with the
 	// workqueue lock held.  Get the next Task to run if any.
-	next = this->release_locks(t, &tl);
+	next = this->release_locks(t, &tl, thread_number);
 
+	stolen = false;
 	if (next == NULL)
-	  next = this->find_runnable();
+	  next = this->find_runnable(thread_number, &stolen);
 
 	// If we have another Task to run, get the Locks.  This must
 	// be called while we are still holding the Workqueue lock.
@@ -394,7 +563,8 @@ Workqueue::find_and_run_task(int thread_number)
 // Return true if we set *PRET to T, false otherwise.
 
 bool
-Workqueue::return_or_queue(Task* t, bool is_blocker, Task** pret)
+Workqueue::return_or_queue(Task* t, bool is_blocker, Task** pret,
+			   int thread_number)
 {
   Task_token* token = t->is_runnable();
 
@@ -414,7 +584,7 @@ Workqueue::return_or_queue(Task* t, bool is_blocker, Task** pret)
     should_return = true;
   else if (t->should_run_soon())
     should_return = true;
-  else if (!this->first_tasks_.empty() || !this->tasks_.empty())
+  else if (this->queued_ > 0)
     should_queue = true;
   else
     should_return = true;
@@ -427,11 +597,7 @@ Workqueue::return_or_queue(Task* t, bool is_blocker, Task** pret)
     }
   else if (should_queue)
     {
-      if (t->should_run_soon())
-	this->first_tasks_.push_back(t);
-      else
-	this->tasks_.push_back(t);
-      this->condvar_.signal();
+      this->push_runnable(t, this->runqueue_for_thread(thread_number), false);
       return false;
     }
 
@@ -440,11 +606,11 @@ Workqueue::return_or_queue(Task* t, bool is_blocker, Task** pret)
 
 // Release the locks associated with a Task.  Return the first
 // runnable Task that we find.  If we find more runnable tasks, add
-// them to the run queue and signal any other threads.  This must be
-// called with the Workqueue lock held.
+// them to the run queue of THREAD_NUMBER and signal any other
+// threads.  This must be called with the Workqueue lock held.
 
 Task*
-Workqueue::release_locks(Task* t, Task_locker* tl)
+Workqueue::release_locks(Task* t, Task_locker* tl, int thread_number)
 {
   Task* ret = NULL;
   for (Task_locker::iterator p = tl->begin(); p != tl->end(); ++p)
@@ -460,7 +626,7 @@ Workqueue::release_locks(Task* t, Task_locker* tl)
 	      while ((t = token->remove_first_waiting()) != NULL)
 		{
 		  --this->waiting_;
-		  this->return_or_queue(t, true, &ret);
+		  this->return_or_queue(t, true, &ret, thread_number);
 		}
 	    }
 	}
@@ -477,7 +643,7 @@ Workqueue::release_locks(Task* t, Task_locker* tl)
 	  while ((t = token->remove_first_waiting()) != NULL)
 	    {
 	      --this->waiting_;
-	      if (this->return_or_queue(t, false, &ret))
+	      if (this->return_or_queue(t, false, &ret, thread_number))
 		break;
 	    }
 	}
@@ -509,6 +675,15 @@ Workqueue::set_thread_count(int threads)
   this->condvar_.broadcast();
 }
 
+// Return the desired thread count.
+
+int
+Workqueue::thread_count()
+{
+  Hold_lock hl(this->lock_);
+  return this->threader_->thread_count();
+}
+
 // Add a new blocker to an existing Task_token.
 
 void
@@ -518,4 +693,24 @@ Workqueue::add_blocker(Task_token* token)
   token->add_blocker();
 }
 
+// Print statistics about the tasks run from each run queue.
+
+void
+Workqueue::print_stats() const
+{
+  for (int i = 0; i < this->runqueue_count_; ++i)
+    {
+      const Workqueue_runqueue* runqueue = &this->runqueues_[i];
+      if (runqueue->tasks_run() == 0)
+	continue;
+      long wall = runqueue->run_time();
+      fprintf(stderr,
+	      _("%s: run queue %d: %u tasks run, %u stolen, "
+		"wall: %ld.%06ld\n"),
+	      program_name, i, runqueue->tasks_run(),
+	      runqueue->tasks_stolen(),
+	      wall / 1000, (wall % 1000) * 1000);
+    }
+}
+
 } // End namespace gold.
@@ -191,9 +191,111 @@ class Task_function : public Task
   const char* name_;
 };
 
+// A set of independent work items which may be done by several
+// threads.  The caller of run does items itself, and queues helper
+// Tasks which do items on other threads.  When there are no items
+// left to start, the caller waits only for the items that helpers
+// have already started.  It never waits for a helper which has not
+// run, so run may be called from a running Task.  A helper may run
+// after all the items are done, so this is reference counted: create
+// it with new, call run, use the results, and then call release.
+
+class Parallel_work
+{
+ public:
+  Parallel_work(const std::string& name);
+
+  virtual
+  ~Parallel_work()
+  { }
+
+  // The name, for debugging.
+  const std::string&
+  name() const
+  { return this->name_; }
+
+  // Do items 0 through COUNT - 1, queueing up to HELPERS Tasks on
+  // WORKQUEUE to help.  WORKQUEUE may be NULL if HELPERS is zero.
+  // This returns when all the items are done.
+  void
+  run(Workqueue* workqueue, unsigned int count, unsigned int helpers);
+
+  // Add a reference.
+  void
+  add_ref();
+
+  // Drop a reference, deleting this if it was the last one.
+  void
+  release();
+
+  // Do items until there are none left to start.  This is called by
+  // run and by the helper Tasks.
+  void
+  do_items();
+
+ protected:
+  // Do item I.
+  virtual void
+  do_item(unsigned int i) = 0;
+
+ private:
+  Parallel_work(const Parallel_work&);
+  Parallel_work& operator=(const Parallel_work&);
+
+  // Lock controlling access to the counts.
+  Lock lock_;
+  // Signalled when the last started item is done.
+  Condvar condvar_;
+  // The name.
+  std::string name_;
+  // The number of items.
+  unsigned int count_;
+  // The next item to start.
+  unsigned int next_;
+  // The number of items being done.
+  unsigned int active_;
+  // The reference count.
+  int refs_;
+};
+
+// A Task which helps with a Parallel_work.
+
+class Parallel_work_task : public Task
+{
+ public:
+  Parallel_work_task(Parallel_work* work)
+    : work_(work)
+  { this->work_->add_ref(); }
+
+  ~Parallel_work_task()
+  { this->work_->release(); }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable()
+  { return NULL; }
+
+  void
+  locks(Task_locker*)
+  { }
+
+  void
+  run(Workqueue*)
+  { this->work_->do_items(); }
+
+  std::string
+  get_name() const
+  { return "Parallel_work_task " + this->work_->name(); }
+
+ private:
+  Parallel_work* work_;
+};
+
 // The workqueue itself.
 
 class Workqueue_threader;
+class Workqueue_runqueue;
 
 class Workqueue
 {
@@ -227,12 +329,21 @@ class Workqueue
   void
   set_thread_count(int);
 
+  // Return the desired thread count.  This is 1 when not using
+  // threads.
+  int
+  thread_count();
+
   // Add a new blocker to an existing Task_token. This must be done
   // with the workqueue lock held.  This should not be done routinely,
   // only in special circumstances.
   void
   add_blocker(Task_token*);
 
+  // Print statistics about the tasks run by each thread.
+  void
+  print_stats() const;
+
  private:
   // This class can not be copied.
   Workqueue(const Workqueue&);
@@ -240,19 +351,27 @@ class Workqueue
 
   // Add a task to a queue.
   void
-  add_to_queue(Task_list* queue, Task* t, bool front);
+  add_to_queue(Task* t, bool front);
 
-  // Find a runnable task, or wait for one.
+  // Add a runnable task to run queue RUNQUEUE.
+  void
+  push_runnable(Task* t, int runqueue, bool front);
+
+  // Remove a task from the run queues.
   Task*
-  find_runnable_or_wait(int thread_number);
+  pop_task(int thread_number, bool* stolen);
 
-  // Find a runnable task.
+  // Return T if it can run now, otherwise make it wait.
   Task*
-  find_runnable();
+  check_runnable(Task* t);
 
-  // Find a runnable task in a list.
+  // Find a runnable task, or wait for one.
   Task*
-  find_runnable_in_list(Task_list*);
+  find_runnable_or_wait(int thread_number, bool* stolen);
+
+  // Find a runnable task.
+  Task*
+  find_runnable(int thread_number, bool* stolen);
 
   // Find an run a task.
   bool
@@ -260,23 +379,40 @@ class Workqueue
 
   // Release the locks for a Task.  Return the next Task to run.
   Task*
-  release_locks(Task*, Task_locker*);
+  release_locks(Task*, Task_locker*, int thread_number);
 
   // Store T into *PRET, or queue it as appropriate.
   bool
-  return_or_queue(Task* t, bool is_blocker, Task** pret);
+  return_or_queue(Task* t, bool is_blocker, Task** pret, int thread_number);
 
   // Return whether to cancel this thread.
   bool
   should_cancel_thread(int thread_number);
 
-  // Master Workqueue lock.  This controls access to the following
-  // member variables.
+  // Return the run queue used by a thread.
+  int
+  runqueue_for_thread(int thread_number) const
+  { return thread_number % this->runqueue_count_; }
+
+  // The maximum number of run queues.
+  static const int max_runqueue_count = 64;
+  // The number of run queues to use when threads are enabled but no
+  // thread count was specified.
+  static const int default_runqueue_count = 16;
+
+  // Master Workqueue lock.  This controls access to the Task_tokens
+  // and to the following member variables.
   Lock lock_;
-  // List of tasks to execute soon.
-  Task_list first_tasks_;
-  // List of tasks to execute after the ones in first_tasks_.
-  Task_list tasks_;
+  // The run queues.  This is set at construction time and not changed
+  // thereafter.  Each queue has its own lock.
+  Workqueue_runqueue* runqueues_;
+  // The number of run queues.
+  int runqueue_count_;
+  // The run queue to use for the next task added by queue().
+  int next_runqueue_;
+  // Number of tasks added to the run queues which have not yet been
+  // started or put on the list for a Task_token.
+  int queued_;
   // Number of tasks currently running.
   int running_;
   // Number of tasks waiting for a lock to release.
@@ -737,6 +737,17 @@ class Target_x86_64 : public Sized_target<size, false>
   do_can_check_for_function_pointers() const
   { return true; }
 
+  // Applying relocations does not change any target state.
+  bool
+  do_can_relocate_sections_in_parallel() const
+  { return true; }
+
+  // Local symbols are only needed after relocation by GOT and PLT
+  // entries and dynamic relocations, which the object records.
+  bool
+  do_can_free_local_values() const
+  { return true; }
+
   // Return the base for a DW_EH_PE_datarel encoding.
   uint64_t
   do_ehframe_datarel_base() const;
@@ -828,6 +839,7 @@ class Target_x86_64 : public Sized_target<size, false>
   size_t
   add_tlsdesc_info(Sized_relobj_file<size, false>* object, unsigned int r_sym)
   {
+    object->set_local_values_used_late();
     this->tlsdesc_reloc_info_.push_back(Tlsdesc_info(object, r_sym));
     return this->tlsdesc_reloc_info_.size() - 1;
   }
@@ -110,6 +110,7 @@ static size_t cref_symcount;
 /* Used to take a snapshot of the cref hash table when starting to
    add syms from an as-needed library.  */
 static struct bfd_hash_entry **old_table;
+static struct bfd_hash_slot *old_slots;
 static unsigned int old_size;
 static unsigned int old_count;
 static void *old_tab;
@@ -200,78 +201,118 @@ add_cref (const char *name,
     r->def = TRUE;
 }
 
+/* Where the next entry and reference of the cref hash table snapshot
+   is saved to or restored from.  */
+
+struct cref_snapshot
+{
+  char *ent;
+  char *ref;
+};
+
+/* Add the space needed to save cref hash table entry P and its
+   references to the snapshot sizes.  */
+
+static bfd_boolean
+cref_snapshot_size (struct bfd_hash_entry *p, void *data ATTRIBUTE_UNUSED)
+{
+  struct cref_hash_entry *c = (struct cref_hash_entry *) p;
+  struct cref_ref *r;
+
+  entsize += cref_table.root.entsize;
+  for (r = c->refs; r != NULL; r = r->next)
+    refsize += sizeof (struct cref_ref);
+  return TRUE;
+}
+
+/* Save cref hash table entry P and its references.  */
+
+static bfd_boolean
+cref_snapshot_save (struct bfd_hash_entry *p, void *data)
+{
+  struct cref_snapshot *snap = (struct cref_snapshot *) data;
+  struct cref_hash_entry *c = (struct cref_hash_entry *) p;
+  struct cref_ref *r;
+
+  memcpy (snap->ent, p, cref_table.root.entsize);
+  snap->ent += cref_table.root.entsize;
+  for (r = c->refs; r != NULL; r = r->next)
+    {
+      memcpy (snap->ref, r, sizeof (struct cref_ref));
+      snap->ref += sizeof (struct cref_ref);
+    }
+  return TRUE;
+}
+
+/* Restore cref hash table entry P and its references as saved by
+   cref_snapshot_save.  */
+
+static bfd_boolean
+cref_snapshot_restore (struct bfd_hash_entry *p, void *data)
+{
+  struct cref_snapshot *snap = (struct cref_snapshot *) data;
+  struct cref_hash_entry *c = (struct cref_hash_entry *) p;
+  struct cref_ref *r;
+
+  memcpy (p, snap->ent, cref_table.root.entsize);
+  snap->ent += cref_table.root.entsize;
+  for (r = c->refs; r != NULL; r = r->next)
+    {
+      memcpy (r, snap->ref, sizeof (struct cref_ref));
+      snap->ref += sizeof (struct cref_ref);
+    }
+  return TRUE;
+}
+
 /* Called before loading an as-needed library to take a snapshot of
    the cref hash table, and after we have loaded or found that the
-   library was not needed.  */
+   library was not needed.  The table is only accessed through
+   bfd_hash_traverse, so that this works whatever kind of hash table
+   bfd_hash_table_init created.  */
 
 bfd_boolean
 handle_asneeded_cref (bfd *abfd ATTRIBUTE_UNUSED,
 		      enum notice_asneeded_action act)
 {
-  unsigned int i;
+  struct cref_snapshot snap;
 
   if (!cref_initialized)
     return TRUE;
 
   if (act == notice_as_needed)
     {
-      char *old_ent, *old_ref;
-
-      for (i = 0; i < cref_table.root.size; i++)
-	{
-	  struct bfd_hash_entry *p;
-	  struct cref_hash_entry *c;
-	  struct cref_ref *r;
-
-	  for (p = cref_table.root.table[i]; p != NULL; p = p->next)
-	    {
-	      entsize += cref_table.root.entsize;
-	      c = (struct cref_hash_entry *) p;
-	      for (r = c->refs; r != NULL; r = r->next)
-		refsize += sizeof (struct cref_ref);
-	    }
-	}
-
-      tabsize = cref_table.root.size * sizeof (struct bfd_hash_entry *);
+      entsize = 0;
+      refsize = 0;
+      bfd_hash_traverse (&cref_table.root, cref_snapshot_size, NULL);
+
+      if (cref_table.root.slots != NULL)
+	tabsize = cref_table.root.size * sizeof (struct bfd_hash_slot);
+      else
+	tabsize = cref_table.root.size * sizeof (struct bfd_hash_entry *);
       old_tab = xmalloc (tabsize + entsize + refsize);
 
       alloc_mark = bfd_hash_allocate (&cref_table.root, 1);
       if (alloc_mark == NULL)
 	return FALSE;
 
-      memcpy (old_tab, cref_table.root.table, tabsize);
-      old_ent = (char *) old_tab + tabsize;
-      old_ref = (char *) old_ent + entsize;
+      if (cref_table.root.slots != NULL)
+	memcpy (old_tab, cref_table.root.slots, tabsize);
+      else
+	memcpy (old_tab, cref_table.root.table, tabsize);
       old_table = cref_table.root.table;
+      old_slots = cref_table.root.slots;
       old_size = cref_table.root.size;
       old_count = cref_table.root.count;
       old_symcount = cref_symcount;
 
-      for (i = 0; i < cref_table.root.size; i++)
-	{
-	  struct bfd_hash_entry *p;
-	  struct cref_hash_entry *c;
-	  struct cref_ref *r;
-
-	  for (p = cref_table.root.table[i]; p != NULL; p = p->next)
-	    {
-	      memcpy (old_ent, p, cref_table.root.entsize);
-	      old_ent = (char *) old_ent + cref_table.root.entsize;
-	      c = (struct cref_hash_entry *) p;
-	      for (r = c->refs; r != NULL; r = r->next)
-		{
-		  memcpy (old_ref, r, sizeof (struct cref_ref));
-		  old_ref = (char *) old_ref + sizeof (struct cref_ref);
-		}
-	    }
-	}
+      snap.ent = (char *) old_tab + tabsize;
+      snap.ref = snap.ent + entsize;
+      bfd_hash_traverse (&cref_table.root, cref_snapshot_save, &snap);
       return TRUE;
     }
 
   if (act == notice_not_needed)
     {
-      char *old_ent, *old_ref;
-
       if (old_tab == NULL)
 	{
 	  /* The only way old_tab can be NULL is if the cref hash table
@@ -281,32 +322,19 @@ handle_asneeded_cref (bfd *abfd ATTRIBUTE_UNUSED,
 	  return TRUE;
 	}
 
-      old_ent = (char *) old_tab + tabsize;
-      old_ref = (char *) old_ent + entsize;
       cref_table.root.table = old_table;
+      cref_table.root.slots = old_slots;
       cref_table.root.size = old_size;
       cref_table.root.count = old_count;
-      memcpy (cref_table.root.table, old_tab, tabsize);
+      if (old_slots != NULL)
+	memcpy (old_slots, old_tab, tabsize);
+      else
+	memcpy (old_table, old_tab, tabsize);
       cref_symcount = old_symcount;
 
-      for (i = 0; i < cref_table.root.size; i++)
-	{
-	  struct bfd_hash_entry *p;
-	  struct cref_hash_entry *c;
-	  struct cref_ref *r;
-
-	  for (p = cref_table.root.table[i]; p != NULL; p = p->next)
-	    {
-	      memcpy (p, old_ent, cref_table.root.entsize);
-	      old_ent = (char *) old_ent + cref_table.root.entsize;
-	      c = (struct cref_hash_entry *) p;
-	      for (r = c->refs; r != NULL; r = r->next)
-		{
-		  memcpy (r, old_ref, sizeof (struct cref_ref));
-		  old_ref = (char *) old_ref + sizeof (struct cref_ref);
-		}
-	    }
-	}
+      snap.ent = (char *) old_tab + tabsize;
+      snap.ref = snap.ent + entsize;
+      bfd_hash_traverse (&cref_table.root, cref_snapshot_restore, &snap);
 
       objalloc_free_block ((struct objalloc *) cref_table.root.memory,
 			   alloc_mark);
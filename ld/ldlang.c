@@ -736,6 +736,251 @@ walk_wild_section_specs4_wild2 (lang_wild_statement_type *ptr,
     }
 }
 
+/* A wild statement's section name patterns, compiled so that each
+   input section can be matched against all of them at once.  Names
+   without wildcards are looked up in a hash table, and names that are
+   a literal prefix followed by a single '*' (or are NULL, which
+   matches anything) are found by walking the section name down a trie
+   of those prefixes.  Anything else is matched with fnmatch as
+   walk_wild_section_general does.  Patterns are numbered in statement
+   order, and each list of pattern numbers below is in that order.  */
+
+struct wild_match_ref
+{
+  struct wild_match_ref *next;
+  unsigned int index;
+};
+
+struct wild_exact_name
+{
+  const char *name;
+  struct wild_match_ref *refs;
+};
+
+struct wild_prefix_node
+{
+  struct wild_prefix_node *child;
+  struct wild_prefix_node *sibling;
+  struct wild_match_ref *refs;
+  char c;
+};
+
+struct wild_matcher
+{
+  /* The patterns, indexed by number.  */
+  struct wildcard_list **specs;
+  unsigned int count;
+  /* Exact names, or NULL if there are none.  */
+  htab_t exact;
+  /* The root of the prefix trie.  */
+  struct wild_prefix_node root;
+  /* Patterns that must be matched with fnmatch.  */
+  struct wild_match_ref *others;
+  /* Scratch space for the numbers of the patterns that match one
+     section.  */
+  unsigned int *hits;
+  /* The next matcher built, on wild_matchers.  */
+  struct wild_matcher *next;
+};
+
+/* All the matchers built, so that lang_finish can free their hash
+   tables.  Everything else is on the stat obstack.  */
+static struct wild_matcher *wild_matchers;
+
+static hashval_t
+wild_exact_name_hash (const void *p)
+{
+  const struct wild_exact_name *e = (const struct wild_exact_name *) p;
+
+  return htab_hash_string (e->name);
+}
+
+/* Compare an entry with a section name, the key of all lookups.  */
+
+static int
+wild_exact_name_eq (const void *p1, const void *p2)
+{
+  const struct wild_exact_name *e = (const struct wild_exact_name *) p1;
+
+  return strcmp (e->name, (const char *) p2) == 0;
+}
+
+static struct wild_match_ref *
+wild_match_ref_new (unsigned int index, struct wild_match_ref *next)
+{
+  struct wild_match_ref *ref;
+
+  ref = (struct wild_match_ref *) stat_alloc (sizeof (*ref));
+  ref->next = next;
+  ref->index = index;
+  return ref;
+}
+
+/* Compile the patterns of wild statement PTR.  */
+
+static struct wild_matcher *
+wild_matcher_build (lang_wild_statement_type *ptr)
+{
+  struct wild_matcher *m;
+  struct wildcard_list *sec;
+  unsigned int i;
+
+  m = (struct wild_matcher *) stat_alloc (sizeof (*m));
+  memset (m, 0, sizeof (*m));
+  for (sec = ptr->section_list; sec != NULL; sec = sec->next)
+    m->count++;
+  m->specs = ((struct wildcard_list **)
+	      stat_alloc (m->count * sizeof (*m->specs)));
+  m->hits = (unsigned int *) stat_alloc (m->count * sizeof (*m->hits));
+  for (i = 0, sec = ptr->section_list; sec != NULL; sec = sec->next)
+    m->specs[i++] = sec;
+  m->next = wild_matchers;
+  wild_matchers = m;
+
+  /* Go backwards, so that pushing each pattern number onto the front
+     of a list leaves the list in order.  */
+  for (i = m->count; i-- != 0; )
+    {
+      const char *name = m->specs[i]->spec.name;
+      size_t len;
+
+      if (name != NULL && !wildcardp (name))
+	{
+	  struct wild_exact_name *e;
+	  hashval_t hash = htab_hash_string (name);
+	  void **slot;
+
+	  if (m->exact == NULL)
+	    m->exact = htab_create (m->count, wild_exact_name_hash,
+				    wild_exact_name_eq, NULL);
+	  slot = htab_find_slot_with_hash (m->exact, name, hash, INSERT);
+	  e = (struct wild_exact_name *) *slot;
+	  if (e == NULL)
+	    {
+	      e = (struct wild_exact_name *) stat_alloc (sizeof (*e));
+	      e->name = name;
+	      e->refs = NULL;
+	      *slot = e;
+	    }
+	  e->refs = wild_match_ref_new (i, e->refs);
+	  continue;
+	}
+
+      /* fnmatch treats a backslash as an escape, so a prefix holding
+	 one is not literal.  */
+      len = name != NULL ? strcspn (name, "?*[\\") : 0;
+      if (name == NULL || (name[len] == '*' && name[len + 1] == '\0'))
+	{
+	  struct wild_prefix_node *node = &m->root;
+	  size_t j;
+
+	  for (j = 0; j < len; j++)
+	    {
+	      struct wild_prefix_node *child;
+
+	      for (child = node->child; child != NULL; child = child->sibling)
+		if (child->c == name[j])
+		  break;
+	      if (child == NULL)
+		{
+		  child = ((struct wild_prefix_node *)
+			   stat_alloc (sizeof (*child)));
+		  child->child = NULL;
+		  child->sibling = node->child;
+		  child->refs = NULL;
+		  child->c = name[j];
+		  node->child = child;
+		}
+	      node = child;
+	    }
+	  node->refs = wild_match_ref_new (i, node->refs);
+	  continue;
+	}
+
+      m->others = wild_match_ref_new (i, m->others);
+    }
+
+  return m;
+}
+
+/* The handler for wild statements that the specialized handlers above
+   do not cover.  It makes the same calls in the same order as
+   walk_wild_section_general, but finds the patterns matching each
+   section without trying every pattern in turn.  */
+
+static void
+walk_wild_section_matcher (lang_wild_statement_type *ptr,
+			   lang_input_statement_type *file,
+			   callback_t callback,
+			   void *data)
+{
+  struct wild_matcher *m;
+  asection *s;
+
+  /* Emulations may edit the statement's section list after it has
+     been analyzed, but do so before the first walk.  */
+  if (ptr->section_list == NULL)
+    {
+      walk_wild_section_general (ptr, file, callback, data);
+      return;
+    }
+  m = ptr->matcher;
+  if (m == NULL)
+    m = ptr->matcher = wild_matcher_build (ptr);
+
+  for (s = file->the_bfd->sections; s != NULL; s = s->next)
+    {
+      const char *sname = bfd_get_section_name (file->the_bfd, s);
+      struct wild_prefix_node *node;
+      struct wild_match_ref *ref;
+      const char *p;
+      unsigned int n = 0;
+      unsigned int i, j;
+
+      if (m->exact != NULL)
+	{
+	  struct wild_exact_name *e;
+
+	  e = ((struct wild_exact_name *)
+	       htab_find_with_hash (m->exact, sname, htab_hash_string (sname)));
+	  if (e != NULL)
+	    for (ref = e->refs; ref != NULL; ref = ref->next)
+	      m->hits[n++] = ref->index;
+	}
+
+      for (node = &m->root, p = sname; ; p++)
+	{
+	  for (ref = node->refs; ref != NULL; ref = ref->next)
+	    m->hits[n++] = ref->index;
+	  if (*p == '\0')
+	    break;
+	  for (node = node->child; node != NULL; node = node->sibling)
+	    if (node->c == *p)
+	      break;
+	  if (node == NULL)
+	    break;
+	}
+
+      for (ref = m->others; ref != NULL; ref = ref->next)
+	if (name_match (m->specs[ref->index]->spec.name, sname) == 0)
+	  m->hits[n++] = ref->index;
+
+      /* Each source gives its matches in order, but they may
+	 interleave.  There are rarely more than one or two.  */
+      for (i = 1; i < n; i++)
+	for (j = i; j > 0 && m->hits[j - 1] > m->hits[j]; j--)
+	  {
+	    unsigned int t = m->hits[j - 1];
+	    m->hits[j - 1] = m->hits[j];
+	    m->hits[j] = t;
+	  }
+
+      for (i = 0; i < n; i++)
+	walk_wild_consider_section (ptr, file, s, m->specs[m->hits[i]],
+				    callback, data);
+    }
+}
+
 static void
 walk_wild_section (lang_wild_statement_type *ptr,
 		   lang_input_statement_type *file,
@@ -785,11 +1030,14 @@ analyze_walk_wild_section_handler (lang_wild_statement_type *ptr)
   int signature;
   int data_counter;
 
-  ptr->walk_wild_section_handler = walk_wild_section_general;
+  ptr->walk_wild_section_handler = (ptr->section_list != NULL
+				    ? walk_wild_section_matcher
+				    : walk_wild_section_general);
   ptr->handler_data[0] = NULL;
   ptr->handler_data[1] = NULL;
   ptr->handler_data[2] = NULL;
   ptr->handler_data[3] = NULL;
+  ptr->matcher = NULL;
   ptr->tree = NULL;
 
   /* Count how many wildcard_specs there are, and how many of those
@@ -1270,6 +1518,13 @@ lang_init (void)
 void
 lang_finish (void)
 {
+  struct wild_matcher *m;
+
+  for (m = wild_matchers; m != NULL; m = m->next)
+    if (m->exact != NULL)
+      htab_delete (m->exact);
+  wild_matchers = NULL;
+
   output_section_statement_table_free ();
 }
 
@@ -2884,6 +3139,34 @@ load_symbols (lang_input_statement_type *entry,
   return entry->flags.loaded;
 }
 
+/* For --stats, report that wild statement W took RUN_TIME
+   microseconds to map the input sections from *FIRST on of its
+   children to output section OS.  */
+
+static void
+print_wild_statement_stats (lang_wild_statement_type *w,
+			    lang_output_section_statement_type *os,
+			    long run_time,
+			    lang_statement_union_type *first)
+{
+  struct wildcard_list *sec;
+  unsigned long count = 0;
+
+  for (; first != NULL; first = first->header.next)
+    if (first->header.type == lang_input_section_enum)
+      count++;
+
+  fprintf (stderr, _("%s: %ld.%06ld in section matching, %lu input sections:"
+		     " %s: %s("),
+	   program_name, run_time / 1000000, run_time % 1000000, count,
+	   os != NULL ? os->name : "*",
+	   w->filename != NULL ? w->filename : "*");
+  for (sec = w->section_list; sec != NULL; sec = sec->next)
+    fprintf (stderr, "%s%s", sec != w->section_list ? " " : "",
+	     sec->spec.name != NULL ? sec->spec.name : "*");
+  fprintf (stderr, ")\n");
+}
+
 /* Handle a wild statement.  S->FILENAME or S->SECTION_LIST or both
    may be NULL, indicating that it is a wildcard.  Separate
    lang_input_section statements are created for each part of the
@@ -2896,6 +3179,8 @@ wild (lang_wild_statement_type *s,
       lang_output_section_statement_type *output)
 {
   struct wildcard_list *sec;
+  lang_statement_union_type **tail = s->children.tail;
+  long start_time = config.stats ? get_run_time () : 0;
 
   if (s->handler_data[0]
       && s->handler_data[0]->spec.sorted == by_name
@@ -2915,6 +3200,10 @@ wild (lang_wild_statement_type *s,
   else
     walk_wild (s, output_section_callback, output);
 
+  if (config.stats)
+    print_wild_statement_stats (s, output, get_run_time () - start_time,
+				*tail);
+
   if (default_common_section == NULL)
     for (sec = s->section_list; sec != NULL; sec = sec->next)
       if (sec->spec.name != NULL && strcmp (sec->spec.name, "COMMON") == 0)
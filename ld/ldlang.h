@@ -380,6 +380,7 @@ struct lang_wild_statement_struct
 
   walk_wild_section_handler_t walk_wild_section_handler;
   struct wildcard_list *handler_data[4];
+  struct wild_matcher *matcher;
   lang_section_bst_type *tree;
   struct flag_info *section_flag_list;
 };
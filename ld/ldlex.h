@@ -103,6 +103,7 @@ enum option_values
   OPTION_NO_PRINT_GC_SECTIONS,
   OPTION_GC_KEEP_EXPORTED,
   OPTION_HASH_SIZE,
+  OPTION_HASH_TABLES,
   OPTION_CHECK_SECTIONS,
   OPTION_NO_CHECK_SECTIONS,
   OPTION_NO_UNDEFINED,
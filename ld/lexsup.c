@@ -344,6 +344,10 @@ static const struct ld_option ld_options[] =
   { {"hash-size=<NUMBER>", required_argument, NULL, OPTION_HASH_SIZE},
     '\0', NULL, N_("Set default hash table size close to <NUMBER>"),
     TWO_DASHES },
+  { {"hash-tables=[chained|open-addressing]", required_argument, NULL,
+     OPTION_HASH_TABLES},
+    '\0', NULL, N_("Set the kind of the linker's internal hash tables"),
+    TWO_DASHES },
   { {"help", no_argument, NULL, OPTION_HELP},
     '\0', NULL, N_("Print option help"), TWO_DASHES },
   { {"init", required_argument, NULL, OPTION_INIT},
@@ -1534,6 +1538,15 @@ parse_args (unsigned argc, char **argv)
           }
           break;
 
+	case OPTION_HASH_TABLES:
+	  if (strcmp (optarg, "chained") == 0)
+	    bfd_hash_set_default_open_addressing (FALSE);
+	  else if (strcmp (optarg, "open-addressing") == 0)
+	    bfd_hash_set_default_open_addressing (TRUE);
+	  else
+	    einfo (_("%P%F: invalid --hash-tables type `%s'\n"), optarg);
+	  break;
+
 	case OPTION_PUSH_STATE:
 	  input_flags.pushed = xmemdup (&input_flags,
 					sizeof (input_flags),
@@ -0,0 +1,6 @@
+	.data
+	.globl	unneeded_a
+	.type	unneeded_a, %object
+unneeded_a:
+	.dc.a	used_b
+	.size	unneeded_a, . - unneeded_a
@@ -0,0 +1,6 @@
+	.data
+	.globl	used_b
+	.type	used_b, %object
+used_b:
+	.dc.a	0
+	.size	used_b, . - used_b
@@ -0,0 +1,6 @@
+	.data
+	.globl	ptr_b
+	.type	ptr_b, %object
+ptr_b:
+	.dc.a	used_b
+	.size	ptr_b, . - ptr_b
@@ -0,0 +1,73 @@
+	.section .rodata.str1.1,"aMS","progbits",1
+.LC0:
+	.asciz	"xyzabcdef"
+.LC1:
+	.asciz	"abcdef"
+.LC2:
+	.asciz	"abcdeg"
+.LC3:
+	.asciz	"zabcdef"
+.LC4:
+	.asciz	"def"
+.LC5:
+	.asciz	"qdef"
+.LC6:
+	.asciz	"g"
+
+
+	.section .rodata.str2.2,"aMS","progbits",2
+	.p2align 1
+.LC7:
+	.byte	0x61, 0x62, 0x63, 0, 0, 0
+.LC8:
+	.byte	0x63, 0, 0, 0
+.LC9:
+	.byte	0x61, 0x62, 0x64, 0, 0, 0
+.LC10:
+	.byte	0, 0x63, 0, 0
+.LC11:
+	.byte	0x11, 0x11, 0x61, 0x62, 0x63, 0, 0, 0
+
+
+	.section .rodata.str1.4,"aMS","progbits",1
+	.p2align 2
+.LC12:
+	.asciz	"abcdefg"
+	.p2align 2
+.LC13:
+	.asciz	"defg"
+	.p2align 2
+.LC14:
+	.asciz	"0123defg"
+	.p2align 2
+.LC15:
+	.asciz	"xyz"
+	.p2align 2
+.LC16:
+	.asciz	"wxyz"
+	.p2align 2
+.LC17:
+	.asciz	"0123wxyz"
+
+
+	.text
+	.global _start
+_start:
+	.long	.LC0
+	.long	.LC1
+	.long	.LC2
+	.long	.LC3
+	.long	.LC4
+	.long	.LC5
+	.long	.LC6
+	.long	.LC7
+	.long	.LC8
+	.long	.LC9
+	.long	.LC10
+	.long	.LC11
+	.long	.LC12
+	.long	.LC13
+	.long	.LC14
+	.long	.LC15
+	.long	.LC16
+	.long	.LC17
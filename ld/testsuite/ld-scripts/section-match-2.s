@@ -0,0 +1,27 @@
+	.section .sec.exact
+exact:
+	.byte 1
+
+	.section .sec.prefix
+prefix:
+	.byte 2
+
+	.section .sec.yz
+yz:
+	.byte 3
+
+	.section .sec.a.suf
+suf:
+	.byte 4
+
+	.section .sec.other
+other:
+	.byte 5
+
+	.section .sec.exactly
+exactly:
+	.byte 6
+
+	.section .sec.xz
+xz:
+	.byte 7
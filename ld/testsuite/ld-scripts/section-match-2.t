@@ -0,0 +1,11 @@
+SECTIONS
+{
+	/* One statement mixing an exact name, a prefix and patterns
+	   that need fnmatch.  .sec.exactly and .sec.other match none of
+	   them.  */
+	.secA : { *(.sec.exact .sec.pre* .sec.[xy]z *.suf) }
+
+	.secB : { *(.sec.*) }
+
+	/DISCARD/ : { *(*) }
+}